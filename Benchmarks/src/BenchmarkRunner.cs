@@ -0,0 +1,93 @@
+using Microsoft.Extensions.CommandLineUtils;
+using Newtonsoft.Json;
+using System;
+using System.Collections.Generic;
+using System.Globalization;
+using System.IO;
+using System.Linq;
+
+/**
+ * Runs the CPU benchmarks headlessly and reports per-operation timing statistics, optionally as JSON so that runs can
+ * be compared. Nothing here needs a GPU or VR runtime; benchmarks that need imported figure data are skipped if it's
+ * missing.
+ */
+class BenchmarkRunner {
+	private static IBenchmark[] MakeAllBenchmarks() {
+		return new IBenchmark[] {
+			new ChannelEvaluationBenchmark(),
+			new BoneTransformsBenchmark(false),
+			new BoneTransformsBenchmark(true),
+			new BoneSystemTransformsBenchmark("lHand", false),
+			new BoneSystemTransformsBenchmark("lHand", true),
+			new BoneSystemTransformsBenchmark("head", true),
+			new BoneSystemTransformsBenchmark("hip", true),
+			new InverseKinematicsBenchmark(false),
+			new InverseKinematicsBenchmark(true),
+			new StencilRefinementBenchmark(),
+			new ArchiveReadBenchmark(),
+			new PoseBlendingBenchmark()
+		};
+	}
+
+	private class Report {
+		[JsonProperty("machine")]
+		public string MachineName = Environment.MachineName;
+
+		[JsonProperty("os")]
+		public string OSVersion = Environment.OSVersion.ToString();
+
+		[JsonProperty("processor-count")]
+		public int ProcessorCount = Environment.ProcessorCount;
+
+		[JsonProperty("timestamp")]
+		public string Timestamp = DateTime.UtcNow.ToString("o", CultureInfo.InvariantCulture);
+
+		[JsonProperty("benchmarks")]
+		public List<BenchmarkResult> Results = new List<BenchmarkResult>();
+	}
+
+	public static int Main(string[] args) {
+		var commandLineParser = new CommandLineApplication(false);
+		var filterOption = commandLineParser.Option("--filter", "only run benchmarks whose name contains this", CommandOptionType.SingleValue);
+		var warmupOption = commandLineParser.Option("--warmup", "number of warmup iterations (default 5)", CommandOptionType.SingleValue);
+		var iterationsOption = commandLineParser.Option("--iterations", "number of measured iterations (default 30)", CommandOptionType.SingleValue);
+		var minIterationTimeOption = commandLineParser.Option("--min-iteration-ms", "minimum time per iteration (default 10)", CommandOptionType.SingleValue);
+		var outputOption = commandLineParser.Option("--output", "write results as JSON to this file", CommandOptionType.SingleValue);
+		var listOption = commandLineParser.Option("--list", "list benchmarks without running them", CommandOptionType.NoValue);
+
+		commandLineParser.OnExecute(() => {
+			var benchmarks = MakeAllBenchmarks()
+				.Where(benchmark => !filterOption.HasValue() || benchmark.Name.Contains(filterOption.Value()))
+				.ToList();
+
+			if (listOption.HasValue()) {
+				benchmarks.ForEach(benchmark => Console.WriteLine(benchmark.Name));
+				return 0;
+			}
+
+			int ParseOption(CommandOption option, int defaultValue) {
+				return option.HasValue() ? int.Parse(option.Value(), CultureInfo.InvariantCulture) : defaultValue;
+			}
+			var harness = new BenchmarkHarness(
+				ParseOption(warmupOption, 5),
+				ParseOption(iterationsOption, 30),
+				TimeSpan.FromMilliseconds(ParseOption(minIterationTimeOption, 10)));
+
+			var report = new Report();
+			foreach (var benchmark in benchmarks) {
+				var result = harness.Run(benchmark);
+				Console.WriteLine(result);
+				report.Results.Add(result);
+			}
+
+			if (outputOption.HasValue()) {
+				File.WriteAllText(outputOption.Value(), JsonConvert.SerializeObject(report, Formatting.Indented));
+			}
+
+			//skipped benchmarks don't fail the run, so that it can run on machines without imported content
+			return report.Results.Any(result => result.Status == BenchmarkResult.Failed) ? 1 : 0;
+		});
+
+		return commandLineParser.Execute(args);
+	}
+}
@@ -0,0 +1,45 @@
+using System;
+using System.IO;
+
+/**
+ * Reads every file of a synthetic packed archive, which needs no imported content.
+ */
+public class ArchiveReadBenchmark : IBenchmark {
+	private const int FileCount = 64;
+	private const int FileSize = 256 * 1024;
+
+	private DirectoryInfo tempDirectory;
+	private PackedArchive archive;
+
+	public string Name => "archive-read";
+
+	public void Setup() {
+		tempDirectory = new DirectoryInfo(Path.Combine(Path.GetTempPath(), "archive-read-benchmark-" + Guid.NewGuid()));
+		var contentDirectory = tempDirectory.Subdirectory("content");
+		contentDirectory.CreateWithParents();
+
+		var random = new Random(0);
+		var bytes = new byte[FileSize];
+		for (int i = 0; i < FileCount; ++i) {
+			random.NextBytes(bytes);
+			File.WriteAllBytes(contentDirectory.File($"file-{i}.dat").FullName, bytes);
+		}
+
+		var archiveFile = tempDirectory.File("content.archive");
+		new ArchivePacker().Pack(archiveFile, contentDirectory);
+		archive = new PackedArchive(archiveFile);
+	}
+
+	public void RunOperation() {
+		foreach (var file in archive.Root.GetFiles()) {
+			file.ReadAllBytes();
+		}
+	}
+
+	public void Dispose() {
+		archive?.Dispose();
+		if (tempDirectory != null && tempDirectory.Exists) {
+			tempDirectory.Delete(true);
+		}
+	}
+}
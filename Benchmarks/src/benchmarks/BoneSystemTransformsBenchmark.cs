@@ -0,0 +1,58 @@
+using SharpDX;
+using System;
+using System.Globalization;
+
+/**
+ * Times BoneSystem transforms for a pose edit that rotates one bone back and forth each frame, either recomputed in
+ * full or through a BoneTransformCache that only recomputes the edited bone's subtree. The channel outputs for both
+ * poses are evaluated up front so only the transforms are timed.
+ */
+public class BoneSystemTransformsBenchmark : IBenchmark, IBenchmarkDetails {
+	private readonly string editedBoneName;
+	private readonly bool incremental;
+
+	private BoneSystem boneSystem;
+	private BoneTransformCache cache;
+	private ChannelOutputs[] outputs;
+	private StagedSkinningTransform[] boneTransforms;
+	private int frameIdx;
+
+	public BoneSystemTransformsBenchmark(string editedBoneName, bool incremental) {
+		this.editedBoneName = editedBoneName;
+		this.incremental = incremental;
+	}
+
+	public string Name => "bone-system-transforms-" + (incremental ? "incremental" : "full") + "-" + editedBoneName;
+
+	public void Setup() {
+		var figure = FigureBenchmarkData.Load();
+		boneSystem = figure.BoneSystem;
+		cache = new BoneTransformCache(boneSystem);
+		boneTransforms = new StagedSkinningTransform[boneSystem.Bones.Count];
+
+		var editedInputs = new ChannelInputs(figure.PosedInputs);
+		boneSystem.BonesByName[editedBoneName].Rotation.AddValue(editedInputs, new Vector3(5, 5, 5));
+
+		outputs = new [] {
+			figure.ChannelSystem.Evaluate(null, figure.PosedInputs),
+			figure.ChannelSystem.Evaluate(null, editedInputs)
+		};
+	}
+
+	public void RunOperation() {
+		var frameOutputs = outputs[frameIdx % outputs.Length];
+		frameIdx += 1;
+
+		if (incremental) {
+			cache.GetBoneTransforms(frameOutputs, boneTransforms);
+		} else {
+			boneSystem.GetBoneTransforms(frameOutputs);
+		}
+	}
+
+	public string Details => incremental ? String.Format(CultureInfo.InvariantCulture,
+		"{0} of {1} bones recomputed per frame", cache.RecomputedBoneCount, boneSystem.Bones.Count) : null;
+
+	public void Dispose() {
+	}
+}
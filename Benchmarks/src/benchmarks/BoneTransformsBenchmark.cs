@@ -0,0 +1,67 @@
+using SharpDX;
+using System;
+
+/**
+ * Times RigidBoneSystem.GetBoneTransforms, after checking that its transforms agree with the non-rigid BoneSystem's.
+ * The allocating variant returns a new array each time, as callers did before the overload taking an array existed.
+ */
+public class BoneTransformsBenchmark : IBenchmark {
+	private readonly bool allocating;
+
+	private RigidBoneSystem rigidBoneSystem;
+	private RigidBoneSystemInputs inputs;
+	private RigidTransform[] boneTransforms;
+
+	public BoneTransformsBenchmark(bool allocating) {
+		this.allocating = allocating;
+	}
+
+	public string Name => allocating ? "bone-transforms-allocating" : "bone-transforms";
+
+	public void Setup() {
+		var figure = FigureBenchmarkData.Load();
+		var channelOutputs = figure.ChannelSystem.Evaluate(null, figure.PosedInputs);
+
+		rigidBoneSystem = new RigidBoneSystem(figure.BoneSystem);
+		rigidBoneSystem.Synchronize(channelOutputs);
+		inputs = rigidBoneSystem.ReadInputs(channelOutputs);
+		boneTransforms = new RigidTransform[rigidBoneSystem.Bones.Length];
+
+		CheckConsistency(figure.BoneSystem, channelOutputs);
+	}
+
+	private void CheckConsistency(BoneSystem boneSystem, ChannelOutputs channelOutputs) {
+		var boneTransformsA = boneSystem.GetBoneTransforms(channelOutputs);
+		var boneTransformsB = rigidBoneSystem.GetBoneTransforms(inputs);
+
+		for (int i = 0; i < boneSystem.Bones.Count; ++i) {
+			var boneTransformA = boneTransformsA[i];
+			var boneTransformB = boneTransformsB[i];
+
+			var unposedCenterA = boneSystem.Bones[i].CenterPoint.GetValue(channelOutputs);
+			var unposedCenterB = rigidBoneSystem.Bones[i].CenterPoint;
+			
+			foreach (var testVector in new Vector3[] { Vector3.Zero, Vector3.Right, Vector3.Up, Vector3.BackwardRH }) {
+				var transformedVectorA = boneTransformA.Transform(unposedCenterA + testVector);
+				var transformedVectorB = boneTransformB.Transform(
+					unposedCenterB + boneTransformA.ScalingStage.Transform(testVector));
+				float distance = Vector3.Distance(transformedVectorA, transformedVectorB);
+
+				if (distance > 1e-3) {
+					throw new InvalidOperationException("rigid and non-rigid bone transforms are inconsistent");
+				}
+			}
+		}
+	}
+
+	public void RunOperation() {
+		if (allocating) {
+			rigidBoneSystem.GetBoneTransforms(inputs);
+		} else {
+			rigidBoneSystem.GetBoneTransforms(inputs, boneTransforms);
+		}
+	}
+
+	public void Dispose() {
+	}
+}
@@ -0,0 +1,16 @@
+public class ChannelEvaluationBenchmark : IBenchmark {
+	private FigureBenchmarkData figure;
+
+	public string Name => "channel-evaluation";
+
+	public void Setup() {
+		figure = FigureBenchmarkData.Load();
+	}
+
+	public void RunOperation() {
+		figure.ChannelSystem.Evaluate(null, figure.PosedInputs);
+	}
+
+	public void Dispose() {
+	}
+}
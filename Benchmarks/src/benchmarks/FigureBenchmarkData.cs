@@ -0,0 +1,40 @@
+using System.IO;
+
+/**
+ * The imported figure that the figure benchmarks run against, posed in the first frame of its idle animation.
+ */
+public class FigureBenchmarkData {
+	public static readonly DirectoryInfo FigureDirectory = CommonPaths.WorkDir.Subdirectory("figures").Subdirectory("genesis-3-female");
+
+	public IArchiveDirectory Directory { get; }
+	public ChannelSystem ChannelSystem { get; }
+	public BoneSystem BoneSystem { get; }
+	public ChannelInputs PosedInputs { get; }
+
+	private FigureBenchmarkData(IArchiveDirectory directory, ChannelSystem channelSystem, BoneSystem boneSystem, ChannelInputs posedInputs) {
+		Directory = directory;
+		ChannelSystem = channelSystem;
+		BoneSystem = boneSystem;
+		PosedInputs = posedInputs;
+	}
+
+	public static FigureBenchmarkData Load() {
+		if (!FigureDirectory.Exists) {
+			throw new BenchmarkSkippedException("missing imported figure: " + FigureDirectory.FullName);
+		}
+
+		var figureDir = UnpackedArchiveDirectory.Make(FigureDirectory);
+
+		var channelSystemRecipe = Persistance.Load<ChannelSystemRecipe>(figureDir.File("channel-system-recipe.dat"));
+		var channelSystem = channelSystemRecipe.Bake(null);
+
+		var boneSystemRecipe = Persistance.Load<BoneSystemRecipe>(figureDir.File("bone-system-recipe.dat"));
+		var boneSystem = boneSystemRecipe.Bake(channelSystem.ChannelsByName);
+
+		var pose = AnimationClip.LoadPose(figureDir.File("animations/idle.clip"), 0);
+		var posedInputs = channelSystem.MakeDefaultChannelInputs();
+		new Poser(channelSystem, boneSystem).Apply(posedInputs, pose, DualQuaternion.Identity);
+
+		return new FigureBenchmarkData(figureDir, channelSystem, boneSystem, posedInputs);
+	}
+}
@@ -0,0 +1,87 @@
+using SharpDX;
+using System;
+using System.Collections.Generic;
+using System.Globalization;
+using System.Linq;
+
+/**
+ * Solves one frame of the demo goals with the hand target circling its rest position, as if held by a moving
+ * controller. With warm start, each frame starts from the previous frame's solution the way InverseKinematicsAnimator
+ * reapplies its pose deltas; without, every frame starts from the same pose.
+ */
+public class InverseKinematicsBenchmark : IBenchmark, IBenchmarkDetails {
+	private const float TargetRadius = 5; //cm
+	private const float TargetRevolutionsPerSecond = 0.5f;
+	private const float FrameTime = 1 / 90f;
+
+	private readonly bool warmStart;
+
+	private RigidBoneSystem rigidBoneSystem;
+	private IInverseKinematicsGoalProvider goalProvider;
+	private HarmonicInverseKinematicsSolver solver;
+	private RigidBoneSystemInputs initialInputs;
+	private RigidBoneSystemInputs poseDeltas;
+	private FrameUpdateParameters frameUpdateParameters;
+	private int frameIdx;
+
+	private int solveCount;
+	private long totalIterations;
+	private int maxIterations;
+	private int convergedCount;
+
+	public InverseKinematicsBenchmark(bool warmStart) {
+		this.warmStart = warmStart;
+	}
+
+	public string Name => warmStart ? "inverse-kinematics-warm" : "inverse-kinematics-cold";
+
+	public void Setup() {
+		var figure = FigureBenchmarkData.Load();
+		var inverterParameters = Persistance.Load<InverterParameters>(figure.Directory.File("inverter-parameters.dat"));
+
+		rigidBoneSystem = new RigidBoneSystem(figure.BoneSystem);
+		goalProvider = new DemoInverseKinematicsGoalProvider(rigidBoneSystem);
+		solver = new HarmonicInverseKinematicsSolver(rigidBoneSystem, inverterParameters.BoneAttributes);
+
+		var channelOutputs = figure.ChannelSystem.Evaluate(null, figure.PosedInputs);
+		rigidBoneSystem.Synchronize(channelOutputs);
+		initialInputs = rigidBoneSystem.ReadInputs(channelOutputs);
+		poseDeltas = rigidBoneSystem.MakeZeroInputs();
+
+		frameUpdateParameters = new FrameUpdateParameters(0, FrameTime, null, Vector3.Zero);
+	}
+
+	private List<InverseKinematicsGoal> MakeGoals() {
+		float angle = MathUtil.TwoPi * TargetRevolutionsPerSecond * frameIdx * FrameTime;
+		var offset = TargetRadius * new Vector3((float) Math.Cos(angle), (float) Math.Sin(angle), 0);
+
+		return goalProvider.GetGoals(frameUpdateParameters, initialInputs, null)
+			.Select(goal => new InverseKinematicsGoal(
+				goal.SourceBone,
+				goal.UnposedSourcePosition, goal.UnposedSourceOrientation,
+				goal.TargetPosition + offset, goal.TargetOrientation))
+			.ToList();
+	}
+
+	public void RunOperation() {
+		var inputs = warmStart ? rigidBoneSystem.ApplyDeltas(initialInputs, poseDeltas) : new RigidBoneSystemInputs(initialInputs);
+		solver.Solve(rigidBoneSystem, MakeGoals(), inputs);
+		if (warmStart) {
+			poseDeltas = rigidBoneSystem.CalculateDeltas(initialInputs, inputs);
+		}
+		frameIdx += 1;
+
+		var statistics = solver.LastSolveStatistics;
+		solveCount += 1;
+		totalIterations += statistics.Iterations;
+		maxIterations = Math.Max(maxIterations, statistics.Iterations);
+		convergedCount += statistics.Converged ? 1 : 0;
+	}
+
+	public string Details => solveCount == 0 ? null : String.Format(CultureInfo.InvariantCulture,
+		"{0:F2} iterations per solve, max {1}, {2:F1}% converged within {3}cm",
+		(double) totalIterations / solveCount, maxIterations, 100.0 * convergedCount / solveCount, solver.Tolerance);
+
+	public void Dispose() {
+	}
+}
@@ -0,0 +1,47 @@
+using SharpDX;
+using System;
+
+/**
+ * Blends synthetic random poses the way ActorBehavior blends animation samples each frame.
+ */
+public class PoseBlendingBenchmark : IBenchmark {
+	private const int BoneCount = 170;
+	private const int PoseCount = 4;
+
+	private PoseBlender blender;
+	private Pose result;
+	private Pose[] poses;
+	private float[] weights;
+
+	public string Name => "pose-blending";
+
+	public void Setup() {
+		var random = new Random(0);
+		float NextFloat() => (float) random.NextDouble() * 2 - 1;
+
+		poses = new Pose[PoseCount];
+		weights = new float[PoseCount];
+		for (int poseIdx = 0; poseIdx < PoseCount; ++poseIdx) {
+			var rotations = new Quaternion[BoneCount];
+			for (int boneIdx = 0; boneIdx < BoneCount; ++boneIdx) {
+				rotations[boneIdx] = Quaternion.Normalize(new Quaternion(NextFloat(), NextFloat(), NextFloat(), NextFloat()));
+			}
+			poses[poseIdx] = new Pose(new Vector3(NextFloat(), NextFloat(), NextFloat()), rotations);
+			weights[poseIdx] = 1f / PoseCount;
+		}
+
+		blender = new PoseBlender(BoneCount);
+		result = Pose.MakeIdentity(BoneCount);
+	}
+
+	public void RunOperation() {
+		blender.Reset();
+		for (int poseIdx = 0; poseIdx < PoseCount; ++poseIdx) {
+			blender.Add(weights[poseIdx], poses[poseIdx]);
+		}
+		blender.GetResult(result);
+	}
+
+	public void Dispose() {
+	}
+}
@@ -0,0 +1,57 @@
+using SharpDX;
+
+/**
+ * Refines the figure's unposed control vertices with its subdivision stencils on the CPU, computing the same positions
+ * and tangents that the VertexRefiner shader does.
+ */
+public class StencilRefinementBenchmark : IBenchmark {
+	private ArraySegment[] stencilSegments;
+	private WeightedIndexWithDerivatives[] stencilElems;
+	private Vector3[] controlPositions;
+	private Vector3[] refinedPositions;
+	private Vector3[] refinedDs;
+	private Vector3[] refinedDt;
+
+	public string Name => "stencil-refinement";
+
+	public void Setup() {
+		var figure = FigureBenchmarkData.Load();
+		var surfaceProperties = Persistance.Load<SurfaceProperties>(figure.Directory.File("surface-properties.dat"));
+		var shaperParameters = Persistance.Load<ShaperParameters>(figure.Directory.File("shaper-parameters.dat"));
+
+		var refinedMeshDirectory = figure.Directory.Subdirectory("refinement").Subdirectory("level-" + surfaceProperties.SubdivisionLevel);
+		var mesh = SubdivisionMeshPersistance.Load(refinedMeshDirectory);
+
+		stencilSegments = mesh.Stencils.Segments;
+		stencilElems = mesh.Stencils.Elems;
+		controlPositions = shaperParameters.InitialPositions;
+
+		refinedPositions = new Vector3[stencilSegments.Length];
+		refinedDs = new Vector3[stencilSegments.Length];
+		refinedDt = new Vector3[stencilSegments.Length];
+	}
+
+	public void RunOperation() {
+		for (int vertexIdx = 0; vertexIdx < stencilSegments.Length; ++vertexIdx) {
+			var segment = stencilSegments[vertexIdx];
+
+			Vector3 position = Vector3.Zero;
+			Vector3 ds = Vector3.Zero;
+			Vector3 dt = Vector3.Zero;
+			for (int i = 0; i < segment.Count; ++i) {
+				var stencil = stencilElems[segment.Offset + i];
+				var controlPosition = controlPositions[stencil.Index];
+				position += stencil.Weight * controlPosition;
+				ds += stencil.DuWeight * controlPosition;
+				dt += stencil.DvWeight * controlPosition;
+			}
+
+			refinedPositions[vertexIdx] = position;
+			refinedDs[vertexIdx] = ds;
+			refinedDt[vertexIdx] = dt;
+		}
+	}
+
+	public void Dispose() {
+	}
+}
@@ -0,0 +1,68 @@
+using System;
+using System.Diagnostics;
+
+/**
+ * Times a benchmark: the operation is first repeated in batches of doubling size until a batch takes at least
+ * MinIterationTime, so that timer resolution doesn't dominate short operations. That batch size is then run for the
+ * warmup iterations, which are discarded, and for the measured iterations.
+ */
+public class BenchmarkHarness {
+	public int WarmupIterations { get; }
+	public int MeasuredIterations { get; }
+	public TimeSpan MinIterationTime { get; }
+
+	public BenchmarkHarness(int warmupIterations, int measuredIterations, TimeSpan minIterationTime) {
+		if (measuredIterations < 1) {
+			throw new ArgumentOutOfRangeException(nameof(measuredIterations), "at least one measured iteration is required");
+		}
+
+		WarmupIterations = warmupIterations;
+		MeasuredIterations = measuredIterations;
+		MinIterationTime = minIterationTime;
+	}
+
+	private static double RunIteration(IBenchmark benchmark, int operationCount) {
+		long startTimestamp = Stopwatch.GetTimestamp();
+		for (int i = 0; i < operationCount; ++i) {
+			benchmark.RunOperation();
+		}
+		long elapsed = Stopwatch.GetTimestamp() - startTimestamp;
+		return elapsed * 1e6 / Stopwatch.Frequency;
+	}
+
+	public BenchmarkResult Run(IBenchmark benchmark) {
+		try {
+			benchmark.Setup();
+
+			double minIterationMicroseconds = MinIterationTime.TotalMilliseconds * 1000;
+			int operationsPerIteration = 1;
+			while (RunIteration(benchmark, operationsPerIteration) < minIterationMicroseconds && operationsPerIteration < (1 << 24)) {
+				operationsPerIteration *= 2;
+			}
+
+			for (int i = 0; i < WarmupIterations; ++i) {
+				RunIteration(benchmark, operationsPerIteration);
+			}
+
+			GC.Collect();
+			GC.WaitForPendingFinalizers();
+			int initialGen0Collections = GC.CollectionCount(0);
+
+			var iterationMicroseconds = new double[MeasuredIterations];
+			for (int i = 0; i < MeasuredIterations; ++i) {
+				iterationMicroseconds[i] = RunIteration(benchmark, operationsPerIteration);
+			}
+
+			int gen0Collections = GC.CollectionCount(0) - initialGen0Collections;
+			var result = BenchmarkResult.Make(benchmark.Name, operationsPerIteration, iterationMicroseconds, gen0Collections);
+			result.Details = (benchmark as IBenchmarkDetails)?.Details;
+			return result;
+		} catch (BenchmarkSkippedException e) {
+			return new BenchmarkResult { Name = benchmark.Name, Status = BenchmarkResult.Skipped, Message = e.Message };
+		} catch (Exception e) {
+			return new BenchmarkResult { Name = benchmark.Name, Status = BenchmarkResult.Failed, Message = e.ToString() };
+		} finally {
+			benchmark.Dispose();
+		}
+	}
+}
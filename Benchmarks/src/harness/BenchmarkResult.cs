@@ -0,0 +1,84 @@
+using Newtonsoft.Json;
+using System;
+using System.Globalization;
+using System.Linq;
+
+public class BenchmarkResult {
+	public const string Succeeded = "succeeded";
+	public const string Skipped = "skipped";
+	public const string Failed = "failed";
+
+	[JsonProperty("name")]
+	public string Name;
+
+	[JsonProperty("status")]
+	public string Status;
+
+	[JsonProperty("message", NullValueHandling = NullValueHandling.Ignore)]
+	public string Message;
+
+	[JsonProperty("operations-per-iteration")]
+	public int OperationsPerIteration;
+
+	[JsonProperty("iterations")]
+	public int Iterations;
+
+	//all times are per operation
+	[JsonProperty("mean-us")]
+	public double Mean;
+
+	[JsonProperty("stddev-us")]
+	public double StandardDeviation;
+
+	[JsonProperty("min-us")]
+	public double Min;
+
+	[JsonProperty("median-us")]
+	public double Median;
+
+	[JsonProperty("p95-us")]
+	public double P95;
+
+	[JsonProperty("max-us")]
+	public double Max;
+
+	[JsonProperty("gen0-collections")]
+	public int Gen0Collections;
+
+	[JsonProperty("details", NullValueHandling = NullValueHandling.Ignore)]
+	public string Details;
+
+	public static BenchmarkResult Make(string name, int operationsPerIteration, double[] iterationMicroseconds, int gen0Collections) {
+		var perOperation = iterationMicroseconds
+			.Select(time => time / operationsPerIteration)
+			.OrderBy(time => time)
+			.ToArray();
+		int count = perOperation.Length;
+		double mean = perOperation.Average();
+		double variance = count > 1 ? perOperation.Sum(time => (time - mean) * (time - mean)) / (count - 1) : 0;
+
+		return new BenchmarkResult {
+			Name = name,
+			Status = Succeeded,
+			OperationsPerIteration = operationsPerIteration,
+			Iterations = count,
+			Mean = mean,
+			StandardDeviation = Math.Sqrt(variance),
+			Min = perOperation[0],
+			Median = count % 2 == 1 ? perOperation[count / 2] : (perOperation[count / 2 - 1] + perOperation[count / 2]) / 2,
+			P95 = perOperation[Math.Max((int) Math.Ceiling(0.95 * count), 1) - 1],
+			Max = perOperation[count - 1],
+			Gen0Collections = gen0Collections
+		};
+	}
+
+	public override string ToString() {
+		if (Status != Succeeded) {
+			return $"{Name}: {Status} ({Message})";
+		}
+		return String.Format(CultureInfo.InvariantCulture,
+			"{0}: mean {1:F2}us ± {2:F2}us, min {3:F2}us, median {4:F2}us, p95 {5:F2}us, max {6:F2}us ({7} x {8} ops, {9} gen0 GCs)",
+			Name, Mean, StandardDeviation, Min, Median, P95, Max, Iterations, OperationsPerIteration, Gen0Collections)
+			+ (Details != null ? "; " + Details : "");
+	}
+}
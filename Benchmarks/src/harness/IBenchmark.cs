@@ -0,0 +1,26 @@
+using System;
+
+/**
+ * A single operation to time. Setup runs once, untimed, before the operation is repeated; Dispose runs after.
+ */
+public interface IBenchmark : IDisposable {
+	string Name { get; }
+	void Setup();
+	void RunOperation();
+}
+
+/**
+ * A benchmark with statistics of its own, such as solver iteration counts, to report alongside the timings. Details
+ * is read after the measured iterations.
+ */
+public interface IBenchmarkDetails {
+	string Details { get; }
+}
+
+/**
+ * Thrown from Setup when a benchmark can't run on this machine, such as when imported figure data is missing.
+ */
+public class BenchmarkSkippedException : Exception {
+	public BenchmarkSkippedException(string message) : base(message) {
+	}
+}
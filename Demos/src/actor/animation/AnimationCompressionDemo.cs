@@ -0,0 +1,107 @@
+using SharpDX;
+using System;
+using System.Collections.Generic;
+using System.Diagnostics;
+using System.IO;
+using System.Linq;
+
+/**
+ * Reports the size, reconstruction error and sampling throughput of compressed clips against uncompressed pose lists.
+ */
+public class AnimationCompressionDemo : IDemoApp {
+	private const int ClipCount = 20;
+	private const int BoneCount = 170;
+	private const int FrameCount = 300;
+	private const int SampleTrialCount = 20000;
+
+	private static readonly DirectoryInfo WorkDir = CommonPaths.WorkDir.Subdirectory("animation-compression-benchmark");
+
+	private static double MeasureMicroseconds(Action action) {
+		for (int i = 0; i < SampleTrialCount / 10; ++i) {
+			action();
+		}
+
+		var stopwatch = Stopwatch.StartNew();
+		for (int i = 0; i < SampleTrialCount; ++i) {
+			action();
+		}
+		return stopwatch.Elapsed.TotalMilliseconds * 1000 / SampleTrialCount;
+	}
+
+	public void Run() {
+		WorkDir.CreateWithParents();
+
+		var rnd = new Random(0);
+		var sourceClips = Enumerable.Range(0, ClipCount)
+			.Select(i => SyntheticAnimations.Make(rnd, BoneCount, FrameCount))
+			.ToList();
+
+		long protobufBytes = 0;
+		long clipBytes = 0;
+		double maxError = 0;
+		double sumError = 0;
+		long errorCount = 0;
+
+		var clips = new List<AnimationClip>();
+		for (int clipIdx = 0; clipIdx < ClipCount; ++clipIdx) {
+			var poses = sourceClips[clipIdx];
+
+			var protobufStream = new MemoryStream();
+			Persistance.Write(protobufStream, poses);
+			protobufBytes += protobufStream.Length;
+
+			var clipFile = WorkDir.File($"clip-{clipIdx}{Animation.ClipExtension}");
+			AnimationClip.Save(clipFile, poses);
+			clipFile.Refresh();
+			clipBytes += clipFile.Length;
+
+			var clip = AnimationClip.Open(UnpackedArchiveFile.Make(clipFile));
+			clips.Add(clip);
+
+			for (int frameIdx = 0; frameIdx < FrameCount; ++frameIdx) {
+				var decodedPose = clip.GetPose(frameIdx);
+				for (int boneIdx = 0; boneIdx < BoneCount; ++boneIdx) {
+					var delta = Quaternion.Invert(poses[frameIdx].BoneRotations[boneIdx]) * decodedPose.BoneRotations[boneIdx];
+					double error = delta.AccurateAngle();
+					maxError = Math.Max(maxError, error);
+					sumError += error;
+					errorCount += 1;
+				}
+			}
+		}
+
+		Console.WriteLine($"size: protobuf {protobufBytes / (1024.0 * 1024.0):F2} MB, clip {clipBytes / (1024.0 * 1024.0):F2} MB ({(double) protobufBytes / clipBytes:F1}x smaller)");
+		Console.WriteLine($"error: max {MathUtil.RadiansToDegrees((float) maxError):F3} deg, mean {MathUtil.RadiansToDegrees((float) (sumError / errorCount)):F4} deg");
+
+		float time = 0;
+		var uncompressedA = sourceClips[0];
+		var uncompressedB = sourceClips[1];
+		double uncompressedMicroseconds = MeasureMicroseconds(() => {
+			time = (time + 0.37f) % FrameCount;
+			int baseFrameIdx = (int) time;
+			float alpha = time - baseFrameIdx;
+			var blender = new PoseBlender(BoneCount);
+			blender.Add(0.5f * (1 - alpha), uncompressedA[baseFrameIdx]);
+			blender.Add(0.5f * alpha, uncompressedA[(baseFrameIdx + 1) % FrameCount]);
+			blender.Add(0.5f * (1 - alpha), uncompressedB[baseFrameIdx]);
+			blender.Add(0.5f * alpha, uncompressedB[(baseFrameIdx + 1) % FrameCount]);
+			blender.GetResult();
+		});
+
+		var reusedBlender = new PoseBlender(BoneCount);
+		var reusedResult = Pose.MakeIdentity(BoneCount);
+		double compressedMicroseconds = MeasureMicroseconds(() => {
+			time = (time + 0.37f) % FrameCount;
+			reusedBlender.Reset();
+			clips[0].Sample(time, 0.5f, reusedBlender);
+			clips[1].Sample(time, 0.5f, reusedBlender);
+			reusedBlender.GetResult(reusedResult);
+		});
+
+		Console.WriteLine($"two-clip blend: uncompressed {uncompressedMicroseconds:F2} us, compressed {compressedMicroseconds:F2} us");
+
+		foreach (var clip in clips) {
+			clip.Dispose();
+		}
+	}
+}
@@ -0,0 +1,73 @@
+using System;
+using System.Collections.Generic;
+using System.Diagnostics;
+using System.IO;
+using System.Linq;
+
+/**
+ * Compares loading a large synthetic animation library from protobuf pose lists against memory-mapped clips.
+ */
+public class AnimationLibraryPerformanceDemo : IDemoApp {
+	private const int ClipCount = 1000;
+	private const int BoneCount = 170;
+	private const int FrameCount = 300;
+
+	private static readonly DirectoryInfo LibraryDir = CommonPaths.WorkDir.Subdirectory("animation-library-benchmark");
+
+	private static void GenerateLibrary() {
+		var legacyDir = LibraryDir.Subdirectory("legacy");
+		var clipDir = LibraryDir.Subdirectory("clip");
+		if (legacyDir.Exists && clipDir.Exists) {
+			return;
+		}
+
+		Console.WriteLine($"generating {ClipCount} clips...");
+		legacyDir.CreateWithParents();
+		clipDir.CreateWithParents();
+
+		var rnd = new Random(0);
+		for (int clipIdx = 0; clipIdx < ClipCount; ++clipIdx) {
+			var poses = SyntheticAnimations.Make(rnd, BoneCount, FrameCount);
+			Persistance.Save(legacyDir.File($"clip-{clipIdx}{Animation.LegacyExtension}"), poses);
+			AnimationClip.Save(clipDir.File($"clip-{clipIdx}{Animation.ClipExtension}"), poses);
+		}
+	}
+
+	private static void Measure(string label, DirectoryInfo dir) {
+		GC.Collect();
+		GC.WaitForPendingFinalizers();
+		long managedBefore = GC.GetTotalMemory(true);
+		long workingSetBefore = Process.GetCurrentProcess().WorkingSet64;
+
+		var stopwatch = Stopwatch.StartNew();
+		var archiveDir = UnpackedArchiveDirectory.Make(dir);
+		var animations = archiveDir.GetFiles()
+			.Where(Animation.IsAnimationFile)
+			.Select(file => Animation.Load(file))
+			.ToList();
+		double loadMilliseconds = stopwatch.Elapsed.TotalMilliseconds;
+
+		//sample every clip once, as if each had been played
+		stopwatch.Restart();
+		foreach (var animation in animations) {
+			animation.GetPose(animation.FrameCount / 2);
+		}
+		double firstSampleMilliseconds = stopwatch.Elapsed.TotalMilliseconds;
+
+		long managedAfter = GC.GetTotalMemory(true);
+		long workingSetAfter = Process.GetCurrentProcess().WorkingSet64;
+		
+		Console.WriteLine($"{label}: {animations.Count} clips, load {loadMilliseconds:F0} ms, sample-all {firstSampleMilliseconds:F0} ms, " +
+			$"managed +{(managedAfter - managedBefore) / (1024.0 * 1024.0):F1} MB, working set +{(workingSetAfter - workingSetBefore) / (1024.0 * 1024.0):F1} MB");
+
+		foreach (var animation in animations) {
+			animation.Dispose();
+		}
+	}
+
+	public void Run() {
+		GenerateLibrary();
+		Measure("protobuf", LibraryDir.Subdirectory("legacy"));
+		Measure("clip", LibraryDir.Subdirectory("clip"));
+	}
+}
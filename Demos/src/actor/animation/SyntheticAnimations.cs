@@ -0,0 +1,31 @@
+using SharpDX;
+using System;
+using System.Collections.Generic;
+using System.Linq;
+
+public static class SyntheticAnimations {
+	/**
+	 * Makes a smoothly varying animation: each bone oscillates around a random rest orientation about a random axis,
+	 * which resembles mocap data closely enough for size and speed measurements.
+	 */
+	public static List<Pose> Make(Random rnd, int boneCount, int frameCount) {
+		var restRotations = Enumerable.Range(0, boneCount).Select(i => RandomUtil.UnitQuaternion(rnd)).ToArray();
+		var axes = Enumerable.Range(0, boneCount).Select(i => RandomUtil.UnitVector3(rnd)).ToArray();
+		var amplitudes = Enumerable.Range(0, boneCount).Select(i => (float) rnd.NextDouble()).ToArray();
+		var frequencies = Enumerable.Range(0, boneCount).Select(i => (float) (0.5 + rnd.NextDouble())).ToArray();
+		
+		return Enumerable.Range(0, frameCount)
+			.Select(frameIdx => {
+				float time = frameIdx / 30f;
+				var rootTranslation = new Vector3(MathUtil.TwoPi * (float) Math.Sin(time), 0, time);
+				var boneRotations = Enumerable.Range(0, boneCount)
+					.Select(boneIdx => {
+						float angle = amplitudes[boneIdx] * (float) Math.Sin(MathUtil.TwoPi * frequencies[boneIdx] * time);
+						return Quaternion.RotationAxis(axes[boneIdx], angle) * restRotations[boneIdx];
+					})
+					.ToArray();
+				return new Pose(rootTranslation, boneRotations);
+			})
+			.ToList();
+	}
+}
@@ -1,3 +1,5 @@
+using System;
+
 public class PackContentApp : IDemoApp {
 	public void Run() {
 		var contentDir = CommonPaths.WorkDir.Subdirectory("content");
@@ -7,7 +9,39 @@ public class PackContentApp : IDemoApp {
 
 		foreach (var subDir in contentDir.GetDirectories()) {
 			var packer = new ArchivePacker();
-			packer.Pack(packedContentDir.File($"{subDir.Name}.archive"), subDir);
+			var statistics = packer.PackIncremental(packedContentDir.File($"{subDir.Name}.archive"), subDir);
+			Console.WriteLine($"{subDir.Name}: {statistics}");
+		}
+	}
+}
+
+/**
+ * Packs each content directory twice, once the way the original packer did (sequential, no deduplication) and once
+ * with deduplication and parallel copying, and reports the throughput and size of each.
+ */
+public class PackContentBenchmarkApp : IDemoApp {
+	public void Run() {
+		var contentDir = CommonPaths.WorkDir.Subdirectory("content");
+
+		var benchmarkDir = CommonPaths.WorkDir.Subdirectory("packed-content-benchmark");
+		benchmarkDir.CreateWithParents();
+
+		foreach (var subDir in contentDir.GetDirectories()) {
+			var sequentialFile = benchmarkDir.File($"{subDir.Name}.sequential.archive");
+			var sequentialStatistics = new ArchivePacker(false, 1).Pack(sequentialFile, subDir);
+
+			var parallelFile = benchmarkDir.File($"{subDir.Name}.archive");
+			var parallelStatistics = new ArchivePacker().Pack(parallelFile, subDir);
+
+			sequentialFile.Refresh();
+			parallelFile.Refresh();
+
+			Console.WriteLine($"{subDir.Name}:");
+			Console.WriteLine($"\tsequential: {sequentialStatistics}; archive size {sequentialFile.Length / (1024.0 * 1024.0):F1} MB");
+			Console.WriteLine($"\tparallel:   {parallelStatistics}; archive size {parallelFile.Length / (1024.0 * 1024.0):F1} MB");
+			Console.WriteLine($"\tspeedup:    {sequentialStatistics.TotalTime.TotalSeconds / parallelStatistics.TotalTime.TotalSeconds:F2}x");
+
+			sequentialFile.Delete();
 		}
 	}
 }
@@ -16,7 +16,7 @@ public class BoneSystemPerformanceDemo : IDemoApp {
 		var boneSystemRecipe = Persistance.Load<BoneSystemRecipe>(figureDir.File("bone-system-recipe.dat"));
 		boneSystem = boneSystemRecipe.Bake(channelSystem.ChannelsByName);
 		
-		var pose = Persistance.Load<List<Pose>>(figureDir.File("animations/idle.dat"))[0];
+		var pose = AnimationClip.LoadPose(figureDir.File("animations/idle.clip"), 0);
 		inputs = channelSystem.MakeDefaultChannelInputs();
 		new Poser(channelSystem, boneSystem).Apply(inputs, pose, DualQuaternion.Identity);
 	}
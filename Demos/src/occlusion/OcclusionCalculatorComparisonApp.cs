@@ -0,0 +1,63 @@
+using SharpDX.Direct3D;
+using SharpDX.Direct3D11;
+using System;
+using System.Diagnostics;
+
+/**
+ * Calculates the occlusion of Genesis 3 Female in her default shape with both the GPU and CPU occlusion calculators,
+ * and reports the time of each and the largest and mean differences between their results.
+ *
+ * The face transparencies are read from the imported figure, so the importer must have run first.
+ */
+public class OcclusionCalculatorComparisonApp : IDemoApp {
+	private static OcclusionInfo[] Calculate(string name, ContentFileLocator fileLocator, Device device, ShaderCache shaderCache,
+		FigureGroup figureGroup, FaceTransparenciesGroup faceTransparenciesGroup, ChannelOutputsGroup outputsGroup) {
+		using (var calculator = new FigureOcclusionCalculator(fileLocator, device, shaderCache, figureGroup, faceTransparenciesGroup)) {
+			var stopwatch = Stopwatch.StartNew();
+			var result = calculator.CalculateOcclusionInformation(outputsGroup);
+			stopwatch.Stop();
+			Console.WriteLine($"{name}: {stopwatch.Elapsed.TotalMilliseconds:F0} ms for {result.ParentOcclusion.Length} vertices");
+			return result.ParentOcclusion;
+		}
+	}
+
+	private static void ReportDifferences(string component, OcclusionInfo[] gpuInfos, OcclusionInfo[] cpuInfos, Func<OcclusionInfo, float> getComponent) {
+		double maxDifference = 0;
+		double totalDifference = 0;
+		int maxDifferenceIdx = 0;
+		for (int i = 0; i < gpuInfos.Length; ++i) {
+			double difference = Math.Abs(getComponent(gpuInfos[i]) - getComponent(cpuInfos[i]));
+			totalDifference += difference;
+			if (difference > maxDifference) {
+				maxDifference = difference;
+				maxDifferenceIdx = i;
+			}
+		}
+		Console.WriteLine($"{component}: max difference {maxDifference:F4} (vertex {maxDifferenceIdx}), mean difference {totalDifference / gpuInfos.Length:F5}");
+	}
+
+	public void Run() {
+		var fileLocator = new ContentFileLocator();
+		var objectLocator = new DsonObjectLocator(fileLocator);
+		var contentPackConfs = ContentPackImportConfiguration.LoadAll(CommonPaths.ConfDir);
+		var pathManager = ImporterPathManager.Make(contentPackConfs);
+		var loader = new FigureRecipeLoader(fileLocator, objectLocator, pathManager);
+		var figure = loader.LoadFigureRecipe("genesis-3-female", null).Bake(fileLocator, null);
+
+		var surfaceProperties = SurfacePropertiesJson.Load(pathManager, figure);
+		var figureDestDir = CommonPaths.WorkDir.Subdirectory("figures").Subdirectory(figure.Name);
+		var faceTransparencies = FaceTransparencies.For(figure, surfaceProperties, figureDestDir);
+
+		var figureGroup = new FigureGroup(figure);
+		var faceTransparenciesGroup = new FaceTransparenciesGroup(faceTransparencies);
+		var outputsGroup = figureGroup.Evaluate(new ChannelInputsGroup(figure.MakeDefaultChannelInputs(), new ChannelInputs[0]));
+
+		using (var device = new Device(DriverType.Hardware, DeviceCreationFlags.None, FeatureLevel.Level_11_1))
+		using (var shaderCache = new ShaderCache(device)) {
+			var gpuInfos = Calculate("gpu", fileLocator, device, shaderCache, figureGroup, faceTransparenciesGroup, outputsGroup);
+			var cpuInfos = Calculate("cpu", fileLocator, null, null, figureGroup, faceTransparenciesGroup, outputsGroup);
+			ReportDifferences("front", gpuInfos, cpuInfos, info => info.Front);
+			ReportDifferences("back", gpuInfos, cpuInfos, info => info.Back);
+		}
+	}
+}
@@ -0,0 +1,65 @@
+using SharpDX;
+using System;
+using System.Diagnostics;
+using System.IO;
+using System.Runtime.InteropServices;
+
+/**
+ * Measures how long it takes to deserialize the largest protobuf-persisted figure files from memory, which isolates
+ * decoding cost from disk access. Each file is re-encoded in both the old format, with raw array blocks inline in the
+ * protobuf message, and the new format, with the blocks after the message where they're copied straight out of memory.
+ */
+public class PersistanceLoadPerformanceDemo : IDemoApp {
+	private const int TrialCount = 20;
+
+	private static double Time(Action action) {
+		//warm up the protobuf-net serializers
+		action();
+
+		var stopwatch = Stopwatch.StartNew();
+		for (int i = 0; i < TrialCount; ++i) {
+			action();
+		}
+		return stopwatch.Elapsed.TotalMilliseconds / TrialCount;
+	}
+
+	private static void Report(string name, string format, long size, double milliseconds) {
+		Console.WriteLine($"{name} ({format}): {size / (1024.0 * 1024.0):F1} MB, {milliseconds:F2} ms, {size / (1024.0 * 1024.0) / (milliseconds / 1000):F0} MB/s");
+	}
+
+	private static void Measure<T>(FileInfo file) {
+		if (!file.Exists) {
+			Console.WriteLine($"{file.Name}: missing");
+			return;
+		}
+
+		T obj = Persistance.Load<T>(file);
+
+		var inlineStream = new MemoryStream();
+		Persistance.Write(inlineStream, obj);
+		byte[] inlineBytes = inlineStream.ToArray();
+
+		var blocksStream = new MemoryStream();
+		Persistance.WriteWithBlocks(blocksStream, obj);
+		byte[] blocksBytes = blocksStream.ToArray();
+
+		double inlineMilliseconds = Time(() => Persistance.Read<T>(new MemoryStream(inlineBytes)));
+		Report(file.Name, "old, inline blocks", inlineBytes.Length, inlineMilliseconds);
+
+		var handle = GCHandle.Alloc(blocksBytes, GCHandleType.Pinned);
+		try {
+			var dataPointer = new DataPointer(handle.AddrOfPinnedObject(), blocksBytes.Length);
+			double blocksMilliseconds = Time(() => Persistance.Read<T>(dataPointer));
+			Report(file.Name, "new, trailing blocks", blocksBytes.Length, blocksMilliseconds);
+			Console.WriteLine($"{file.Name}: new format loads in {blocksMilliseconds / inlineMilliseconds:P0} of the old format's time");
+		} finally {
+			handle.Free();
+		}
+	}
+
+	public void Run() {
+		var figureDir = new DirectoryInfo("work/figures/genesis-3-female");
+		Measure<ShaperParameters>(figureDir.File("shaper-parameters.dat"));
+		Measure<OccluderParameters>(figureDir.Subdirectory("occlusion").File("occluder-parameters.dat"));
+	}
+}
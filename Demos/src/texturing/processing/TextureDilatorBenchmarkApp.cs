@@ -0,0 +1,93 @@
+using SharpDX;
+using SharpDX.Direct3D;
+using SharpDX.Direct3D11;
+using System;
+using System.Diagnostics;
+
+/**
+ * Dilates a synthetic 4K texture masked by a grid of randomly chosen UV islands with both the GPU and CPU dilators, and
+ * reports the time of each and the largest per-channel difference between their results.
+ */
+public class TextureDilatorBenchmarkApp : IDemoApp {
+	private const int Resolution = 4096;
+	private const int GridSize = 64;
+	private const int Iterations = 5;
+
+	private static TextureMask MakeRandomIslandMask(Random random) {
+		var uvs = new Vector2[(GridSize + 1) * (GridSize + 1)];
+		for (int y = 0; y <= GridSize; ++y) {
+			for (int x = 0; x <= GridSize; ++x) {
+				uvs[y * (GridSize + 1) + x] = new Vector2((float) x / GridSize, (float) y / GridSize);
+			}
+		}
+
+		var faces = new Quad[GridSize * GridSize];
+		var surfaceMap = new int[faces.Length];
+		for (int y = 0; y < GridSize; ++y) {
+			for (int x = 0; x < GridSize; ++x) {
+				int idx0 = y * (GridSize + 1) + x;
+				faces[y * GridSize + x] = new Quad(idx0, idx0 + 1, idx0 + GridSize + 2, idx0 + GridSize + 1);
+				surfaceMap[y * GridSize + x] = random.Next(3) == 0 ? 0 : 1;
+			}
+		}
+
+		return new TextureMask(new UvSet("islands", uvs, faces), surfaceMap, 0);
+	}
+
+	private static UnmanagedRgbaImage MakeRandomImage(Random random) {
+		var image = new UnmanagedRgbaImage(new Size2(Resolution, Resolution));
+		for (int i = 0; i < Resolution * Resolution; ++i) {
+			image[i] = (uint) random.Next() | 0xff000000;
+		}
+		return image;
+	}
+
+	private static UnmanagedRgbaImage Copy(UnmanagedRgbaImage source) {
+		var copy = new UnmanagedRgbaImage(source.Size);
+		Utilities.CopyMemory(copy.PixelData, source.PixelData, source.SizeInBytes);
+		return copy;
+	}
+
+	private static UnmanagedRgbaImage Benchmark(string name, ITextureDilator dilator, MultiUvTextureMask mask, UnmanagedRgbaImage source) {
+		UnmanagedRgbaImage result = null;
+		var stopwatch = new Stopwatch();
+		for (int i = 0; i < Iterations; ++i) {
+			result?.Dispose();
+			result = Copy(source);
+			stopwatch.Start();
+			dilator.Dilate(mask, result.Size, false, result.DataBox);
+			stopwatch.Stop();
+		}
+		Console.WriteLine($"{name}: {stopwatch.Elapsed.TotalMilliseconds / Iterations:F1} ms per {Resolution}x{Resolution} texture");
+		return result;
+	}
+
+	private static int MaxChannelDifference(UnmanagedRgbaImage a, UnmanagedRgbaImage b) {
+		int maxDifference = 0;
+		for (int i = 0; i < a.Size.Width * a.Size.Height; ++i) {
+			uint pixelA = a[i];
+			uint pixelB = b[i];
+			for (int shift = 0; shift < 32; shift += 8) {
+				int difference = Math.Abs((int) ((pixelA >> shift) & 0xff) - (int) ((pixelB >> shift) & 0xff));
+				maxDifference = Math.Max(maxDifference, difference);
+			}
+		}
+		return maxDifference;
+	}
+
+	public void Run() {
+		var random = new Random(0);
+		var mask = new MultiUvTextureMask();
+		mask.Merge(MakeRandomIslandMask(random));
+
+		using (var source = MakeRandomImage(random))
+		using (var device = new Device(DriverType.Hardware, DeviceCreationFlags.None, FeatureLevel.Level_11_1))
+		using (var shaderCache = new ShaderCache(device))
+		using (var gpuDilator = new TextureDilator(device, shaderCache))
+		using (var cpuDilator = new CpuTextureDilator())
+		using (var gpuResult = Benchmark("gpu", gpuDilator, mask, source))
+		using (var cpuResult = Benchmark("cpu", cpuDilator, mask, source)) {
+			Console.WriteLine($"max channel difference: {MaxChannelDifference(gpuResult, cpuResult)}");
+		}
+	}
+}
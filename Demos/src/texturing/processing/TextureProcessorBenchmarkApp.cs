@@ -0,0 +1,56 @@
+using SharpDX;
+using SharpDX.Direct3D;
+using SharpDX.Direct3D11;
+using System;
+using System.IO;
+using System.Linq;
+
+/**
+ * Processes every image in work/texture-benchmark/source twice, once one job at a time the way the processor used to
+ * run and once with the parallel scheduler, and compares the wall-clock time of each.
+ */
+public class TextureProcessorBenchmarkApp : IDemoApp {
+	private static readonly string[] ImageExtensions = { ".png", ".jpg", ".jpeg", ".tif", ".tiff", ".bmp" };
+
+	private static TextureMask MakeFullMask() {
+		var uvs = new [] {
+			new Vector2(0, 0),
+			new Vector2(1, 0),
+			new Vector2(1, 1),
+			new Vector2(0, 1)
+		};
+		var faces = new [] { new Quad(0, 1, 2, 3) };
+		return new TextureMask(new UvSet("full", uvs, faces), new [] { 0 }, 0);
+	}
+
+	private static JobGraphStatistics Process(Device device, ShaderCache shaderCache, FileInfo[] sourceFiles, DirectoryInfo destinationDir, int maxDegreeOfParallelism) {
+		if (destinationDir.Exists) {
+			destinationDir.Delete(true);
+		}
+
+		var mask = MakeFullMask();
+		var processor = new TextureProcessor(device, shaderCache, destinationDir, "benchmark", true, maxDegreeOfParallelism);
+		foreach (var file in sourceFiles) {
+			processor.RegisterForProcessing(file, TextureProcessingType.Color, false, mask);
+		}
+		return processor.ImportAll();
+	}
+
+	public void Run() {
+		var benchmarkDir = CommonPaths.WorkDir.Subdirectory("texture-benchmark");
+		var sourceFiles = benchmarkDir.Subdirectory("source").GetFiles()
+			.Where(file => ImageExtensions.Contains(file.Extension.ToLowerInvariant()))
+			.ToArray();
+		Console.WriteLine($"processing {sourceFiles.Length} textures...");
+
+		using (var device = new Device(DriverType.Hardware, DeviceCreationFlags.None, FeatureLevel.Level_11_1))
+		using (var shaderCache = new ShaderCache(device)) {
+			var sequentialStatistics = Process(device, shaderCache, sourceFiles, benchmarkDir.Subdirectory("sequential"), 1);
+			var parallelStatistics = Process(device, shaderCache, sourceFiles, benchmarkDir.Subdirectory("parallel"), -1);
+
+			Console.WriteLine($"sequential: {sequentialStatistics}");
+			Console.WriteLine($"parallel:   {parallelStatistics}");
+			Console.WriteLine($"speedup:    {sequentialStatistics.WallTime.TotalSeconds / parallelStatistics.WallTime.TotalSeconds:F2}x");
+		}
+	}
+}
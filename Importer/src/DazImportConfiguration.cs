@@ -31,6 +31,7 @@ public class MaterialSetImportConfiguration {
 		if (!file.Exists) {
 			return new MaterialSetImportConfiguration[0];
 		}
+		InputRecorder.Record(file);
 		string json = file.ReadAllText();
 		MaterialSetImportConfiguration[] confs = JsonConvert.DeserializeObject<MaterialSetImportConfiguration[]>(json);
 		return confs;
@@ -56,6 +57,7 @@ public class ShapeImportConfiguration {
 	public static ShapeImportConfiguration[] Load(DirectoryInfo figureConfDir) {
 		var shapesFile = figureConfDir.File("shapes.json");
 		if (shapesFile.Exists) {
+			InputRecorder.Record(shapesFile);
 			string json = shapesFile.ReadAllText();
 			ShapeImportConfiguration[] confs = JsonConvert.DeserializeObject<ShapeImportConfiguration[]>(json);
 			return confs;
@@ -1,57 +1,93 @@
 using System;
+using System.Collections.Generic;
 using System.IO;
 using System.Linq;
 using SharpDX.Direct3D11;
 
 public class FigureDumperLoader {
+	public const string ParentFigureName = "genesis-3-female";
+	public const string GenitaliaFigureName = "genesis-3-female-genitalia";
+
+	private class ParentFigures {
+		public Figure FigureWithoutGrafts { get; }
+		public Figure Figure { get; }
+		public float[] FaceTransparencies { get; }
+		public List<string> InputPaths { get; } //files read to load the parent figure, which every dumper depends on
+
+		public ParentFigures(Figure figureWithoutGrafts, Figure figure, float[] faceTransparencies, List<string> inputPaths) {
+			FigureWithoutGrafts = figureWithoutGrafts;
+			Figure = figure;
+			FaceTransparencies = faceTransparencies;
+			InputPaths = inputPaths;
+		}
+	}
+
 	private readonly ContentFileLocator fileLocator;
 	private readonly DsonObjectLocator objectLocator;
 	private readonly ImporterPathManager pathManager;
 	private readonly Device device;
 	private readonly ShaderCache shaderCache;
+	private readonly bool calculateOcclusionOnCpu;
 
 	private readonly FigureRecipeLoader figureRecipeLoader;
 
-	private readonly FigureRecipe parentFigureRecipe;
-	private readonly Figure parentFigureWithoutGrafts;
-	private readonly Figure parentFigure;
-	private readonly float[] parentFaceTransparencies;
+	//loaded and baked on first use, so that an import whose stages are all up to date never bakes the parent; the
+	//recipes are only loaded, since the jobs that use them wait for the jobs that update them
+	private readonly Lazy<FigureRecipe> parentFigureRecipe;
+	private readonly Lazy<ParentFigures> parentFigures;
 
-	public FigureDumperLoader(ContentFileLocator fileLocator, DsonObjectLocator objectLocator, ImporterPathManager pathManager, Device device, ShaderCache shaderCache) {
+	public FigureDumperLoader(ContentFileLocator fileLocator, DsonObjectLocator objectLocator, ImporterPathManager pathManager, Device device, ShaderCache shaderCache, bool calculateOcclusionOnCpu = false) {
 		this.fileLocator = fileLocator;
 		this.objectLocator = objectLocator;
 		this.pathManager = pathManager;
 		this.device = device;
 		this.shaderCache = shaderCache;
+		this.calculateOcclusionOnCpu = calculateOcclusionOnCpu;
 
 		figureRecipeLoader = new FigureRecipeLoader(fileLocator, objectLocator, pathManager);
 
-		FigureRecipe genesis3FemaleRecipe = figureRecipeLoader.LoadFigureRecipe("genesis-3-female", null);
-		Figure genesis3Female = genesis3FemaleRecipe.Bake(fileLocator, null);
-		FigureRecipe genitaliaRecipe = figureRecipeLoader.LoadFigureRecipe("genesis-3-female-genitalia", genesis3FemaleRecipe);
-		FigureRecipe genesis3FemaleWithGenitaliaRecipe = new FigureRecipeMerger(genesis3FemaleRecipe, genitaliaRecipe).Merge();
-		Figure genesis3FemaleWithGenitalia = genesis3FemaleWithGenitaliaRecipe.Bake(fileLocator, null);
-		SurfaceProperties genesis3FemaleSurfaceProperties = SurfacePropertiesJson.Load(pathManager, genesis3FemaleWithGenitalia);
-		float[] genesis3FemaleFaceTransparencies = FaceTransparencies.For(genesis3FemaleWithGenitalia, genesis3FemaleSurfaceProperties, null);
-
-		parentFigureRecipe = genesis3FemaleRecipe;
-		parentFigureWithoutGrafts = genesis3Female;
-		parentFigure = genesis3FemaleWithGenitalia;
-		parentFaceTransparencies = genesis3FemaleFaceTransparencies;
+		parentFigureRecipe = new Lazy<FigureRecipe>(() => figureRecipeLoader.LoadUpdatedFigureRecipe(ParentFigureName));
+		parentFigures = new Lazy<ParentFigures>(LoadParentFigures);
+	}
+
+	private ParentFigures LoadParentFigures() {
+		using (var recorder = InputRecorder.Start()) {
+			//the shared recipe may have been loaded under another recorder, so its file is recorded explicitly
+			InputRecorder.Record(FigureRecipeLoader.GetRecipeFile(ParentFigureName));
+			FigureRecipe genesis3FemaleRecipe = parentFigureRecipe.Value;
+			Figure genesis3Female = genesis3FemaleRecipe.Bake(fileLocator, null);
+			FigureRecipe genitaliaRecipe = figureRecipeLoader.LoadUpdatedFigureRecipe(GenitaliaFigureName);
+			FigureRecipe genesis3FemaleWithGenitaliaRecipe = new FigureRecipeMerger(genesis3FemaleRecipe, genitaliaRecipe).Merge();
+			Figure genesis3FemaleWithGenitalia = genesis3FemaleWithGenitaliaRecipe.Bake(fileLocator, null);
+			SurfaceProperties genesis3FemaleSurfaceProperties = SurfacePropertiesJson.Load(pathManager, genesis3FemaleWithGenitalia);
+			float[] genesis3FemaleFaceTransparencies = FaceTransparencies.For(genesis3FemaleWithGenitalia, genesis3FemaleSurfaceProperties, null);
+
+			return new ParentFigures(genesis3Female, genesis3FemaleWithGenitalia, genesis3FemaleFaceTransparencies, recorder.Paths);
+		}
+	}
+
+	public void UpdateRecipe(string figureName) {
+		var parentRecipe = figureName == ParentFigureName ? null : parentFigureRecipe.Value;
+		figureRecipeLoader.UpdateFigureRecipe(figureName, parentRecipe);
 	}
 
 	public FigureDumper LoadDumper(string figureName) {
+		var parents = parentFigures.Value;
+		InputRecorder.RecordAll(parents.InputPaths);
+		var parentFigure = parents.Figure;
+
 		var figure = figureName == parentFigure.Name ?
 			parentFigure :
-			figureRecipeLoader.LoadFigureRecipe(figureName, parentFigureRecipe).Bake(fileLocator, parentFigure);
+			figureRecipeLoader.LoadUpdatedFigureRecipe(figureName).Bake(fileLocator, parentFigure);
 
 		var figureConfDir = pathManager.GetConfDirForFigure(figure.Name);
 		MaterialSetImportConfiguration baseMaterialSetConfiguration = MaterialSetImportConfiguration.Load(figureConfDir).Single(conf => conf.name == "Base");
 		ShapeImportConfiguration baseShapeImportConfiguration = ShapeImportConfiguration.Load(figureConfDir).SingleOrDefault(conf => conf.name == "Base");
 		SurfaceProperties surfaceProperties = SurfacePropertiesJson.Load(pathManager, figure);
 
-		HdMorphToNormalMapConverter hdMorphToNormalMapConverter = figure == parentFigure ? new HdMorphToNormalMapConverter(device, shaderCache, parentFigureWithoutGrafts) : null;
-		ShapeDumper shapeDumper = new ShapeDumper(fileLocator, device, shaderCache, parentFigure, parentFaceTransparencies, figure, surfaceProperties, baseShapeImportConfiguration, hdMorphToNormalMapConverter);
+		HdMorphToNormalMapConverter hdMorphToNormalMapConverter = figure == parentFigure ? new HdMorphToNormalMapConverter(device, shaderCache, parents.FigureWithoutGrafts) : null;
+		Device occlusionDevice = calculateOcclusionOnCpu ? null : device;
+		ShapeDumper shapeDumper = new ShapeDumper(fileLocator, occlusionDevice, shaderCache, parentFigure, parents.FaceTransparencies, figure, surfaceProperties, baseShapeImportConfiguration, hdMorphToNormalMapConverter);
 		return new FigureDumper(fileLocator, objectLocator, device, shaderCache, parentFigure, figure, surfaceProperties, baseMaterialSetConfiguration, baseShapeImportConfiguration, shapeDumper);
 	}
 }
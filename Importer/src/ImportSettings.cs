@@ -79,6 +79,15 @@ public class ImportSettings {
 
 	public bool CompressTextures { get; set; } = false;
 
+	public bool DilateTexturesOnCpu { get; set; } = false;
+
+	public bool CalculateOcclusionOnCpu { get; set; } = false;
+
+	//added to the parameters of stages that bake occlusion, since the CPU and GPU results differ slightly
+	public string OcclusionStageParameters => CalculateOcclusionOnCpu ? ":cpu-occlusion" : "";
+
+	public int MaxDegreeOfParallelism { get; set; } = -1; // -1 means one worker per processor
+
 	private HashSet<string> Environments { get; set; } = new HashSet<string>();
 	
 	private Dictionary<string, FigureImportSettings> Figures { get; set; } = new Dictionary<string, FigureImportSettings>();
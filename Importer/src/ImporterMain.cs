@@ -1,11 +1,27 @@
+using Newtonsoft.Json;
 using SharpDX.Direct3D;
 using SharpDX.Direct3D11;
 using System;
+using System.Collections.Generic;
 using System.Collections.Immutable;
 using System.Diagnostics;
+using System.IO;
 using System.Linq;
 
 public class ImporterMain : IDisposable {
+	//bump a stage's version when a code change would change its outputs, to force them to be regenerated
+	private static readonly Dictionary<string, int> StageVersions = new Dictionary<string, int> {
+		["figure"] = 1,
+		["material-set"] = 1,
+		["base-shape"] = 1,
+		["shape"] = 1,
+		["character"] = 1,
+		["outfit"] = 1
+	};
+
+	//kept outside the content directory so that they aren't packed into the archives
+	private static readonly DirectoryInfo ManifestsDir = CommonPaths.WorkDir.Subdirectory("import-manifests");
+
 	private readonly ContentFileLocator fileLocator;
 	private readonly DsonObjectLocator objectLocator;
 	private readonly Device device;
@@ -46,81 +62,209 @@ public class ImporterMain : IDisposable {
 		} else {
 			settings = ImportSettings.MakeFromViewerInitialSettings();
 		}
+		if (args.Contains("cpu-dilation")) {
+			settings.DilateTexturesOnCpu = true;
+		}
+		if (args.Contains("cpu-occlusion")) {
+			settings.CalculateOcclusionOnCpu = true;
+		}
+		if (args.Contains("sequential")) {
+			settings.MaxDegreeOfParallelism = 1;
+		}
 		
 		var contentDestDir = CommonPaths.WorkDir.Subdirectory("content");
 
 		var contentPackConfs = ContentPackImportConfiguration.LoadAll(CommonPaths.ConfDir);
 		var pathManager = ImporterPathManager.Make(contentPackConfs);
 		
-		var figureDumperLoader = new FigureDumperLoader(fileLocator, objectLocator, pathManager, device, shaderCache);
+		var figureDumperLoader = new FigureDumperLoader(fileLocator, objectLocator, pathManager, device, shaderCache, settings.CalculateOcclusionOnCpu);
+
+		var graph = new JobGraph();
+		var textureProcessors = new List<TextureProcessor>();
+
+		//every figure is loaded against the parent figures, so their recipes are brought up to date before any other
+		//figure's jobs read them; the jobs are only added once some figure is imported
+		var parentRecipeJobs = new Lazy<Dictionary<string, JobGraph.Job>>(() => {
+			var parentRecipeJob = graph.Add(FigureDumperLoader.ParentFigureName, "figure-recipe",
+				() => figureDumperLoader.UpdateRecipe(FigureDumperLoader.ParentFigureName));
+			var genitaliaRecipeJob = graph.Add(FigureDumperLoader.GenitaliaFigureName, "figure-recipe",
+				() => figureDumperLoader.UpdateRecipe(FigureDumperLoader.GenitaliaFigureName), parentRecipeJob);
+			return new Dictionary<string, JobGraph.Job> {
+				[FigureDumperLoader.ParentFigureName] = parentRecipeJob,
+				[FigureDumperLoader.GenitaliaFigureName] = genitaliaRecipeJob
+			};
+		});
 
 		foreach (var contentPackConf in contentPackConfs) {
 			var destDir = contentDestDir.Subdirectory(contentPackConf.Name);
 
 			if (contentPackConf.IsCore) {
-				new UiImporter(destDir).Run();
-				new EnvironmentCubeGenerator().Run(settings, destDir);
+				graph.Add("ui", "ui", () => new UiImporter(destDir).Run());
+				//cmft renders the cubes on the GPU
+				graph.AddSerialized("environment", "environment", () => new EnvironmentCubeGenerator().Run(settings, destDir));
 			}
 
 			var texturesDir = destDir.Subdirectory("textures").Subdirectory(contentPackConf.Name);
-			var textureProcessor = new TextureProcessor(device, shaderCache, texturesDir, contentPackConf.Name, settings.CompressTextures);
+			var textureProcessor = new TextureProcessor(device, shaderCache, texturesDir, contentPackConf.Name, settings.CompressTextures,
+				settings.MaxDegreeOfParallelism,
+				cacheDirectory: CommonPaths.WorkDir.Subdirectory("texture-cache"),
+				dilateOnCpu: settings.DilateTexturesOnCpu,
+				manifestDirectory: ManifestsDir.Subdirectory(contentPackConf.Name).Subdirectory("textures"));
+			textureProcessors.Add(textureProcessor);
 
 			bool shouldImportAnything = false;
 
 			foreach (var figureConf in contentPackConf.Figures) {
-				string figureName = figureConf.Name;
-
-				if (!settings.FiguresToImport.Contains(figureName)) {
+				if (!settings.FiguresToImport.Contains(figureConf.Name)) {
 					continue;
 				}
 
-				var figureDumper = figureDumperLoader.LoadDumper(figureName);
-				
-				MaterialSetImportConfiguration[] materialSetConfigurations = MaterialSetImportConfiguration.Load(figureConf.Directory);
-				ShapeImportConfiguration[] shapeImportConfigurations = ShapeImportConfiguration.Load(figureConf.Directory);
+				shouldImportAnything |= AddFigureJobs(graph, settings, figureDumperLoader, parentRecipeJobs, textureProcessor, figureConf, destDir);
+			}
 
-				var figureDestDir = destDir.Subdirectory("figures").Subdirectory(figureName);
+			if (shouldImportAnything) {
+				var packManifestsDir = ManifestsDir.Subdirectory(contentPackConf.Name);
 
-				if (figureConf.IsPrimary) {
-					shouldImportAnything = true;
-					figureDumper.DumpFigure(shapeImportConfigurations, figureDestDir);
-				}
-				
-				foreach (var materialSetConf in materialSetConfigurations) {
-					if (!settings.ShouldImportMaterialSet(figureConf.Name, materialSetConf.name)) {
-						continue;
-					}
-
-					shouldImportAnything = true;
-					figureDumper.DumpMaterialSet(settings, textureProcessor, figureDestDir, materialSetConf);
+				foreach (var characterConf in contentPackConf.Characters) {
+					var stage = MakeStage("character", packManifestsDir.Subdirectory("characters").File(characterConf.Name + ".json"), "",
+						destDir.Subdirectory("characters").File(characterConf.File.GetNameWithoutExtension() + ".dat"));
+					graph.Add(characterConf.Name, "character", () => stage.Run(() => {
+						InputRecorder.Record(characterConf.File);
+						CharacterImporter.Import(pathManager, characterConf.File, destDir);
+					}));
 				}
 
-				if (figureConf.IsPrimary) {
-					shouldImportAnything = true;
-					figureDumper.DumpBaseShape(figureDestDir);
+				foreach (var outfitConf in contentPackConf.Outfits) {
+					var stage = MakeStage("outfit", packManifestsDir.Subdirectory("outfits").File(outfitConf.Name + ".json"), "",
+						destDir.Subdirectory("outfits").File(outfitConf.File.GetNameWithoutExtension() + ".dat"));
+					graph.Add(outfitConf.Name, "outfit", () => stage.Run(() => {
+						InputRecorder.Record(outfitConf.File);
+						OutfitImporter.Import(pathManager, outfitConf.File, destDir);
+					}));
 				}
+			}
+		}
 
-				foreach (var shapeConf in shapeImportConfigurations) {
-					if (!settings.ShouldImportShape(figureConf.Name, shapeConf.name)) {
-						continue;
-					}
+		var allStatistics = new List<JobGraphStatistics>();
+		allStatistics.Add(graph.Run(settings.MaxDegreeOfParallelism));
 
-					shouldImportAnything = true;
-					figureDumper.DumpShape(textureProcessor, figureDestDir, shapeConf);
-				}
-			}
+		//each processor runs its own job graph, which uses the immediate context, so they run after everything else
+		foreach (var textureProcessor in textureProcessors) {
+			allStatistics.Add(textureProcessor.ImportAll());
+		}
 
-			if (shouldImportAnything) {
-				foreach (var characterConf in contentPackConf.Characters) {
-					CharacterImporter.Import(pathManager, characterConf.File, destDir);
-				}
+		Console.WriteLine($"import: {JobGraphStatistics.Combine(allStatistics)}");
+		Console.WriteLine($"content index: {fileLocator.PackageCount} packages ({fileLocator.ScannedPackageCount} scanned, the rest cached) in {fileLocator.LoadTime.TotalSeconds:F1}s");
+		Console.WriteLine($"dson: {objectLocator.Statistics}");
+		Console.WriteLine($"peak working set: {Process.GetCurrentProcess().PeakWorkingSet64 / (1024 * 1024)} MB");
+	}
 
-				foreach (var outfitConf in contentPackConf.Outfits) {
-					OutfitImporter.Import(pathManager, outfitConf.File, destDir);
-				}
+	private static IncrementalStage MakeStage(string stageName, FileInfo manifestFile, string parameters, params FileSystemInfo[] outputs) {
+		return new IncrementalStage(manifestFile, $"{stageName}:{StageVersions[stageName]}:{parameters}", outputs);
+	}
+
+	/**
+	 * Adds the jobs that import one figure and returns whether there were any.
+	 *
+	 * The figure's recipe is brought up to date first, after the parent figures' recipes. Its system, geometry and UV sets only need the baked figure, so
+	 * they are dumped on the CPU concurrently with everything else. Material sets write the face transparencies that
+	 * occlusion reads, so the shape jobs wait for them. Material sets and shapes render on the GPU and are serialized.
+	 *
+	 * Every stage is incremental: it's skipped if its manifest shows that the files it read last time and its
+	 * configuration are unchanged. The figure is only baked if some stage actually needs to run.
+	 */
+	private static bool AddFigureJobs(JobGraph graph, ImportSettings settings, FigureDumperLoader figureDumperLoader, Lazy<Dictionary<string, JobGraph.Job>> parentRecipeJobs, TextureProcessor textureProcessor, ContentPackImportConfiguration.Figure figureConf, DirectoryInfo destDir) {
+		string figureName = figureConf.Name;
+
+		MaterialSetImportConfiguration[] materialSetConfigurations = MaterialSetImportConfiguration.Load(figureConf.Directory)
+			.Where(conf => settings.ShouldImportMaterialSet(figureName, conf.name))
+			.ToArray();
+		ShapeImportConfiguration[] allShapeImportConfigurations = ShapeImportConfiguration.Load(figureConf.Directory);
+		ShapeImportConfiguration[] shapeImportConfigurations = allShapeImportConfigurations
+			.Where(conf => settings.ShouldImportShape(figureName, conf.name))
+			.ToArray();
+
+		if (!figureConf.IsPrimary && materialSetConfigurations.Length == 0 && shapeImportConfigurations.Length == 0) {
+			return false;
+		}
+
+		var figureDestDir = destDir.Subdirectory("figures").Subdirectory(figureName);
+		var figureManifestsDir = ManifestsDir.Subdirectory(destDir.Name).Subdirectory("figures").Subdirectory(figureName);
+
+		//baked by whichever stage needs it first; every stage that uses it records the files it was loaded from
+		var figureDumperAndInputs = new Lazy<Tuple<FigureDumper, List<string>>>(() => {
+			using (var recorder = InputRecorder.Start()) {
+				var loadedDumper = figureDumperLoader.LoadDumper(figureName);
+				return Tuple.Create(loadedDumper, recorder.Paths);
 			}
+		});
+		FigureDumper GetFigureDumper() {
+			InputRecorder.RecordAll(figureDumperAndInputs.Value.Item2);
+			return figureDumperAndInputs.Value.Item1;
+		}
 
-			textureProcessor.ImportAll();
+		//the parent figures' recipes already have jobs; every other figure's recipe is imported against them
+		if (!parentRecipeJobs.Value.TryGetValue(figureName, out var ownRecipeJob)) {
+			ownRecipeJob = graph.Add(figureName, "figure-recipe", () => figureDumperLoader.UpdateRecipe(figureName), parentRecipeJobs.Value.Values.ToArray());
 		}
+
+		//loading the dumper reads both the figure's recipe and the parent figures' recipes
+		var recipeJobs = parentRecipeJobs.Value.Values.Concat(new [] { ownRecipeJob }).Distinct().ToArray();
+
+		if (figureConf.IsPrimary) {
+			var stage = MakeStage("figure", figureManifestsDir.File("figure.json"), JsonConvert.SerializeObject(allShapeImportConfigurations),
+				figureDestDir.File("surface-properties.dat"),
+				figureDestDir.File("shaper-parameters.dat"),
+				figureDestDir.File("channel-system-recipe.dat"),
+				figureDestDir.File("bone-system-recipe.dat"),
+				figureDestDir.File("inverter-parameters.dat"),
+				figureDestDir.File("child-to-parent-bind-pose-transforms.dat"),
+				figureDestDir.Subdirectory("animations"),
+				figureDestDir.Subdirectory("refinement"),
+				figureDestDir.Subdirectory("uv-sets"));
+			graph.Add(figureName, "figure", () => stage.Run(() => {
+				GetFigureDumper().DumpFigure(allShapeImportConfigurations, figureDestDir);
+			}), recipeJobs);
+		}
+
+		var materialSetJobs = materialSetConfigurations
+			.Select(conf => {
+				var stage = MakeStage("material-set", figureManifestsDir.Subdirectory("material-sets").File(conf.name + ".json"),
+					JsonConvert.SerializeObject(conf) + ":" + settings.CompressTextures + settings.OcclusionStageParameters,
+					figureDestDir.Subdirectory("material-sets").Subdirectory(conf.name),
+					figureDestDir.Subdirectory("scattering").Subdirectory(conf.name));
+				return graph.AddSerialized(figureName + "/" + conf.name, "material-set", () => stage.Run(() => {
+					GetFigureDumper().DumpMaterialSet(settings, textureProcessor, figureDestDir, conf);
+				}, textureProcessor.RegisterCompletionAction), recipeJobs);
+			})
+			.ToArray();
+
+		var shapeDependencies = recipeJobs.Concat(materialSetJobs).ToArray();
+
+		if (figureConf.IsPrimary) {
+			var stage = MakeStage("base-shape", figureManifestsDir.File("base-shape.json"), settings.OcclusionStageParameters,
+				figureDestDir.File("channel-inputs.dat"),
+				figureDestDir.File("parent-overrides.dat"),
+				figureDestDir.Subdirectory("occlusion"));
+			graph.AddSerialized(figureName, "base-shape", () => stage.Run(() => {
+				GetFigureDumper().DumpBaseShape(figureDestDir);
+			}), shapeDependencies);
+		}
+
+		var generatedTexturesDir = CommonPaths.WorkDir.Subdirectory("generated-textures");
+		foreach (var conf in shapeImportConfigurations) {
+			graph.AddSerialized(figureName + "/" + conf.name, "shape", () => {
+				var generatedNormalMaps = generatedTexturesDir.Exists ?
+					generatedTexturesDir.GetFiles($"normal-map-{conf.name}-*.png") :
+					new FileInfo[0];
+				var stage = MakeStage("shape", figureManifestsDir.Subdirectory("shapes").File(conf.name + ".json"), JsonConvert.SerializeObject(conf) + settings.OcclusionStageParameters,
+					new FileSystemInfo[] { figureDestDir.Subdirectory("shapes").Subdirectory(conf.name) }.Concat(generatedNormalMaps).ToArray());
+				stage.Run(() => {
+					GetFigureDumper().DumpShape(textureProcessor, figureDestDir, conf);
+				}, textureProcessor.RegisterCompletionAction);
+			}, shapeDependencies);
+		}
+
+		return true;
 	}
 }
@@ -1,51 +1,255 @@
 using System;
+using System.Collections.Generic;
+using System.Diagnostics;
 using System.IO;
 using System.IO.MemoryMappedFiles;
 using System.Linq;
+using System.Security.Cryptography;
+using System.Threading.Tasks;
 
+public class ArchivePackerStatistics {
+	public int FileCount { get; }
+	public int BlobCount { get; }
+	public int ReusedBlobCount { get; }
+	public long TotalBytes { get; }
+	public long StoredBytes { get; }
+	public long ReusedBytes { get; }
+	public TimeSpan ScanTime { get; }
+	public TimeSpan WriteTime { get; }
+
+	public ArchivePackerStatistics(int fileCount, int blobCount, int reusedBlobCount, long totalBytes, long storedBytes, long reusedBytes, TimeSpan scanTime, TimeSpan writeTime) {
+		FileCount = fileCount;
+		BlobCount = blobCount;
+		ReusedBlobCount = reusedBlobCount;
+		TotalBytes = totalBytes;
+		StoredBytes = storedBytes;
+		ReusedBytes = reusedBytes;
+		ScanTime = scanTime;
+		WriteTime = writeTime;
+	}
+
+	public int DuplicateFileCount => FileCount - BlobCount;
+	public long DeduplicatedBytes => TotalBytes - StoredBytes;
+	public TimeSpan TotalTime => ScanTime + WriteTime;
+
+	public double MegabytesPerSecond => TotalBytes / (1024.0 * 1024.0) / Math.Max(TotalTime.TotalSeconds, 1e-6);
+
+	public override string ToString() {
+		return String.Format("{0} files, {1} unique blobs ({2} duplicates, {3} reused from previous archive); {4:F1} MB in, {5:F1} MB stored ({6:F1} MB deduplicated, {7:F1} MB reused); scan {8:F0} ms, write {9:F0} ms, {10:F1} MB/s",
+			FileCount, BlobCount, DuplicateFileCount, ReusedBlobCount,
+			TotalBytes / (1024.0 * 1024.0), StoredBytes / (1024.0 * 1024.0), DeduplicatedBytes / (1024.0 * 1024.0), ReusedBytes / (1024.0 * 1024.0),
+			ScanTime.TotalMilliseconds, WriteTime.TotalMilliseconds, MegabytesPerSecond);
+	}
+}
+
+/**
+ * Packs a directory tree into a single archive file.
+ *
+ * Files with identical contents are stored only once: the listing contains one record per file, but records for
+ * duplicate files share the same payload offset. Only files which have the same size as another file are hashed
+ * and hashing and copying are both spread across multiple threads.
+ *
+ * In incremental mode, files whose size and timestamp match the listing of the existing archive are block-copied
+ * from that archive instead of being re-read from the source tree.
+ */
 public class ArchivePacker {
 	private const long HeaderSize = sizeof(long) + sizeof(long);
 	private const long OffsetGranularity = 0x1000;
 
-	private long currentOffset = 0;
+	private class ScannedFile {
+		public FileInfo Info { get; }
+		public long Size { get; }
+		public long LastWriteTime { get; }
+		public PackedArchiveFileRecord PreviousRecord { get; }
+		public string Hash { get; set; }
+		public Blob Blob { get; set; }
 
-	private PackedArchiveFileRecord ScanFile(FileInfo file) {
-		string name = file.Name;
-		long offset = currentOffset;
-		long size = file.Length;
-		
-		IncrementOffset(size);
+		public ScannedFile(FileInfo info, PackedArchiveFileRecord previousRecord) {
+			Info = info;
+			Size = info.Length;
+			LastWriteTime = info.LastWriteTimeUtc.Ticks;
 
-		return new PackedArchiveFileRecord(name, offset, size);
+			if (previousRecord != null && previousRecord.Size == Size && previousRecord.LastWriteTime == LastWriteTime) {
+				PreviousRecord = previousRecord;
+				Hash = previousRecord.Hash;
+			}
+		}
+	}
+
+	private class Blob {
+		public ScannedFile Source { get; }
+		public long Offset { get; }
+
+		public Blob(ScannedFile source, long offset) {
+			Source = source;
+			Offset = offset;
+		}
 	}
 
-	private void IncrementOffset(long size) {
-		currentOffset = IntegerUtils.NextLargerMultiple(currentOffset + size, OffsetGranularity);
+	private class ScannedDirectory {
+		public string Name { get; }
+		public ScannedDirectory[] Subdirectories { get; }
+		public ScannedFile[] Files { get; }
+
+		public ScannedDirectory(string name, ScannedDirectory[] subdirectories, ScannedFile[] files) {
+			Name = name;
+			Subdirectories = subdirectories;
+			Files = files;
+		}
 	}
 
-	private PackedArchiveDirectoryRecord ScanDirectory(DirectoryInfo dir) {
+	//state of a single pack, so that a packer can be reused
+	private class PackContext {
+		public PackedArchive PreviousArchive { get; }
+		public List<ScannedFile> AllFiles { get; } = new List<ScannedFile>();
+		public List<Blob> Blobs { get; } = new List<Blob>();
+		public long CurrentOffset { get; private set; } = 0;
+
+		public PackContext(PackedArchive previousArchive) {
+			PreviousArchive = previousArchive;
+		}
+
+		public void IncrementOffset(long size) {
+			CurrentOffset = IntegerUtils.NextLargerMultiple(CurrentOffset + size, OffsetGranularity);
+		}
+	}
+
+	private readonly bool deduplicate;
+	private readonly int maxDegreeOfParallelism;
+
+	public ArchivePacker(bool deduplicate = true, int maxDegreeOfParallelism = -1) {
+		this.deduplicate = deduplicate;
+		this.maxDegreeOfParallelism = maxDegreeOfParallelism > 0 ? maxDegreeOfParallelism : Environment.ProcessorCount;
+	}
+
+	private static ScannedDirectory ScanDirectory(PackContext context, DirectoryInfo dir, PackedArchiveDirectoryRecord previousRecord) {
 		string name = dir.Name;
 
 		var subdirectories = dir.GetDirectories()
-			.Select(subDir => ScanDirectory(subDir))
+			.Select(subDir => ScanDirectory(context, subDir, previousRecord?.Subdirectories.FirstOrDefault(record => record.Name == subDir.Name)))
 			.ToArray();
 
+		var previousFileRecords = previousRecord?.Files.ToDictionary(record => record.Name);
 		var files = dir.GetFiles()
-			.Select(file => ScanFile(file))
+			.Select(file => {
+				PackedArchiveFileRecord previousFileRecord = null;
+				previousFileRecords?.TryGetValue(file.Name, out previousFileRecord);
+				return new ScannedFile(file, previousFileRecord);
+			})
+			.ToArray();
+		context.AllFiles.AddRange(files);
+
+		return new ScannedDirectory(name, subdirectories, files);
+	}
+
+	private static string HashFile(FileInfo file) {
+		using (var sha = SHA256.Create()) {
+			using (var stream = file.OpenRead()) {
+				return Convert.ToBase64String(sha.ComputeHash(stream));
+			}
+		}
+	}
+
+	private void HashCandidateDuplicates(PackContext context) {
+		//only files that share a size with some other file can possibly be duplicates
+		var candidates = context.AllFiles
+			.GroupBy(file => file.Size)
+			.Where(group => group.Key > 0 && group.Count() > 1)
+			.SelectMany(group => group)
+			.Where(file => file.Hash == null)
 			.ToArray();
 
-		return new PackedArchiveDirectoryRecord(name, subdirectories, files);
+		var parallelOptions = new ParallelOptions { MaxDegreeOfParallelism = maxDegreeOfParallelism };
+		Parallel.ForEach(candidates, parallelOptions, file => {
+			file.Hash = HashFile(file.Info);
+		});
 	}
-	
-	public void Pack(FileInfo archiveFile, DirectoryInfo rootDir) {
-		var rootRecord = ScanDirectory(rootDir);
 
+	private static void AssignBlobs(PackContext context) {
+		var blobsByContent = new Dictionary<(long, string), Blob>();
+
+		//assign offsets in scan order so the layout matches the non-deduplicated packer
+		foreach (var file in context.AllFiles) {
+			if (file.Hash != null && blobsByContent.TryGetValue((file.Size, file.Hash), out var existingBlob)) {
+				file.Blob = existingBlob;
+				continue;
+			}
+
+			var blob = new Blob(file, context.CurrentOffset);
+			context.IncrementOffset(file.Size);
+			context.Blobs.Add(blob);
+			file.Blob = blob;
+
+			if (file.Hash != null) {
+				blobsByContent.Add((file.Size, file.Hash), blob);
+			}
+		}
+	}
+
+	private static PackedArchiveDirectoryRecord MakeRecord(ScannedDirectory dir) {
+		var subdirectories = dir.Subdirectories
+			.Select(subDir => MakeRecord(subDir))
+			.ToArray();
+
+		var files = dir.Files
+			.Select(file => new PackedArchiveFileRecord(file.Info.Name, file.Blob.Offset, file.Size, file.LastWriteTime, file.Hash))
+			.ToArray();
+
+		return new PackedArchiveDirectoryRecord(dir.Name, subdirectories, files);
+	}
+
+	/**
+	 * Packs rootDir into archiveFile, reusing unchanged contents from archiveFile if it already exists. The new archive
+	 * is written to a temporary file which then atomically replaces the old one.
+	 */
+	public ArchivePackerStatistics PackIncremental(FileInfo archiveFile, DirectoryInfo rootDir) {
+		if (!archiveFile.Exists) {
+			return Pack(archiveFile, rootDir);
+		}
+
+		var tempFile = new FileInfo(archiveFile.FullName + ".tmp");
+		ArchivePackerStatistics statistics;
+		try {
+			using (var previousArchive = new PackedArchive(archiveFile)) {
+				statistics = Pack(new PackContext(previousArchive), tempFile, rootDir);
+			}
+
+			//swap in the new archive atomically, so that an interrupted pack never leaves no archive at all
+			File.Replace(tempFile.FullName, archiveFile.FullName, null);
+		} catch {
+			//don't leave a partial archive behind
+			tempFile.Refresh();
+			if (tempFile.Exists) {
+				tempFile.Delete();
+			}
+			throw;
+		}
+		archiveFile.Refresh();
+
+		return statistics;
+	}
+
+	public ArchivePackerStatistics Pack(FileInfo archiveFile, DirectoryInfo rootDir) {
+		return Pack(new PackContext(null), archiveFile, rootDir);
+	}
+
+	private ArchivePackerStatistics Pack(PackContext context, FileInfo archiveFile, DirectoryInfo rootDir) {
+		var scanStopwatch = Stopwatch.StartNew();
+		var rootDirectory = ScanDirectory(context, rootDir, context.PreviousArchive?.RootRecord);
+		if (deduplicate) {
+			HashCandidateDuplicates(context);
+		}
+		AssignBlobs(context);
+		var rootRecord = MakeRecord(rootDirectory);
+		scanStopwatch.Stop();
+
+		var writeStopwatch = Stopwatch.StartNew();
 		var memoryStream = new MemoryStream();
 		Persistance.Write(memoryStream, rootRecord);
 		var listingBytes = memoryStream.ToArray();
 		long listingSize = listingBytes.LongLength;
-		
-		long payloadSize = currentOffset;
+
+		long payloadSize = context.CurrentOffset;
 		long payloadOffset = IntegerUtils.NextLargerMultiple(HeaderSize + listingSize, OffsetGranularity);
 
 		long totalSize = payloadOffset + payloadSize;
@@ -62,26 +266,44 @@ public class ArchivePacker {
 				listingAccessor.WriteArray(0, listingBytes, 0, listingBytes.Length);
 			}
 
-			WriteDirectory(archiveMap, payloadOffset, rootRecord, rootDir);
+			//write blobs; each blob has its own disjoint view so reads and writes of different blobs overlap freely
+			var parallelOptions = new ParallelOptions { MaxDegreeOfParallelism = maxDegreeOfParallelism };
+			Parallel.ForEach(context.Blobs, parallelOptions, blob => WriteBlob(context, archiveMap, payloadOffset, blob));
 		}
+		writeStopwatch.Stop();
+
+		var reusedBlobs = context.Blobs.Where(blob => blob.Source.PreviousRecord != null).ToList();
+		return new ArchivePackerStatistics(
+			context.AllFiles.Count,
+			context.Blobs.Count,
+			reusedBlobs.Count,
+			context.AllFiles.Sum(file => file.Size),
+			context.Blobs.Sum(blob => blob.Source.Size),
+			reusedBlobs.Sum(blob => blob.Source.Size),
+			scanStopwatch.Elapsed,
+			writeStopwatch.Elapsed);
 	}
 
-	private void WriteDirectory(MemoryMappedFile archiveMap, long payloadOffset, PackedArchiveDirectoryRecord record, DirectoryInfo dir) {
-		foreach (var subdirRecord in record.Subdirectories) {
-			WriteDirectory(archiveMap, payloadOffset, subdirRecord, dir.Subdirectory(subdirRecord.Name));
+	private static void WriteBlob(PackContext context, MemoryMappedFile archiveMap, long payloadOffset, Blob blob) {
+		var file = blob.Source;
+		if (file.Size == 0) {
+			//CreateViewStream interprets size = 0 as "whole file"
+			return;
 		}
-		foreach (var fileRecord in record.Files) {
-			WriteFile(archiveMap, payloadOffset, fileRecord, dir.File(fileRecord.Name));
-		}
-	}
 
-	private void WriteFile(MemoryMappedFile archiveMap, long payloadOffset, PackedArchiveFileRecord fileRecord, FileInfo file) {
-		Console.WriteLine("packing " + file.Name + "...");
+		long offset = payloadOffset + blob.Offset;
+
+		Stream sourceStream;
+		if (file.PreviousRecord != null) {
+			//unchanged since the previous archive was packed, so block-copy the existing extent
+			sourceStream = context.PreviousArchive.OpenStream(file.PreviousRecord);
+		} else {
+			Console.WriteLine("packing " + file.Info.Name + "...");
+			sourceStream = file.Info.OpenRead();
+		}
 
-		long offset = payloadOffset + fileRecord.Offset;
-		long size = fileRecord.Size;
-		using (var sourceStream = file.OpenRead()) {
-			using (var destStream = archiveMap.CreateViewStream(offset, size)) {
+		using (sourceStream) {
+			using (var destStream = archiveMap.CreateViewStream(offset, file.Size)) {
 				sourceStream.CopyTo(destStream);
 			}
 		}
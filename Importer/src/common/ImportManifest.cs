@@ -0,0 +1,147 @@
+using Newtonsoft.Json;
+using System;
+using System.Collections.Generic;
+using System.IO;
+using System.Linq;
+using System.Security.Cryptography;
+
+/**
+ * Records what an import stage's outputs were produced from: a parameters string and the size, timestamp and hash of
+ * every input file. The stage is up to date while the parameters match, every input still has the same contents, and
+ * every output that was produced still exists.
+ *
+ * Inputs are first compared by size and timestamp, and only hashed if those differ, so checking an unchanged stage
+ * doesn't read its inputs. An input whose timestamp changed but whose hash still matches has its timestamp refreshed,
+ * so that once the manifest is saved again, later checks don't hash it either.
+ */
+public class ImportManifest {
+	public class Input {
+		[JsonProperty("path")]
+		public string Path;
+
+		[JsonProperty("length")]
+		public long Length; //-1 if the file didn't exist
+
+		[JsonProperty("last-write-time")]
+		public long LastWriteTimeUtcTicks;
+
+		[JsonProperty("hash")]
+		public string Hash;
+
+		public static Input Make(FileInfo file) {
+			if (!file.Exists) {
+				return new Input { Path = file.FullName, Length = -1 };
+			}
+
+			return new Input {
+				Path = file.FullName,
+				Length = file.Length,
+				LastWriteTimeUtcTicks = file.LastWriteTimeUtc.Ticks,
+				Hash = ComputeHash(file)
+			};
+		}
+
+		/**
+		 * Returns whether the file still has the recorded contents. isRefreshed is set if it does only by hash, in
+		 * which case the recorded timestamp has been updated to the file's.
+		 */
+		public bool IsUnchanged(out bool isRefreshed) {
+			isRefreshed = false;
+
+			var file = new FileInfo(Path);
+			if (!file.Exists) {
+				return Length == -1;
+			}
+
+			if (file.Length != Length) {
+				return false;
+			}
+
+			if (file.LastWriteTimeUtc.Ticks == LastWriteTimeUtcTicks) {
+				return true;
+			}
+
+			if (ComputeHash(file) != Hash) {
+				return false;
+			}
+
+			LastWriteTimeUtcTicks = file.LastWriteTimeUtc.Ticks;
+			isRefreshed = true;
+			return true;
+		}
+	}
+
+	[JsonProperty("parameters")]
+	public string Parameters;
+
+	[JsonProperty("inputs")]
+	public List<Input> Inputs = new List<Input>();
+
+	[JsonProperty("outputs")]
+	public List<string> Outputs = new List<string>();
+
+	public static string ComputeHash(FileInfo file) {
+		using (var sha = SHA256.Create())
+		using (var stream = file.OpenRead()) {
+			return BitConverter.ToString(sha.ComputeHash(stream)).Replace("-", "").ToLowerInvariant();
+		}
+	}
+
+	public static ImportManifest Make(string parameters, IEnumerable<string> inputPaths, IEnumerable<FileSystemInfo> outputs) {
+		return new ImportManifest {
+			Parameters = parameters,
+			Inputs = inputPaths.Select(path => Input.Make(new FileInfo(path))).ToList(),
+			Outputs = outputs
+				.Where(output => File.Exists(output.FullName) || Directory.Exists(output.FullName))
+				.Select(output => output.FullName)
+				.ToList()
+		};
+	}
+
+	/**
+	 * Returns null if the file doesn't exist or can't be parsed, which leaves the stage out of date.
+	 */
+	public static ImportManifest Load(FileInfo file) {
+		if (!file.Exists) {
+			return null;
+		}
+
+		try {
+			return JsonConvert.DeserializeObject<ImportManifest>(file.ReadAllText());
+		} catch (JsonException) {
+			return null;
+		}
+	}
+
+	public void Save(FileInfo file) {
+		file.Directory.CreateWithParents();
+
+		//write then rename so that an interrupted import can't leave a truncated manifest
+		var tempFile = new FileInfo(file.FullName + ".tmp");
+		tempFile.WriteAllText(JsonConvert.SerializeObject(this, Formatting.Indented));
+		if (file.Exists) {
+			file.Delete();
+		}
+		tempFile.MoveTo(file.FullName);
+	}
+
+	/**
+	 * Returns whether the stage is up to date. hasRefreshedInputs is set if any input's timestamp was refreshed, in
+	 * which case the manifest should be saved again.
+	 */
+	public bool IsUpToDate(string parameters, out bool hasRefreshedInputs) {
+		hasRefreshedInputs = false;
+
+		if (Parameters != parameters || !Outputs.All(path => File.Exists(path) || Directory.Exists(path))) {
+			return false;
+		}
+
+		foreach (var input in Inputs) {
+			if (!input.IsUnchanged(out bool isRefreshed)) {
+				return false;
+			}
+			hasRefreshedInputs |= isRefreshed;
+		}
+		return true;
+	}
+}
@@ -0,0 +1,85 @@
+using System;
+using System.Collections.Generic;
+using System.IO;
+
+/**
+ * An import stage whose outputs are only regenerated when its manifest says they are out of date.
+ *
+ * The importer's dumpers skip outputs that already exist, so a stage that is out of date first deletes its outputs
+ * and manifest, then runs, then records a new manifest.
+ */
+public class IncrementalStage {
+	private readonly FileInfo manifestFile;
+	private readonly string parameters;
+	private readonly FileSystemInfo[] outputs;
+
+	public IncrementalStage(FileInfo manifestFile, string parameters, params FileSystemInfo[] outputs) {
+		this.manifestFile = manifestFile;
+		this.parameters = parameters;
+		this.outputs = outputs;
+	}
+
+	public bool IsUpToDate() {
+		var manifest = ImportManifest.Load(manifestFile);
+		if (manifest == null || !manifest.IsUpToDate(parameters, out bool hasRefreshedInputs)) {
+			return false;
+		}
+
+		//inputs that were only matched by hash, such as after a checkout, aren't hashed again next time
+		if (hasRefreshedInputs) {
+			manifest.Save(manifestFile);
+		}
+		return true;
+	}
+
+	public void Invalidate() {
+		manifestFile.Refresh();
+		if (manifestFile.Exists) {
+			manifestFile.Delete();
+		}
+
+		foreach (var output in outputs) {
+			if (Directory.Exists(output.FullName)) {
+				Directory.Delete(output.FullName, true);
+			} else if (File.Exists(output.FullName)) {
+				File.Delete(output.FullName);
+			}
+			output.Refresh();
+		}
+	}
+
+	public void Complete(IEnumerable<string> inputPaths) {
+		foreach (var output in outputs) {
+			output.Refresh();
+		}
+		ImportManifest.Make(parameters, inputPaths, outputs).Save(manifestFile);
+	}
+
+	/**
+	 * Runs the action unless the stage is up to date, recording the files it reads as the stage's inputs. Returns
+	 * whether the action ran.
+	 *
+	 * If the action leaves some outputs to be written later, deferCompletion is given the step which writes the
+	 * manifest, to run once they have been.
+	 */
+	public bool Run(Action action, Action<Action> deferCompletion = null) {
+		if (IsUpToDate()) {
+			return false;
+		}
+
+		Invalidate();
+
+		List<string> inputPaths;
+		using (var recorder = InputRecorder.Start()) {
+			action();
+			inputPaths = recorder.Paths;
+		}
+
+		if (deferCompletion != null) {
+			deferCompletion(() => Complete(inputPaths));
+		} else {
+			Complete(inputPaths);
+		}
+		return true;
+	}
+}
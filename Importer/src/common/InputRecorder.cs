@@ -0,0 +1,60 @@
+using System;
+using System.Collections.Generic;
+using System.IO;
+using System.Linq;
+using System.Runtime.Remoting.Messaging;
+
+/**
+ * Records the files read while an import stage runs, so that the stage's manifest can list them as inputs.
+ *
+ * The active recorder is stored in the logical call context, so files read by tasks the stage starts are recorded
+ * too. Recorders nest: a file is recorded by every recorder that is active when it's read.
+ */
+public class InputRecorder : IDisposable {
+	private const string SlotName = "InputRecorder";
+
+	private static InputRecorder Current => (InputRecorder) CallContext.LogicalGetData(SlotName);
+
+	public static InputRecorder Start() {
+		var recorder = new InputRecorder(Current);
+		CallContext.LogicalSetData(SlotName, recorder);
+		return recorder;
+	}
+
+	public static void Record(FileInfo file) {
+		RecordAll(new [] { file.FullName });
+	}
+
+	public static void RecordAll(IEnumerable<string> paths) {
+		var recorder = Current;
+		if (recorder == null) {
+			return;
+		}
+
+		var pathList = paths.ToList();
+		for (; recorder != null; recorder = recorder.parent) {
+			lock (recorder.paths) {
+				recorder.paths.UnionWith(pathList);
+			}
+		}
+	}
+
+	private readonly InputRecorder parent;
+	private readonly HashSet<string> paths = new HashSet<string>(StringComparer.OrdinalIgnoreCase);
+
+	private InputRecorder(InputRecorder parent) {
+		this.parent = parent;
+	}
+
+	public void Dispose() {
+		CallContext.LogicalSetData(SlotName, parent);
+	}
+
+	public List<string> Paths {
+		get {
+			lock (paths) {
+				return paths.OrderBy(path => path, StringComparer.OrdinalIgnoreCase).ToList();
+			}
+		}
+	}
+}
@@ -0,0 +1,206 @@
+using System;
+using System.Collections.Generic;
+using System.Diagnostics;
+using System.Linq;
+using System.Threading;
+
+public class JobGraphStatistics {
+	public int JobCount { get; }
+	public TimeSpan WallTime { get; }
+	public IReadOnlyDictionary<string, TimeSpan> TimeByStage { get; }
+
+	public JobGraphStatistics(int jobCount, TimeSpan wallTime, IReadOnlyDictionary<string, TimeSpan> timeByStage) {
+		JobCount = jobCount;
+		WallTime = wallTime;
+		TimeByStage = timeByStage;
+	}
+
+	public TimeSpan TotalJobTime => TimeSpan.FromTicks(TimeByStage.Values.Sum(time => time.Ticks));
+
+	/**
+	 * Combines the statistics of graphs that ran one after another.
+	 */
+	public static JobGraphStatistics Combine(IEnumerable<JobGraphStatistics> statistics) {
+		var list = statistics.ToList();
+		var timeByStage = list
+			.SelectMany(entry => entry.TimeByStage)
+			.GroupBy(entry => entry.Key)
+			.ToDictionary(group => group.Key, group => TimeSpan.FromTicks(group.Sum(entry => entry.Value.Ticks)));
+		return new JobGraphStatistics(
+			list.Sum(entry => entry.JobCount),
+			TimeSpan.FromTicks(list.Sum(entry => entry.WallTime.Ticks)),
+			timeByStage);
+	}
+
+	public override string ToString() {
+		var stages = TimeByStage.Select(entry => $"{entry.Key} {entry.Value.TotalSeconds:F1}s");
+		return String.Format("{0} jobs in {1:F1}s wall time ({2:F1}s job time: {3})",
+			JobCount, WallTime.TotalSeconds, TotalJobTime.TotalSeconds, String.Join(", ", stages));
+	}
+}
+
+/**
+ * Runs a set of jobs on a bounded pool of worker threads, starting each job once all of its dependencies have
+ * finished. Jobs are added after their dependencies, so the graph can't contain cycles.
+ *
+ * Serialized jobs never run concurrently with each other, which is used for jobs that share the device's immediate
+ * context. When several jobs are ready, the one furthest along its chain of dependencies runs first so that
+ * intermediate results are consumed before more are produced.
+ */
+public class JobGraph {
+	public class Job {
+		public string Name { get; }
+		public string Stage { get; }
+		public bool IsSerialized { get; }
+		public int Depth { get; }
+		internal Action Action { get; }
+		internal List<Job> Dependents { get; } = new List<Job>();
+		internal int RemainingDependencyCount { get; set; }
+		internal TimeSpan Elapsed { get; set; }
+
+		public Job(string name, string stage, bool isSerialized, Action action, Job[] dependencies) {
+			Name = name;
+			Stage = stage;
+			IsSerialized = isSerialized;
+			Depth = dependencies.Length == 0 ? 0 : dependencies.Max(dependency => dependency.Depth) + 1;
+			Action = action;
+			RemainingDependencyCount = dependencies.Length;
+		}
+	}
+
+	private readonly List<Job> jobs = new List<Job>();
+	private readonly List<Job> readyJobs = new List<Job>();
+	private bool serializedJobRunning;
+	private int remainingJobCount;
+	private Exception failure;
+
+	public Job Add(string name, string stage, Action action, params Job[] dependencies) {
+		return Add(name, stage, false, action, dependencies);
+	}
+
+	public Job AddSerialized(string name, string stage, Action action, params Job[] dependencies) {
+		return Add(name, stage, true, action, dependencies);
+	}
+
+	private Job Add(string name, string stage, bool isSerialized, Action action, Job[] dependencies) {
+		var job = new Job(name, stage, isSerialized, action, dependencies);
+		foreach (var dependency in dependencies) {
+			dependency.Dependents.Add(job);
+		}
+		jobs.Add(job);
+		return job;
+	}
+
+	public int Count => jobs.Count;
+
+	/**
+	 * Runs all jobs and returns once they have finished. If a job throws, no further jobs are started and the
+	 * exception is rethrown once the running ones have finished. With maxDegreeOfParallelism = 1, jobs run one at a
+	 * time on the calling thread.
+	 */
+	public JobGraphStatistics Run(int maxDegreeOfParallelism = -1) {
+		int workerCount = maxDegreeOfParallelism > 0 ? maxDegreeOfParallelism : Environment.ProcessorCount;
+
+		var stopwatch = Stopwatch.StartNew();
+
+		remainingJobCount = jobs.Count;
+		readyJobs.AddRange(jobs.Where(job => job.RemainingDependencyCount == 0));
+
+		if (workerCount == 1) {
+			RunWorker();
+		} else {
+			var workers = Enumerable.Range(0, workerCount)
+				.Select(idx => new Thread(RunWorker) {
+					Name = "JobGraph worker " + idx,
+					IsBackground = true
+				})
+				.ToList();
+			workers.ForEach(worker => worker.Start());
+			workers.ForEach(worker => worker.Join());
+		}
+
+		stopwatch.Stop();
+
+		if (failure != null) {
+			throw new InvalidOperationException("job failed: " + failure.Message, failure);
+		}
+
+		var timeByStage = jobs
+			.GroupBy(job => job.Stage)
+			.ToDictionary(group => group.Key, group => TimeSpan.FromTicks(group.Sum(job => job.Elapsed.Ticks)));
+		return new JobGraphStatistics(jobs.Count, stopwatch.Elapsed, timeByStage);
+	}
+
+	private Job TakeRunnableJob() {
+		Job best = null;
+		foreach (var job in readyJobs) {
+			if (job.IsSerialized && serializedJobRunning) {
+				continue;
+			}
+			if (best == null || job.Depth > best.Depth) {
+				best = job;
+			}
+		}
+
+		if (best != null) {
+			readyJobs.Remove(best);
+			if (best.IsSerialized) {
+				serializedJobRunning = true;
+			}
+		}
+
+		return best;
+	}
+
+	private void RunWorker() {
+		while (true) {
+			Job job;
+			lock (readyJobs) {
+				while (true) {
+					if (remainingJobCount == 0 || failure != null) {
+						return;
+					}
+
+					job = TakeRunnableJob();
+					if (job != null) {
+						break;
+					}
+
+					Monitor.Wait(readyJobs);
+				}
+			}
+
+			var stopwatch = Stopwatch.StartNew();
+			Exception jobFailure = null;
+			try {
+				job.Action.Invoke();
+			} catch (Exception e) {
+				jobFailure = e;
+			}
+			stopwatch.Stop();
+
+			lock (readyJobs) {
+				job.Elapsed = stopwatch.Elapsed;
+				remainingJobCount -= 1;
+				if (job.IsSerialized) {
+					serializedJobRunning = false;
+				}
+
+				if (jobFailure != null) {
+					if (failure == null) {
+						failure = jobFailure;
+					}
+				} else {
+					foreach (var dependent in job.Dependents) {
+						dependent.RemainingDependencyCount -= 1;
+						if (dependent.RemainingDependencyCount == 0) {
+							readyJobs.Add(dependent);
+						}
+					}
+				}
+
+				Monitor.PulseAll(readyJobs);
+			}
+		}
+	}
+}
@@ -0,0 +1,88 @@
+using Newtonsoft.Json;
+using System.Collections.Generic;
+using System.IO;
+using System.Linq;
+
+/**
+ * A saved copy of ContentFileLocator's path index, kept per content package so that only packages that changed since
+ * the last run need to be scanned again.
+ *
+ * A package with a manifest is unchanged while its manifest is (compared by size and timestamp, then by hash). A package
+ * without one is unchanged while none of its directories' timestamps have changed, since adding, removing or renaming a
+ * file updates the timestamp of the directory containing it.
+ */
+public class ContentFileIndexCache {
+	public const int CurrentVersion = 1;
+
+	public class Package {
+		[JsonProperty("manifest")]
+		public ImportManifest.Input Manifest; //null if the package has no manifest
+
+		[JsonProperty("directory-write-times")]
+		public Dictionary<string, long> DirectoryWriteTimes; //relative directory path to timestamp, if there's no manifest
+
+		[JsonProperty("files")]
+		public Dictionary<string, string> Files; //content path to file path relative to the package directory
+
+		public static Dictionary<string, long> GetDirectoryWriteTimes(DirectoryInfo packageDirectory) {
+			return new [] { packageDirectory }
+				.Concat(packageDirectory.GetDirectories("*", SearchOption.AllDirectories))
+				.ToDictionary(
+					directory => directory.FullName.Substring(packageDirectory.FullName.Length),
+					directory => directory.LastWriteTimeUtc.Ticks);
+		}
+
+		/**
+		 * isRefreshed is set if the package's manifest only matched by hash, in which case its recorded timestamp has
+		 * been updated and the cache should be saved again.
+		 */
+		public bool IsUnchanged(DirectoryInfo packageDirectory, FileInfo manifestFile, out bool isRefreshed) {
+			isRefreshed = false;
+			if (Manifest != null) {
+				return Manifest.Path == manifestFile.FullName && Manifest.IsUnchanged(out isRefreshed);
+			}
+
+			if (manifestFile.Exists || DirectoryWriteTimes == null) {
+				return false;
+			}
+
+			var currentWriteTimes = GetDirectoryWriteTimes(packageDirectory);
+			return currentWriteTimes.Count == DirectoryWriteTimes.Count
+				&& currentWriteTimes.All(entry => DirectoryWriteTimes.TryGetValue(entry.Key, out long ticks) && ticks == entry.Value);
+		}
+	}
+
+	[JsonProperty("version")]
+	public int Version = CurrentVersion;
+
+	[JsonProperty("packages")]
+	public Dictionary<string, Package> Packages = new Dictionary<string, Package>();
+
+	/**
+	 * Returns null if the file doesn't exist, can't be parsed or is from another version, so that everything is scanned.
+	 */
+	public static ContentFileIndexCache Load(FileInfo file) {
+		if (!file.Exists) {
+			return null;
+		}
+
+		try {
+			var cache = JsonConvert.DeserializeObject<ContentFileIndexCache>(file.ReadAllText());
+			return cache?.Version == CurrentVersion ? cache : null;
+		} catch (JsonException) {
+			return null;
+		}
+	}
+
+	public void Save(FileInfo file) {
+		file.Directory.CreateWithParents();
+
+		//write then rename so that an interrupted run can't leave a truncated cache
+		var tempFile = new FileInfo(file.FullName + ".tmp");
+		tempFile.WriteAllText(JsonConvert.SerializeObject(this));
+		if (file.Exists) {
+			file.Delete();
+		}
+		tempFile.MoveTo(file.FullName);
+	}
+}
@@ -1,5 +1,6 @@
 using System;
 using System.Collections.Generic;
+using System.Diagnostics;
 using System.IO;
 using System.Xml.Serialization;
 using System.Linq;
@@ -57,22 +58,57 @@ public class ContentFileLocator {
 		}
 	}
 
+	private static readonly FileInfo IndexCacheFile = CommonPaths.WorkDir.File("content-file-index.json");
+
     private readonly Dictionary<string, ContentLocation> contentLocations = new Dictionary<string, ContentLocation>();
 
+	public int PackageCount { get; }
+	public int ScannedPackageCount { get; }
+	public TimeSpan LoadTime { get; }
+
     public ContentFileLocator() {
+		var stopwatch = Stopwatch.StartNew();
+
+		var previousCache = ContentFileIndexCache.Load(IndexCacheFile);
+		var cache = new ContentFileIndexCache();
+		bool hasRefreshedPackages = false;
+
         foreach (DirectoryInfo contentPackageDirectory in DazAssetsDir.GetDirectories()) {
-			ParseManifest(contentPackageDirectory);
+			string productName = contentPackageDirectory.Name;
+			FileInfo manifestFile = contentPackageDirectory.File("Manifest.dsx");
+
+			ContentFileIndexCache.Package package;
+			if (previousCache != null && previousCache.Packages.TryGetValue(productName, out var cachedPackage)
+					&& cachedPackage.IsUnchanged(contentPackageDirectory, manifestFile, out bool isRefreshed)) {
+				package = cachedPackage;
+				hasRefreshedPackages |= isRefreshed;
+			} else {
+				package = ScanPackage(contentPackageDirectory, manifestFile);
+				ScannedPackageCount += 1;
+			}
+
+			cache.Packages[productName] = package;
+			foreach (var entry in package.Files) {
+				contentLocations[entry.Key] = new ContentLocation(productName, contentPackageDirectory.File(entry.Value));
+			}
         }
 		ImportPatches(DazAssetPatchesDir);
+
+		PackageCount = cache.Packages.Count;
+		//a manifest that was touched but not changed is only re-hashed once, since its refreshed timestamp is saved
+		if (ScannedPackageCount > 0 || hasRefreshedPackages || previousCache == null || previousCache.Packages.Count != PackageCount) {
+			cache.Save(IndexCacheFile);
+		}
+
+		LoadTime = stopwatch.Elapsed;
     }
     
-    private void ParseManifest(DirectoryInfo contentPackageDirectory) {
-		string productName = contentPackageDirectory.Name;
+    private static ContentFileIndexCache.Package ScanPackage(DirectoryInfo contentPackageDirectory, FileInfo manifestFile) {
+		var files = new Dictionary<string, string>();
 
-        string manifestPath = Path.Combine(contentPackageDirectory.FullName, "Manifest.dsx");
-        
-		if (!File.Exists(manifestPath)) {
-			string directoryPath = contentPackageDirectory.FullName;
+		if (!manifestFile.Exists) {
+			//take the timestamps before listing the files so that a change during the scan invalidates the cache
+			var directoryWriteTimes = ContentFileIndexCache.Package.GetDirectoryWriteTimes(contentPackageDirectory);
 
 			FileInfo[] contentFiles = contentPackageDirectory.GetFiles("*", SearchOption.AllDirectories);
 			foreach (FileInfo contentFile in contentFiles) {
@@ -80,13 +116,23 @@ public class ContentFileLocator {
 				if (!fullPath.StartsWith(contentPackageDirectory.FullName)) {
 					throw new InvalidOperationException("unexpected content file not inside content directory: " + fullPath);
 				}
-				string relativePath = fullPath.Substring(contentPackageDirectory.FullName.Length).Replace("\\", "/").ToLowerInvariant();
-				contentLocations[relativePath] = new ContentLocation(productName, contentFile);
+				string relativePath = fullPath.Substring(contentPackageDirectory.FullName.Length).Replace("\\", "/");
+				files[relativePath.ToLowerInvariant()] = relativePath.TrimStart('/');
 			}
-			return;
+
+			return new ContentFileIndexCache.Package {
+				DirectoryWriteTimes = directoryWriteTimes,
+				Files = files
+			};
 		}
 
-        Manifest manifest = (Manifest)Manifest.Serializer.Deserialize(File.OpenRead(manifestPath));
+		//take the manifest's hash before parsing it so that a change during the scan invalidates the cache
+		var manifestInput = ImportManifest.Input.Make(manifestFile);
+
+		Manifest manifest;
+		using (var stream = manifestFile.OpenRead()) {
+			manifest = (Manifest) Manifest.Serializer.Deserialize(stream);
+		}
 
         foreach (ManifestFile file in manifest.Files) {
             string path = file.Path;
@@ -98,8 +144,13 @@ public class ContentFileLocator {
                 throw new InvalidOperationException("unexpected folder in manifest: " + prefix);
             }
 
-            contentLocations["/" + suffix.ToLowerInvariant()] = new ContentLocation(productName, contentPackageDirectory.File(path));
+            files["/" + suffix.ToLowerInvariant()] = path;
         }
+
+		return new ContentFileIndexCache.Package {
+			Manifest = manifestInput,
+			Files = files
+		};
     }
 
 	private void ImportPatches(DirectoryInfo patchDirectory) {
@@ -117,7 +168,9 @@ public class ContentFileLocator {
 			if (throwIfMissing) {
 	            throw new InvalidOperationException("missing content file: " + path);
 			}
-        }
+        } else {
+			InputRecorder.Record(contentLocation.File);
+		}
         return contentLocation;
     }
 
@@ -0,0 +1,197 @@
+using DsonTypes;
+using Newtonsoft.Json;
+using System;
+using System.Collections.Generic;
+
+/**
+ * Finds where each object in a DSON document's libraries lies in the document's text, without deserializing
+ * anything, so that individual objects can be deserialized on demand.
+ *
+ * Only the top level of the document and the direct properties of each library object are scanned; everything else is
+ * skipped by matching brackets. As with full deserialization, a later object with the same id replaces an earlier one.
+ */
+public static class DsonFragmentIndex {
+	public struct Fragment {
+		public Type Type { get; }
+		public int Start { get; }
+		public int Length { get; }
+
+		public Fragment(Type type, int start, int length) {
+			Type = type;
+			Start = start;
+			Length = length;
+		}
+	}
+
+	private static readonly Dictionary<string, Type> LibraryTypes = new Dictionary<string, Type> {
+		["geometry_library"] = typeof(Geometry),
+		["modifier_library"] = typeof(Modifier),
+		["uv_set_library"] = typeof(UvSet),
+		["node_library"] = typeof(Node),
+		["image_library"] = typeof(Image),
+		["material_library"] = typeof(Material)
+	};
+
+	public static Dictionary<string, Fragment> Build(string text) {
+		var index = new Dictionary<string, Fragment>();
+
+		int pos = SkipWhitespace(text, 0);
+		Expect(text, pos, '{');
+		pos += 1;
+
+		while (true) {
+			pos = SkipWhitespace(text, pos);
+			char c = CharAt(text, pos);
+			if (c == '}') {
+				return index;
+			}
+			if (c == ',') {
+				pos += 1;
+				continue;
+			}
+
+			string key = ReadKey(text, ref pos);
+			if (LibraryTypes.TryGetValue(key, out var type) && CharAt(text, pos) == '[') {
+				pos = IndexLibrary(text, pos, type, index);
+			} else {
+				pos = SkipValue(text, pos);
+			}
+		}
+	}
+
+	private static int IndexLibrary(string text, int pos, Type type, Dictionary<string, Fragment> index) {
+		pos += 1; //skip '['
+
+		while (true) {
+			pos = SkipWhitespace(text, pos);
+			char c = CharAt(text, pos);
+			if (c == ']') {
+				return pos + 1;
+			}
+			if (c == ',') {
+				pos += 1;
+				continue;
+			}
+
+			int start = pos;
+			string id = c == '{' ? FindId(text, pos) : null;
+			pos = SkipValue(text, pos);
+			if (id != null) {
+				index[id] = new Fragment(type, start, pos - start);
+			}
+		}
+	}
+
+	/**
+	 * Returns the value of the "id" property of the object starting at pos, or null if it has none.
+	 */
+	private static string FindId(string text, int pos) {
+		pos += 1; //skip '{'
+
+		while (true) {
+			pos = SkipWhitespace(text, pos);
+			char c = CharAt(text, pos);
+			if (c == '}') {
+				return null;
+			}
+			if (c == ',') {
+				pos += 1;
+				continue;
+			}
+
+			string key = ReadKey(text, ref pos);
+			if (key == "id" && CharAt(text, pos) == '"') {
+				int end = SkipString(text, pos);
+				return DecodeString(text, pos, end);
+			}
+			pos = SkipValue(text, pos);
+		}
+	}
+
+	/**
+	 * Reads a property name and the following colon, leaving pos at the start of the value.
+	 */
+	private static string ReadKey(string text, ref int pos) {
+		Expect(text, pos, '"');
+		int end = SkipString(text, pos);
+		string key = DecodeString(text, pos, end);
+
+		pos = SkipWhitespace(text, end);
+		Expect(text, pos, ':');
+		pos = SkipWhitespace(text, pos + 1);
+		return key;
+	}
+
+	private static int SkipValue(string text, int pos) {
+		char c = CharAt(text, pos);
+		if (c == '"') {
+			return SkipString(text, pos);
+		}
+
+		if (c == '{' || c == '[') {
+			int depth = 0;
+			while (true) {
+				c = CharAt(text, pos);
+				if (c == '"') {
+					pos = SkipString(text, pos);
+					continue;
+				}
+				if (c == '{' || c == '[') {
+					depth += 1;
+				} else if (c == '}' || c == ']') {
+					depth -= 1;
+					if (depth == 0) {
+						return pos + 1;
+					}
+				}
+				pos += 1;
+			}
+		}
+
+		//number, true, false or null
+		while (pos < text.Length && ",}] \t\r\n".IndexOf(text[pos]) < 0) {
+			pos += 1;
+		}
+		return pos;
+	}
+
+	private static int SkipString(string text, int pos) {
+		pos += 1; //skip opening quote
+		while (true) {
+			char c = CharAt(text, pos);
+			if (c == '"') {
+				return pos + 1;
+			}
+			pos += c == '\\' ? 2 : 1;
+		}
+	}
+
+	private static string DecodeString(string text, int start, int end) {
+		string quoted = text.Substring(start, end - start);
+		if (quoted.IndexOf('\\') < 0) {
+			return quoted.Substring(1, quoted.Length - 2);
+		}
+		return JsonConvert.DeserializeObject<string>(quoted);
+	}
+
+	private static int SkipWhitespace(string text, int pos) {
+		while (pos < text.Length && Char.IsWhiteSpace(text[pos])) {
+			pos += 1;
+		}
+		return pos;
+	}
+
+	private static char CharAt(string text, int pos) {
+		if (pos >= text.Length) {
+			throw new InvalidOperationException("unexpected end of DSON document");
+		}
+		return text[pos];
+	}
+
+	private static void Expect(string text, int pos, char expected) {
+		char c = CharAt(text, pos);
+		if (c != expected) {
+			throw new InvalidOperationException($"malformed DSON document: expected '{expected}' at offset {pos} but found '{c}'");
+		}
+	}
+}
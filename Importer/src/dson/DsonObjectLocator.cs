@@ -1,75 +1,152 @@
 using DsonTypes;
 using System;
+using System.Collections.Concurrent;
 using System.Collections.Generic;
 using System.Linq;
+using System.Threading;
 
-public class DsonObjectLocator {
-    private class FragmentCollection {
-		private DsonDocument doc;
-        private Dictionary<string, DsonObject> fragments;
-
-        public static FragmentCollection FillFrom(DsonDocument doc) {
-			DsonRoot root = doc.Root;
-            Dictionary<string, DsonObject> fragments = new Dictionary<string, DsonObject>();
-            foreach (DsonObject obj in Utils.SafeArray(root.geometry_library)) {
-                fragments[obj.id] = obj;
-            }
-            foreach (DsonObject obj in Utils.SafeArray(root.modifier_library)) {
-                fragments[obj.id] = obj;
-            }
-            foreach (DsonObject obj in Utils.SafeArray(root.uv_set_library)) {
-                fragments[obj.id] = obj;
-            }
-            foreach (DsonObject obj in Utils.SafeArray(root.node_library)) {
-                fragments[obj.id] = obj;
-            }
-            foreach (DsonObject obj in Utils.SafeArray(root.image_library)) {
-                fragments[obj.id] = obj;
-            }
-			foreach (DsonObject obj in Utils.SafeArray(root.material_library)) {
-                fragments[obj.id] = obj;
-            }
-            return new FragmentCollection(doc, fragments);
-        }
+/**
+ * Counts the work done loading DSON documents, so that parse time and memory use can be reported after an import.
+ */
+public class DsonObjectLocatorStatistics {
+	private int documentCount;
+	private int textLoadCount;
+	private int rootCount;
+	private int fragmentCount;
+	private int evictionCount;
+	private long readTicks;
+	private long indexTicks;
+	private long deserializeTicks;
+	private long peakCachedSize;
 
-        private FragmentCollection(DsonDocument doc, Dictionary<string, DsonObject> fragments) {
-			this.doc = doc;
-            this.fragments = fragments;
-        }
+	public int DocumentCount => documentCount;
+	public int TextLoadCount => textLoadCount;
+	public int RootCount => rootCount;
+	public int FragmentCount => fragmentCount;
+	public int EvictionCount => evictionCount;
+	public TimeSpan ReadTime => TimeSpan.FromTicks(Interlocked.Read(ref readTicks));
+	public TimeSpan IndexTime => TimeSpan.FromTicks(Interlocked.Read(ref indexTicks));
+	public TimeSpan DeserializeTime => TimeSpan.FromTicks(Interlocked.Read(ref deserializeTicks));
+	public long PeakCachedSize => Interlocked.Read(ref peakCachedSize);
 
-		public DsonDocument Root => doc;
+	internal void NoteDocument() {
+		Interlocked.Increment(ref documentCount);
+	}
+
+	internal void NoteRead(TimeSpan elapsed) {
+		Interlocked.Increment(ref textLoadCount);
+		Interlocked.Add(ref readTicks, elapsed.Ticks);
+	}
+
+	internal void NoteIndex(TimeSpan elapsed) {
+		Interlocked.Add(ref indexTicks, elapsed.Ticks);
+	}
+
+	internal void NoteDeserialize(TimeSpan elapsed, bool isRoot) {
+		if (isRoot) {
+			Interlocked.Increment(ref rootCount);
+		} else {
+			Interlocked.Increment(ref fragmentCount);
+		}
+		Interlocked.Add(ref deserializeTicks, elapsed.Ticks);
+	}
+
+	internal void NoteEviction() {
+		Interlocked.Increment(ref evictionCount);
+	}
+
+	internal void NoteCachedSize(long cachedSize) {
+		long peak;
+		do {
+			peak = Interlocked.Read(ref peakCachedSize);
+		} while (cachedSize > peak && Interlocked.CompareExchange(ref peakCachedSize, cachedSize, peak) != peak);
+	}
+
+	public override string ToString() {
+		return String.Format("{0} documents ({1} text loads, {2} full parses, {3} fragment parses, {4} evictions); " +
+			"read {5:F1}s, index {6:F1}s, deserialize {7:F1}s; peak cached {8:F0} MB",
+			DocumentCount, TextLoadCount, RootCount, FragmentCount, EvictionCount,
+			ReadTime.TotalSeconds, IndexTime.TotalSeconds, DeserializeTime.TotalSeconds,
+			PeakCachedSize / (1024.0 * 1024.0));
+	}
+}
+
+/**
+ * Finds DSON documents and the objects in them by URL.
+ *
+ * Documents parse lazily (see DsonDocument). The memory held by cached documents is kept under a budget by evicting
+ * the least recently used ones.
+ */
+public class DsonObjectLocator {
+	public const long DefaultCacheBudget = 2L * 1024 * 1024 * 1024;
 
-        public DsonObject Locate(string id) {
-            fragments.TryGetValue(id, out DsonObject obj);
-            return obj;
-        }
-    }
-	
 	private readonly ContentFileLocator fileLocator;
-    private readonly Dictionary<string, FragmentCollection> documentCache = new Dictionary<string, FragmentCollection>();
+	private readonly long cacheBudget;
 
-    public DsonObjectLocator(ContentFileLocator fileLocator) {
-        this.fileLocator = fileLocator;
-    }
+	//documents are created once per path so that concurrent import jobs asking for the same document share its state
+	private readonly ConcurrentDictionary<string, DsonDocument> documentCache = new ConcurrentDictionary<string, DsonDocument>();
+
+	//most recently used documents first
+	private readonly LinkedList<DsonDocument> recentlyUsed = new LinkedList<DsonDocument>();
+	private long totalCachedSize;
+
+	public DsonObjectLocatorStatistics Statistics { get; } = new DsonObjectLocatorStatistics();
+
+	public DsonObjectLocator(ContentFileLocator fileLocator, long cacheBudget = DefaultCacheBudget) {
+		this.fileLocator = fileLocator;
+		this.cacheBudget = cacheBudget;
+	}
 	
-	private FragmentCollection LocateCollection(string documentPath, bool throwIfMissing = true) {
-		if (!documentCache.TryGetValue(documentPath, out FragmentCollection fragments)) {
-            var contentFile = fileLocator.Locate(documentPath, throwIfMissing);
-			if (contentFile == null) {
-				return null;
+	private DsonDocument LocateDocument(string documentPath, bool throwIfMissing = true) {
+		//always locate the file, even if the document is cached, so that the lookup is recorded as an input
+		var contentFile = fileLocator.Locate(documentPath, throwIfMissing);
+		if (contentFile == null) {
+			return null;
+		}
+
+		return documentCache.GetOrAdd(documentPath, path => {
+			Statistics.NoteDocument();
+			return new DsonDocument(this, contentFile, path);
+		});
+	}
+
+	/**
+	 * Marks a document as the most recently used, accounts for the change in its cached size, and evicts others if the
+	 * cache is over budget. Called by the document after each access, outside of its own lock.
+	 */
+	internal void NoteUse(DsonDocument document, long cachedSizeChange) {
+		long totalCachedSize = Interlocked.Add(ref this.totalCachedSize, cachedSizeChange);
+		Statistics.NoteCachedSize(totalCachedSize);
+
+		var victims = new List<DsonDocument>();
+		lock (recentlyUsed) {
+			var node = document.CacheEntry;
+			if (node != null) {
+				recentlyUsed.Remove(node);
+				recentlyUsed.AddFirst(node);
+			} else {
+				document.CacheEntry = recentlyUsed.AddFirst(document);
 			}
-			DsonDocument root = DsonDocument.LoadFromFile(this, contentFile, documentPath);
-            fragments = FragmentCollection.FillFrom(root);
 
-            documentCache[documentPath] = fragments;
-        }
+			//never evict the document being used, even if it alone is over budget
+			while (totalCachedSize > cacheBudget && recentlyUsed.Last.Value != document) {
+				var victim = recentlyUsed.Last.Value;
+				recentlyUsed.RemoveLast();
+				victim.CacheEntry = null;
+				totalCachedSize -= victim.CachedSize;
+				victims.Add(victim);
+			}
+		}
 
-		return fragments;
-	} 
+		//evict outside the lock since a document may be busy parsing
+		foreach (var victim in victims) {
+			Interlocked.Add(ref this.totalCachedSize, -victim.Evict());
+			Statistics.NoteEviction();
+		}
+	}
 	
 	public DsonDocument LocateRoot(string documentPath) {
-		FragmentCollection fragments = LocateCollection(documentPath);
-		return fragments.Root;
+		return LocateDocument(documentPath);
 	}
 	
 	public IEnumerable<DsonDocument> GetAllDocumentsUnderPath(string basePath) {
@@ -79,13 +156,13 @@ public class DsonObjectLocator {
     public DsonObject Locate(string url, bool throwIfMissing = true) {
         Uri uri = new Uri("scheme:" + url);
         string documentPath = Uri.UnescapeDataString(uri.AbsolutePath);
-		FragmentCollection fragments = LocateCollection(documentPath, throwIfMissing);
-		if (fragments == null) {
+		DsonDocument document = LocateDocument(documentPath, throwIfMissing);
+		if (document == null) {
 			return null;
 		}
 
         string fragmentId = Uri.UnescapeDataString(uri.Fragment.Substring(1));
-        DsonObject obj = fragments.Locate(fragmentId);
+        DsonObject obj = document.LocateFragment(fragmentId);
         if (obj == null && throwIfMissing) {
 			throw new InvalidOperationException("Couldn't locate fragment in document: " + url);
         }
@@ -1,38 +1,193 @@
 using Newtonsoft.Json;
 using System;
+using System.Collections.Generic;
 using System.ComponentModel;
+using System.Diagnostics;
 using System.IO;
+using System.IO.Compression;
+using System.Text;
+using System.Threading;
 
 namespace DsonTypes {
+	/**
+	 * A DSON document whose objects are deserialized on demand.
+	 *
+	 * The first access reads the document's text and indexes where each library object lies in it. Asking for a single
+	 * object then deserializes only that object's text, and the whole document is deserialized only if Root is used, after
+	 * which the text is dropped.
+	 * The text and deserialized objects can be evicted to save memory and are reloaded transparently when next needed;
+	 * the index is kept.
+	 */
 	public class DsonDocument {
+		//rough ratio between the memory used by deserialized objects and the UTF-16 text they came from
+		private const int DeserializedSizeRatio = 3;
+
+		private readonly ContentFileLocator.ContentLocation contentFile;
+		private readonly JsonSerializer serializer;
+		private readonly object stateLock = new object();
+		private Dictionary<string, DsonFragmentIndex.Fragment> index;
+		private string text;
 		private DsonRoot root;
+		private readonly Dictionary<string, DsonObject> fragments = new Dictionary<string, DsonObject>();
+		private long cachedSize;
 
 		public DsonObjectLocator Locator {get; }
 		public string Product { get; }
 		public string BaseUri {get; }
-		public DsonRoot Root => root;
 
-		private DsonDocument(DsonObjectLocator locator, string product, string documentPath) {
+		public DsonDocument(DsonObjectLocator locator, ContentFileLocator.ContentLocation contentFile, string documentPath) {
 			Locator = locator;
-			Product = product;
+			Product = contentFile.Product;
 			BaseUri = documentPath;
+			this.contentFile = contentFile;
+
+			serializer = JsonSerializer.CreateDefault();
+			serializer.Converters.Add(new DsonObjectReferenceConverter(this));
+		}
+
+		//used by the locator to track recency of use
+		internal LinkedListNode<DsonDocument> CacheEntry { get; set; }
+
+		/**
+		 * Approximate number of bytes held by the document's text and deserialized objects.
+		 */
+		public long CachedSize => Interlocked.Read(ref cachedSize);
+
+		private long AddCachedSize(long change) {
+			Interlocked.Add(ref cachedSize, change);
+			return change;
+		}
+
+		public DsonRoot Root {
+			get {
+				DsonRoot result;
+				long cachedSizeChange = 0;
+				lock (stateLock) {
+					if (root == null) {
+						cachedSizeChange += EnsureText();
+						var stopwatch = Stopwatch.StartNew();
+						root = Deserialize<DsonRoot>(0, text.Length);
+						Locator.Statistics.NoteDeserialize(stopwatch.Elapsed, true);
+
+						//the root replaces any fragments deserialized individually, and the text isn't needed again until eviction
+						long rootSize = (long) text.Length * sizeof(char) * DeserializedSizeRatio;
+						cachedSizeChange += AddCachedSize(rootSize - CachedSize);
+						text = null;
+
+						//share the root's objects so fragments and the root agree, as they did before fragments were lazy
+						fragments.Clear();
+						AddFragments(root.geometry_library);
+						AddFragments(root.modifier_library);
+						AddFragments(root.uv_set_library);
+						AddFragments(root.node_library);
+						AddFragments(root.image_library);
+						AddFragments(root.material_library);
+					}
+					result = root;
+				}
+				Locator.NoteUse(this, cachedSizeChange);
+				return result;
+			}
+		}
+
+		private void AddFragments(DsonObject[] objs) {
+			if (objs == null) {
+				return;
+			}
+			foreach (var obj in objs) {
+				if (obj.id != null) {
+					fragments[obj.id] = obj;
+				}
+			}
+		}
+
+		/**
+		 * Returns the library object with the given id, or null if there isn't one.
+		 */
+		public DsonObject LocateFragment(string id) {
+			DsonObject obj;
+			long cachedSizeChange = 0;
+			lock (stateLock) {
+				if (!fragments.TryGetValue(id, out obj) && root == null) {
+					cachedSizeChange += EnsureIndex();
+					if (index.TryGetValue(id, out var fragment)) {
+						cachedSizeChange += EnsureText();
+						var stopwatch = Stopwatch.StartNew();
+						obj = (DsonObject) Deserialize(fragment.Type, fragment.Start, fragment.Length);
+						Locator.Statistics.NoteDeserialize(stopwatch.Elapsed, false);
+						cachedSizeChange += AddCachedSize((long) fragment.Length * sizeof(char) * DeserializedSizeRatio);
+						fragments[id] = obj;
+					}
+				}
+			}
+			Locator.NoteUse(this, cachedSizeChange);
+			return obj;
+		}
+
+		/**
+		 * Drops the text and deserialized objects, returning the number of bytes freed. Objects already handed out remain
+		 * valid.
+		 */
+		public long Evict() {
+			lock (stateLock) {
+				text = null;
+				root = null;
+				fragments.Clear();
+				return -AddCachedSize(-CachedSize);
+			}
+		}
+
+		//the Ensure methods are called under the state lock and return the change in cached size
+
+		private long EnsureIndex() {
+			if (index != null) {
+				return 0;
+			}
+			long cachedSizeChange = EnsureText();
+			var stopwatch = Stopwatch.StartNew();
+			index = DsonFragmentIndex.Build(text);
+			Locator.Statistics.NoteIndex(stopwatch.Elapsed);
+			return cachedSizeChange;
 		}
-				
-        public static DsonDocument LoadFromFile(DsonObjectLocator locator, ContentFileLocator.ContentLocation contentFile, string documentPath) {
-            using (StreamReader reader = contentFile.File.OpenText()) {
-                using (JsonReader jsonReader = new JsonTextReader(reader)) {
-					DsonDocument document = new DsonDocument(locator, contentFile.Product, documentPath);
 
-					var serializer = JsonSerializer.CreateDefault();
-					serializer.Converters.Add(new DsonObjectReferenceConverter(document));
-					DsonRoot root = serializer.Deserialize<DsonRoot>(jsonReader);
+		private long EnsureText() {
+			if (text != null) {
+				return 0;
+			}
+			var stopwatch = Stopwatch.StartNew();
+			text = ReadText(contentFile.File);
+			Locator.Statistics.NoteRead(stopwatch.Elapsed);
+			return AddCachedSize((long) text.Length * sizeof(char));
+		}
+
+		private object Deserialize(Type type, int start, int length) {
+			using (var reader = new StringReader(start == 0 && length == text.Length ? text : text.Substring(start, length))) {
+				using (JsonReader jsonReader = new JsonTextReader(reader)) {
+					return serializer.Deserialize(jsonReader, type);
+				}
+			}
+		}
 
-					document.root = root;
+		private T Deserialize<T>(int start, int length) {
+			return (T) Deserialize(typeof(T), start, length);
+		}
 
-					return document;
-                }
-            }
-        }
+		/**
+		 * Reads a DSON file, which may be gzip-compressed as DAZ Studio saves them by default.
+		 */
+		public static string ReadText(FileInfo file) {
+			using (var stream = file.OpenRead()) {
+				int first = stream.ReadByte();
+				int second = stream.ReadByte();
+				stream.Position = 0;
+
+				bool isGzipped = first == 0x1f && second == 0x8b;
+				using (var decompressed = isGzipped ? new GZipStream(stream, CompressionMode.Decompress) : (Stream) stream)
+				using (var reader = new StreamReader(decompressed, Encoding.UTF8)) {
+					return reader.ReadToEnd();
+				}
+			}
+		}
 
 		public string ResolveUri(string uri) {
 			if (uri.StartsWith("#")) {
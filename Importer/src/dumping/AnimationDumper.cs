@@ -9,6 +9,7 @@ class AnimationDumper {
 		AnimationDumper dumper = new AnimationDumper(figure, figureDestDir);
 		foreach (FileInfo animationSourceFile in AnimationSourceDirectory.EnumerateFiles("*.dae")) {
 			string animationName = Path.GetFileNameWithoutExtension(animationSourceFile.Name);
+			InputRecorder.Record(animationSourceFile);
 			dumper.Dump(animationName, animationSourceFile);
 		}
 	}
@@ -41,8 +42,8 @@ class AnimationDumper {
 	}
 
 	public void Dump(string name, FileInfo sourceFile) {
-		FileInfo animationFile = animationsDirectory.File(name + ".dat");
-		if (animationFile.Exists) {
+		FileInfo animationFile = animationsDirectory.File(name + Animation.ClipExtension);
+		if (AnimationClip.IsCurrentVersion(animationFile)) {
 			return;
 		}
 
@@ -50,6 +51,6 @@ class AnimationDumper {
 		
 		//persist
 		animationFile.Directory.CreateWithParents();
-		Persistance.Save(animationFile, frameInputs);
+		AnimationClip.Save(animationFile, frameInputs);
     }
 }
@@ -6,7 +6,7 @@ using System.Collections.Generic;
 
 public class ShapeDumper {
 	private readonly ContentFileLocator fileLocator;
-	private readonly Device device;
+	private readonly Device device; //only used to calculate occlusion; null to calculate it on the CPU
 	private readonly ShaderCache shaderCache;
 	private readonly Figure parentFigure;
 	private readonly float[] parentFaceTransparencies;
@@ -155,7 +155,9 @@ public class ShapeDumper {
 
 	public void DumpOcclusionForMaterialSet(DirectoryInfo figureDestDir, string materialSetName) {
 		DirectoryInfo directory = figureDestDir.Subdirectory("material-sets").Subdirectory(materialSetName);
-		float[] faceTransparencies = directory.File("face-transparencies.array").ReadArray<float>();
+		var faceTransparenciesFile = directory.File("face-transparencies.array");
+		InputRecorder.Record(faceTransparenciesFile);
+		float[] faceTransparencies = faceTransparenciesFile.ReadArray<float>();
 		var shapeInputs = figure.MakeDefaultChannelInputs();
 		DumpSimpleOcclusion(directory, shapeInputs, faceTransparencies);
 	}
@@ -1,4 +1,5 @@
 using System;
+using System.IO;
 
 public class FigureRecipeLoader {
 	private readonly ContentFileLocator fileLocator;
@@ -11,14 +12,33 @@ public class FigureRecipeLoader {
 		this.pathManager = pathManager;
 	}
 
-	public FigureRecipe LoadFigureRecipe(string figureName, FigureRecipe parentRecipe) {
-		var importProperties = ImportProperties.Load(pathManager, figureName);
+	//bump this when a change to figure importing would change the recipes, to force them to be reimported
+	public const int RecipeVersion = 1;
+
+	private static readonly DirectoryInfo FigureRecipesDirectory = CommonPaths.WorkDir.Subdirectory("recipes/figures");
+
+	public static FileInfo GetRecipeFile(string figureName) {
+		return FigureRecipesDirectory.File($"{figureName}.dat");
+	}
+
+	/**
+	 * Reimports the figure's recipe if it is missing or any of the DSON files, configuration or parent recipe it was
+	 * imported from have changed. The parent recipe must already be up to date.
+	 */
+	public FileInfo UpdateFigureRecipe(string figureName, FigureRecipe parentRecipe) {
+		var figureRecipeFile = GetRecipeFile(figureName);
+
+		var stage = new IncrementalStage(
+			FigureRecipesDirectory.File($"{figureName}.manifest.json"),
+			$"figure-recipe:{RecipeVersion}",
+			figureRecipeFile);
+		stage.Run(() => {
+			if (parentRecipe != null) {
+				InputRecorder.Record(GetRecipeFile(parentRecipe.Name));
+			}
+
+			var importProperties = ImportProperties.Load(pathManager, figureName);
 
-		var figureRecipesDirectory = CommonPaths.WorkDir.Subdirectory("recipes/figures");
-		figureRecipesDirectory.Create();
-		
-		var figureRecipeFile = figureRecipesDirectory.File($"{figureName}.dat");
-		if (!figureRecipeFile.Exists) {
 			Console.WriteLine($"Reimporting {figureName}...");
 			FigureRecipe recipeToPersist = FigureImporter.ImportFor(
 				figureName,
@@ -29,10 +49,27 @@ public class FigureRecipeLoader {
 				importProperties.HdCorrectionInitialValue,
 				importProperties.VisibleProducts);
 			
+			FigureRecipesDirectory.CreateWithParents();
 			Persistance.Save(figureRecipeFile, recipeToPersist);
-		}
+		});
+
+		return figureRecipeFile;
+	}
+
+	public FigureRecipe LoadFigureRecipe(string figureName, FigureRecipe parentRecipe) {
+		UpdateFigureRecipe(figureName, parentRecipe);
+		return LoadUpdatedFigureRecipe(figureName);
+	}
+
+	/**
+	 * Loads a recipe without checking whether it needs to be reimported. It must already be up to date, for example
+	 * because a job that ran UpdateFigureRecipe has finished; reimporting it here could race with that job.
+	 */
+	public FigureRecipe LoadUpdatedFigureRecipe(string figureName) {
+		var figureRecipeFile = GetRecipeFile(figureName);
 
 		Console.WriteLine($"Loading {figureName}...");
+		InputRecorder.Record(figureRecipeFile);
 		FigureRecipe recipe = Persistance.Load<FigureRecipe>(figureRecipeFile);
 		return recipe;
 	}
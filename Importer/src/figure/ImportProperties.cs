@@ -40,7 +40,9 @@ public class ImportProperties {
 		JsonSerializerSettings settings = new JsonSerializerSettings {
 			MissingMemberHandling = MissingMemberHandling.Error
 		};
-		string json = pathManager.GetConfDirForFigure(figureName).File("import-properties.json").ReadAllText();
+		var file = pathManager.GetConfDirForFigure(figureName).File("import-properties.json");
+		InputRecorder.Record(file);
+		string json = file.ReadAllText();
 		JsonProxy proxy = JsonConvert.DeserializeObject<JsonProxy>(json, settings);
 		UrisJsonProxy urisProxy = proxy.uris;
 		
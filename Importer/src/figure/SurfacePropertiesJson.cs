@@ -34,7 +34,9 @@ public class SurfacePropertiesJson {
 		JsonSerializerSettings settings = new JsonSerializerSettings {
 			MissingMemberHandling = MissingMemberHandling.Error
 		};
-		string json = pathManager.GetConfDirForFigure(figure.Name).File("surface-properties.json").ReadAllText();
+		var file = pathManager.GetConfDirForFigure(figure.Name).File("surface-properties.json");
+		InputRecorder.Record(file);
+		string json = file.ReadAllText();
 		JsonProxy proxy = JsonConvert.DeserializeObject<JsonProxy>(json, settings);
 
 		int subdivisionLevel = proxy.subdivisionLevel;
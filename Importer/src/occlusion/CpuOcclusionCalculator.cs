@@ -0,0 +1,615 @@
+using SharpDX;
+using System;
+using System.Collections.Generic;
+using System.Linq;
+using System.Threading.Tasks;
+
+/**
+ * A CPU implementation of the hemispherical rasterization GpuOcclusionCalculator performs, so that occlusion can be
+ * baked without a device.
+ *
+ * Each receiver looks along its normal and then against it, and every face in front of it is rasterized onto the same
+ * 32x32 hemisphere the GPU uses: a face covers the intersection of its four edge planes, and each edge plane's coverage
+ * comes from the same precomputed cube table. Rasters are stored as 64-bit words, two rows to a word, so intersecting
+ * four edge planes takes 16 word-wide ANDs instead of a test per sample.
+ *
+ * Faces are grouped into clusters of consecutive faces with bounding spheres. A cluster or face that lies entirely
+ * behind a receiver's hemisphere is skipped without being transformed; the GPU rasterizes those faces to an empty
+ * raster, so skipping them doesn't change the result. Opaque faces are accumulated into a coverage mask and only
+ * partially transparent faces touch per-sample transmittances. Receivers are processed in parallel.
+ */
+public class CpuOcclusionCalculator {
+	private const int RasterDim = 32;
+	private const int RasterSampleCount = RasterDim * RasterDim;
+	private const int RasterWordBits = 64;
+	private const int RasterWordCount = RasterSampleCount / RasterWordBits;
+
+	private const int RasterTableFaceCount = 3;
+	private const int RasterTableDim = 128;
+	private const int RasterTableElementCount = RasterTableFaceCount * RasterTableDim * RasterTableDim;
+
+	private const int FacesPerCluster = 32;
+
+	//bounding radii are padded so that rounding never culls a face the GPU would rasterize
+	private const float BoundsPadding = 1e-4f;
+
+	private static readonly Lazy<ulong[]> RasterTable = new Lazy<ulong[]>(BuildRasterTable);
+	private static readonly ulong[] HemisphereMask = BuildHemisphereMask();
+	private static readonly int HemisphereSampleCount = HemisphereMask.Sum(CountSetBits);
+
+	//the first and last columns of both rows in a raster word
+	private const ulong FirstColumnMask = 0x0000000100000001UL;
+	private const ulong LastColumnMask = 0x8000000080000000UL;
+
+	private const ulong DeBruijnMultiplier = 0x03f79d71b4cb0a89UL;
+	private static readonly int[] DeBruijnBitPositions = BuildDeBruijnBitPositions();
+
+	private class Workspace {
+		public readonly ulong[] FaceRaster = new ulong[RasterWordCount];
+		public readonly ulong[] EdgeRaster = new ulong[RasterWordCount];
+		public readonly ulong[] PaddedRaster = new ulong[RasterWordCount];
+		public readonly ulong[] OpaqueMask = new ulong[RasterWordCount];
+		public readonly ulong[] TranslucentMask = new ulong[RasterWordCount];
+		public readonly float[] Transmittances = new float[RasterSampleCount];
+
+		public Workspace() {
+			for (int i = 0; i < RasterSampleCount; ++i) {
+				Transmittances[i] = 1;
+			}
+		}
+	}
+
+	private struct ViewTransform {
+		private readonly Vector3 xAxis;
+		private readonly Vector3 yAxis;
+		private readonly Vector3 zAxis;
+		private readonly Vector3 translation;
+
+		//matches lookAtRH in the compute shader
+		public ViewTransform(Vector3 position, Vector3 viewDir) {
+			Vector3 up = Math.Abs(viewDir.Y) > Math.Abs(viewDir.X) && Math.Abs(viewDir.Y) > Math.Abs(viewDir.Z) ? Vector3.UnitZ : Vector3.UnitY;
+			zAxis = -viewDir;
+			xAxis = Vector3.Normalize(Vector3.Cross(up, zAxis));
+			yAxis = Vector3.Cross(zAxis, xAxis);
+			translation = new Vector3(-Vector3.Dot(xAxis, position), -Vector3.Dot(yAxis, position), -Vector3.Dot(zAxis, position));
+		}
+
+		public Vector3 Apply(Vector3 p) {
+			return new Vector3(
+				Vector3.Dot(p, xAxis) + translation.X,
+				Vector3.Dot(p, yAxis) + translation.Y,
+				Vector3.Dot(p, zAxis) + translation.Z);
+		}
+	}
+
+	private readonly int vertexCount;
+	private readonly Quad[] faces;
+	private readonly float[] faceTransparencies;
+	private readonly uint[] faceMasks;
+	private readonly uint[] vertexMasks;
+	private readonly ParallelOptions parallelOptions;
+
+	public CpuOcclusionCalculator(QuadTopology topology, float[] faceTransparencies, uint[] faceMasks, uint[] vertexMasks,
+		int maxDegreeOfParallelism = -1) {
+		if (topology.Faces.Length != faceTransparencies.Length) {
+			throw new ArgumentException("face count mismatch");
+		}
+		if (topology.Faces.Length != faceMasks.Length) {
+			throw new ArgumentException("face count mismatch");
+		}
+
+		if (topology.VertexCount != vertexMasks.Length) {
+			throw new ArgumentException("vertex count mismatch");
+		}
+
+		vertexCount = topology.VertexCount;
+		faces = topology.Faces;
+		this.faceTransparencies = faceTransparencies;
+		this.faceMasks = faceMasks;
+		this.vertexMasks = vertexMasks;
+		parallelOptions = new ParallelOptions { MaxDegreeOfParallelism = maxDegreeOfParallelism };
+	}
+
+	private static ulong[] BuildRasterTable() {
+		Vector4[] pointsAndWeights = GpuOcclusionCalculator.CalculateHemispherePointsAndWeights();
+
+		ulong[] table = new ulong[RasterTableElementCount * RasterWordCount];
+		Parallel.For(0, RasterTableFaceCount * RasterTableDim, faceAndSIdx => {
+			int face = faceAndSIdx / RasterTableDim;
+			int sIdx = faceAndSIdx % RasterTableDim;
+
+			for (int tIdx = 0; tIdx < RasterTableDim; ++tIdx) {
+				Vector3 planeNormal = CubeMapVectorFromLocation(face, sIdx, tIdx);
+				int offset = CubeMapToFlatIdx(face, sIdx, tIdx) * RasterWordCount;
+
+				for (int sampleIdx = 0; sampleIdx < RasterSampleCount; ++sampleIdx) {
+					Vector4 point = pointsAndWeights[sampleIdx];
+					bool isAbove = point.X * planeNormal.X + point.Y * planeNormal.Y + point.Z * planeNormal.Z >= 0;
+					if (isAbove) {
+						table[offset + sampleIdx / RasterWordBits] |= 1UL << (sampleIdx % RasterWordBits);
+					}
+				}
+			}
+		});
+		return table;
+	}
+
+	private static ulong[] BuildHemisphereMask() {
+		Vector4[] pointsAndWeights = GpuOcclusionCalculator.CalculateHemispherePointsAndWeights();
+
+		ulong[] mask = new ulong[RasterWordCount];
+		for (int sampleIdx = 0; sampleIdx < RasterSampleCount; ++sampleIdx) {
+			//all weights are either zero or one
+			if (pointsAndWeights[sampleIdx].W != 0) {
+				mask[sampleIdx / RasterWordBits] |= 1UL << (sampleIdx % RasterWordBits);
+			}
+		}
+		return mask;
+	}
+
+	private static int[] BuildDeBruijnBitPositions() {
+		int[] positions = new int[RasterWordBits];
+		for (int bitIdx = 0; bitIdx < RasterWordBits; ++bitIdx) {
+			positions[(DeBruijnMultiplier << bitIdx) >> 58] = bitIdx;
+		}
+		return positions;
+	}
+
+	private static int LowestSetBitIdx(ulong bits) {
+		return DeBruijnBitPositions[((bits & (~bits + 1)) * DeBruijnMultiplier) >> 58];
+	}
+
+	private static int CountSetBits(ulong bits) {
+		bits -= (bits >> 1) & 0x5555555555555555UL;
+		bits = (bits & 0x3333333333333333UL) + ((bits >> 2) & 0x3333333333333333UL);
+		bits = (bits + (bits >> 4)) & 0x0f0f0f0f0f0f0f0fUL;
+		return (int) ((bits * 0x0101010101010101UL) >> 56);
+	}
+
+	private static int FloatToIdx(float f) {
+		float scaled = f * RasterTableDim;
+		//like the GPU's float-to-uint conversion, negative values and NaN become zero
+		if (!(scaled > 0)) {
+			return 0;
+		}
+		return scaled >= RasterTableDim - 1 ? RasterTableDim - 1 : (int) scaled;
+	}
+
+	private static float IdxToFloat(int idx) {
+		return (idx + 0.5f) / RasterTableDim;
+	}
+
+	private static int CubeMapToFlatIdx(int face, int sIdx, int tIdx) {
+		return face * RasterTableDim * RasterTableDim + sIdx * RasterTableDim + tIdx;
+	}
+
+	private static Vector3 CubeMapVectorFromLocation(int face, int sIdx, int tIdx) {
+		float s = IdxToFloat(sIdx) * 2 - 1;
+		float t = IdxToFloat(tIdx) * 2 - 1;
+
+		if (face == 0) {
+			return new Vector3(+1, s, t);
+		} else if (face == 1) {
+			return new Vector3(s, +1, t);
+		} else {
+			return new Vector3(s, t, +1);
+		}
+	}
+
+	/**
+	 * Returns the word offset in the raster table of the plane's raster, and a mask to XOR it with, which inverts it
+	 * when the plane faces away from the table's cube faces.
+	 */
+	private static int CubeMapLocationFromVector(Vector3 v, out ulong invertMask) {
+		float absX = Math.Abs(v.X);
+		float absY = Math.Abs(v.Y);
+		float absZ = Math.Abs(v.Z);
+
+		int face;
+		bool invert;
+		float s, t;
+		if (absX >= absY && absX >= absZ) {
+			face = 0;
+			invert = v.X < 0;
+			s = v.Y / absX;
+			t = v.Z / absX;
+		} else if (absY >= absX && absY >= absZ) {
+			face = 1;
+			invert = v.Y < 0;
+			s = v.X / absY;
+			t = v.Z / absY;
+		} else {
+			face = 2;
+			invert = v.Z < 0;
+			s = v.X / absZ;
+			t = v.Y / absZ;
+		}
+
+		if (invert) {
+			s *= -1;
+			t *= -1;
+		}
+
+		invertMask = invert ? ulong.MaxValue : 0;
+		return CubeMapToFlatIdx(face, FloatToIdx((s + 1) / 2), FloatToIdx((t + 1) / 2)) * RasterWordCount;
+	}
+
+	private static int LookUpEdgePlane(Vector3 vertexA, Vector3 vertexB, bool isBackface, out ulong invertMask) {
+		Vector3 planeNormal = Vector3.Cross(vertexB, vertexA);
+		if (isBackface) {
+			planeNormal *= -1;
+		}
+		return CubeMapLocationFromVector(planeNormal, out invertMask);
+	}
+
+	private static bool IsBehind(BoundingSphere sphere, Vector3 viewPos, Vector3 viewDir) {
+		return Vector3.Dot(sphere.Center - viewPos, viewDir) + sphere.Radius < 0;
+	}
+
+	private BoundingSphere[] CalculateFaceSpheres(BasicRefinedVertexInfo[] vertexInfos) {
+		var spheres = new BoundingSphere[faces.Length];
+		for (int faceIdx = 0; faceIdx < faces.Length; ++faceIdx) {
+			Quad face = faces[faceIdx];
+			Vector3 p0 = vertexInfos[face.Index0].position;
+			Vector3 p1 = vertexInfos[face.Index1].position;
+			Vector3 p2 = vertexInfos[face.Index2].position;
+			Vector3 p3 = vertexInfos[face.Index3].position;
+
+			Vector3 center = (Vector3.Min(Vector3.Min(p0, p1), Vector3.Min(p2, p3)) + Vector3.Max(Vector3.Max(p0, p1), Vector3.Max(p2, p3))) / 2;
+			float radius = Math.Max(
+				Math.Max(Vector3.Distance(center, p0), Vector3.Distance(center, p1)),
+				Math.Max(Vector3.Distance(center, p2), Vector3.Distance(center, p3)));
+			spheres[faceIdx] = new BoundingSphere(center, radius * (1 + BoundsPadding) + BoundsPadding);
+		}
+		return spheres;
+	}
+
+	private static BoundingSphere[] CalculateClusterSpheres(BoundingSphere[] faceSpheres) {
+		int clusterCount = IntegerUtils.RoundUp(faceSpheres.Length, FacesPerCluster);
+		var spheres = new BoundingSphere[clusterCount];
+		for (int clusterIdx = 0; clusterIdx < clusterCount; ++clusterIdx) {
+			int startFaceIdx = clusterIdx * FacesPerCluster;
+			int endFaceIdx = Math.Min(startFaceIdx + FacesPerCluster, faceSpheres.Length);
+
+			Vector3 min = new Vector3(float.MaxValue);
+			Vector3 max = new Vector3(float.MinValue);
+			for (int faceIdx = startFaceIdx; faceIdx < endFaceIdx; ++faceIdx) {
+				BoundingSphere faceSphere = faceSpheres[faceIdx];
+				min = Vector3.Min(min, faceSphere.Center - new Vector3(faceSphere.Radius));
+				max = Vector3.Max(max, faceSphere.Center + new Vector3(faceSphere.Radius));
+			}
+
+			Vector3 center = (min + max) / 2;
+			float radius = 0;
+			for (int faceIdx = startFaceIdx; faceIdx < endFaceIdx; ++faceIdx) {
+				BoundingSphere faceSphere = faceSpheres[faceIdx];
+				radius = Math.Max(radius, Vector3.Distance(center, faceSphere.Center) + faceSphere.Radius);
+			}
+			spheres[clusterIdx] = new BoundingSphere(center, radius * (1 + BoundsPadding) + BoundsPadding);
+		}
+		return spheres;
+	}
+
+	/**
+	 * Calculates the front and back occlusion of every vertex, as GpuOcclusionCalculator.Run does.
+	 */
+	public OcclusionInfo[] Run(BasicRefinedVertexInfo[] vertexInfos) {
+		return Run(vertexInfos, null, null);
+	}
+
+	/**
+	 * Calculates the occlusion of the receivers flagged in receiversToCalculate and takes every other receiver's
+	 * occlusion from referenceOcclusionInfos.
+	 */
+	public OcclusionInfo[] Run(BasicRefinedVertexInfo[] vertexInfos, bool[] receiversToCalculate, OcclusionInfo[] referenceOcclusionInfos) {
+		if (vertexInfos.Length != vertexCount) {
+			throw new ArgumentException("vertex count mismatch");
+		}
+		if (receiversToCalculate != null && (receiversToCalculate.Length != vertexCount || referenceOcclusionInfos?.Length != vertexCount)) {
+			throw new ArgumentException("vertex count mismatch");
+		}
+
+		BoundingSphere[] faceSpheres = CalculateFaceSpheres(vertexInfos);
+		BoundingSphere[] clusterSpheres = CalculateClusterSpheres(faceSpheres);
+		ulong[] rasterTable = RasterTable.Value;
+
+		var occlusionInfos = new OcclusionInfo[vertexCount];
+		Parallel.For(0, vertexCount, parallelOptions, () => new Workspace(), (receiverIdx, loopState, workspace) => {
+			if (receiversToCalculate != null && !receiversToCalculate[receiverIdx]) {
+				occlusionInfos[receiverIdx] = referenceOcclusionInfos[receiverIdx];
+				return workspace;
+			}
+
+			Vector3 position = vertexInfos[receiverIdx].position;
+			Vector3 normal = vertexInfos[receiverIdx].normal;
+			float front = CalculateOcclusion(workspace, rasterTable, vertexInfos, faceSpheres, clusterSpheres, receiverIdx, position, normal);
+			float back = CalculateOcclusion(workspace, rasterTable, vertexInfos, faceSpheres, clusterSpheres, receiverIdx, position, -normal);
+			occlusionInfos[receiverIdx] = new OcclusionInfo(front, back);
+			return workspace;
+		}, workspace => {});
+		return occlusionInfos;
+	}
+
+	/**
+	 * Finds the receivers whose occlusion can differ between two sets of vertex infos: receivers that moved or turned
+	 * themselves, and receivers that can see any face that moved, at either its reference or its new position. A
+	 * face is seen if it covers any sample of either hemisphere. Every other receiver rasterizes exactly the same
+	 * faces to exactly the same rasters, so its reference occlusion still holds.
+	 *
+	 * That only holds for this calculator's own rasterization. When the occlusion will be calculated on the GPU, pass
+	 * padCoverage so that each face's coverage is padded by a sample in every direction, and nearly edge-on faces are
+	 * rasterized with both windings. A face the GPU rasterizes differently because of rounding is then still seen.
+	 */
+	public bool[] FindAffectedReceivers(BasicRefinedVertexInfo[] referenceVertexInfos, BasicRefinedVertexInfo[] vertexInfos, bool padCoverage) {
+		if (referenceVertexInfos.Length != vertexCount || vertexInfos.Length != vertexCount) {
+			throw new ArgumentException("vertex count mismatch");
+		}
+
+		var areVerticesChanged = new bool[vertexCount];
+		for (int vertexIdx = 0; vertexIdx < vertexCount; ++vertexIdx) {
+			areVerticesChanged[vertexIdx] =
+				referenceVertexInfos[vertexIdx].position != vertexInfos[vertexIdx].position ||
+				referenceVertexInfos[vertexIdx].normal != vertexInfos[vertexIdx].normal;
+		}
+
+		var changedFaceIndices = new List<int>();
+		for (int faceIdx = 0; faceIdx < faces.Length; ++faceIdx) {
+			Quad face = faces[faceIdx];
+			if (!(faceTransparencies[faceIdx] < 1)) {
+				continue;
+			}
+			if (areVerticesChanged[face.Index0] || areVerticesChanged[face.Index1] || areVerticesChanged[face.Index2] || areVerticesChanged[face.Index3]) {
+				changedFaceIndices.Add(faceIdx);
+			}
+		}
+
+		ulong[] rasterTable = RasterTable.Value;
+
+		var areReceiversAffected = new bool[vertexCount];
+		Parallel.For(0, vertexCount, parallelOptions, () => new Workspace(), (receiverIdx, loopState, workspace) => {
+			if (areVerticesChanged[receiverIdx]) {
+				areReceiversAffected[receiverIdx] = true;
+				return workspace;
+			}
+
+			Vector3 position = vertexInfos[receiverIdx].position;
+			Vector3 normal = vertexInfos[receiverIdx].normal;
+			areReceiversAffected[receiverIdx] =
+				CanSeeAnyFace(workspace, rasterTable, changedFaceIndices, referenceVertexInfos, vertexInfos, padCoverage, receiverIdx, position, normal) ||
+				CanSeeAnyFace(workspace, rasterTable, changedFaceIndices, referenceVertexInfos, vertexInfos, padCoverage, receiverIdx, position, -normal);
+			return workspace;
+		}, workspace => {});
+		return areReceiversAffected;
+	}
+
+	private bool CanSeeAnyFace(Workspace workspace, ulong[] rasterTable, List<int> faceIndices,
+		BasicRefinedVertexInfo[] referenceVertexInfos, BasicRefinedVertexInfo[] vertexInfos, bool padCoverage,
+		int receiverIdx, Vector3 viewPos, Vector3 viewDir) {
+		ViewTransform viewTransform = new ViewTransform(viewPos, viewDir);
+
+		foreach (int faceIdx in faceIndices) {
+			if (CanSeeFace(workspace, rasterTable, referenceVertexInfos, padCoverage, viewTransform, faceIdx, receiverIdx)) {
+				return true;
+			}
+			if (CanSeeFace(workspace, rasterTable, vertexInfos, padCoverage, viewTransform, faceIdx, receiverIdx)) {
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	private bool CanSeeFace(Workspace workspace, ulong[] rasterTable, BasicRefinedVertexInfo[] vertexInfos, bool padCoverage,
+		ViewTransform viewTransform, int faceIdx, int receiverIdx) {
+		ulong[] faceRaster = workspace.FaceRaster;
+		bool isRasterized = padCoverage ?
+			TryRasterizePaddedFace(workspace, rasterTable, vertexInfos, viewTransform, faceIdx, receiverIdx) :
+			TryRasterizeFace(rasterTable, vertexInfos, viewTransform, faceIdx, receiverIdx, faceRaster);
+		return isRasterized && IsAnySampleSet(faceRaster);
+	}
+
+	private static bool IsAnySampleSet(ulong[] raster) {
+		for (int wordIdx = 0; wordIdx < RasterWordCount; ++wordIdx) {
+			if ((raster[wordIdx] & HemisphereMask[wordIdx]) != 0) {
+				return true;
+			}
+		}
+		return false;
+	}
+
+	/**
+	 * Rasterizes a face as seen from a receiver, matching rasterizeFace in the compute shader. Returns false, leaving
+	 * the raster untouched, for faces that the receiver ignores or that are entirely behind it.
+	 */
+	private bool TryRasterizeFace(ulong[] rasterTable, BasicRefinedVertexInfo[] vertexInfos, ViewTransform viewTransform,
+		int faceIdx, int receiverIdx, ulong[] faceRaster) {
+		Quad face = faces[faceIdx];
+		if ((vertexMasks[receiverIdx] & faceMasks[faceIdx]) != 0) {
+			return false;
+		} else if (face.Index0 == receiverIdx || face.Index1 == receiverIdx || face.Index2 == receiverIdx || face.Index3 == receiverIdx) {
+			return false;
+		}
+
+		Vector3 vert0 = viewTransform.Apply(vertexInfos[face.Index0].position);
+		Vector3 vert1 = viewTransform.Apply(vertexInfos[face.Index1].position);
+		Vector3 vert2 = viewTransform.Apply(vertexInfos[face.Index2].position);
+		Vector3 vert3 = viewTransform.Apply(vertexInfos[face.Index3].position);
+
+		if (vert0.Z >= 0 && vert1.Z >= 0 && vert2.Z >= 0 && vert3.Z >= 0) {
+			//behind camera
+			return false;
+		}
+
+		Vector3 faceNormal = Vector3.Cross(vert1 - vert0, vert2 - vert1);
+		bool isBackface = Vector3.Dot(faceNormal, vert1) > 0;
+		int offset0 = LookUpEdgePlane(vert0, vert1, isBackface, out ulong invert0);
+		int offset1 = LookUpEdgePlane(vert1, vert2, isBackface, out ulong invert1);
+		int offset2 = LookUpEdgePlane(vert2, vert3, isBackface, out ulong invert2);
+		int offset3 = LookUpEdgePlane(vert3, vert0, isBackface, out ulong invert3);
+
+		for (int wordIdx = 0; wordIdx < RasterWordCount; ++wordIdx) {
+			faceRaster[wordIdx] =
+				(rasterTable[offset0 + wordIdx] ^ invert0) &
+				(rasterTable[offset1 + wordIdx] ^ invert1) &
+				(rasterTable[offset2 + wordIdx] ^ invert2) &
+				(rasterTable[offset3 + wordIdx] ^ invert3);
+		}
+		return true;
+	}
+
+	/**
+	 * Rasterizes a superset of the samples the GPU could cover for a face into the workspace's face raster: each edge
+	 * plane's coverage is padded by a sample in every direction before the planes are intersected, faces are only
+	 * treated as behind the receiver if they're clearly behind it, and nearly edge-on faces are rasterized with both
+	 * windings.
+	 */
+	private bool TryRasterizePaddedFace(Workspace workspace, ulong[] rasterTable, BasicRefinedVertexInfo[] vertexInfos,
+		ViewTransform viewTransform, int faceIdx, int receiverIdx) {
+		Quad face = faces[faceIdx];
+		if ((vertexMasks[receiverIdx] & faceMasks[faceIdx]) != 0) {
+			return false;
+		} else if (face.Index0 == receiverIdx || face.Index1 == receiverIdx || face.Index2 == receiverIdx || face.Index3 == receiverIdx) {
+			return false;
+		}
+
+		Vector3 vert0 = viewTransform.Apply(vertexInfos[face.Index0].position);
+		Vector3 vert1 = viewTransform.Apply(vertexInfos[face.Index1].position);
+		Vector3 vert2 = viewTransform.Apply(vertexInfos[face.Index2].position);
+		Vector3 vert3 = viewTransform.Apply(vertexInfos[face.Index3].position);
+
+		if (IsClearlyBehind(vert0) && IsClearlyBehind(vert1) && IsClearlyBehind(vert2) && IsClearlyBehind(vert3)) {
+			return false;
+		}
+
+		Vector3 faceNormal = Vector3.Cross(vert1 - vert0, vert2 - vert1);
+		float facing = Vector3.Dot(faceNormal, vert1);
+		bool isNearlyEdgeOn = Math.Abs(facing) <= BoundsPadding * faceNormal.Length() * vert1.Length();
+
+		ulong[] faceRaster = workspace.FaceRaster;
+		ulong[] paddedRaster = workspace.PaddedRaster;
+		Array.Clear(faceRaster, 0, RasterWordCount);
+		for (int winding = 0; winding < 2; ++winding) {
+			bool isBackface = winding == 1;
+			if (!isNearlyEdgeOn && isBackface != (facing > 0)) {
+				continue;
+			}
+
+			for (int wordIdx = 0; wordIdx < RasterWordCount; ++wordIdx) {
+				paddedRaster[wordIdx] = ulong.MaxValue;
+			}
+			IntersectPaddedEdgePlane(workspace, rasterTable, LookUpEdgePlane(vert0, vert1, isBackface, out ulong invert0), invert0);
+			IntersectPaddedEdgePlane(workspace, rasterTable, LookUpEdgePlane(vert1, vert2, isBackface, out ulong invert1), invert1);
+			IntersectPaddedEdgePlane(workspace, rasterTable, LookUpEdgePlane(vert2, vert3, isBackface, out ulong invert2), invert2);
+			IntersectPaddedEdgePlane(workspace, rasterTable, LookUpEdgePlane(vert3, vert0, isBackface, out ulong invert3), invert3);
+
+			for (int wordIdx = 0; wordIdx < RasterWordCount; ++wordIdx) {
+				faceRaster[wordIdx] |= paddedRaster[wordIdx];
+			}
+		}
+		return true;
+	}
+
+	private static bool IsClearlyBehind(Vector3 viewVertex) {
+		return viewVertex.Z > BoundsPadding * viewVertex.Length();
+	}
+
+	/**
+	 * Pads an edge plane's raster by a sample in every direction and intersects it into the workspace's padded raster.
+	 */
+	private static void IntersectPaddedEdgePlane(Workspace workspace, ulong[] rasterTable, int offset, ulong invertMask) {
+		ulong[] edgeRaster = workspace.EdgeRaster;
+		ulong[] paddedRaster = workspace.PaddedRaster;
+
+		//pad along rows, without spilling from one row of a word into the other
+		for (int wordIdx = 0; wordIdx < RasterWordCount; ++wordIdx) {
+			ulong word = rasterTable[offset + wordIdx] ^ invertMask;
+			edgeRaster[wordIdx] = word | ((word << 1) & ~FirstColumnMask) | ((word >> 1) & ~LastColumnMask);
+		}
+
+		//pad across rows: each word's rows take in the rows next to them, in the same word or the adjacent words
+		for (int wordIdx = 0; wordIdx < RasterWordCount; ++wordIdx) {
+			ulong word = edgeRaster[wordIdx];
+			ulong padded = word | (word << 32) | (word >> 32);
+			if (wordIdx > 0) {
+				padded |= edgeRaster[wordIdx - 1] >> 32;
+			}
+			if (wordIdx < RasterWordCount - 1) {
+				padded |= edgeRaster[wordIdx + 1] << 32;
+			}
+			paddedRaster[wordIdx] &= padded;
+		}
+	}
+
+	private float CalculateOcclusion(Workspace workspace, ulong[] rasterTable, BasicRefinedVertexInfo[] vertexInfos,
+		BoundingSphere[] faceSpheres, BoundingSphere[] clusterSpheres, int receiverIdx, Vector3 viewPos, Vector3 viewDir) {
+		ulong[] faceRaster = workspace.FaceRaster;
+		ulong[] opaqueMask = workspace.OpaqueMask;
+		ulong[] translucentMask = workspace.TranslucentMask;
+		float[] transmittances = workspace.Transmittances;
+
+		ViewTransform viewTransform = new ViewTransform(viewPos, viewDir);
+
+		for (int clusterIdx = 0; clusterIdx < clusterSpheres.Length; ++clusterIdx) {
+			if (IsBehind(clusterSpheres[clusterIdx], viewPos, viewDir)) {
+				continue;
+			}
+
+			int startFaceIdx = clusterIdx * FacesPerCluster;
+			int endFaceIdx = Math.Min(startFaceIdx + FacesPerCluster, faces.Length);
+			for (int faceIdx = startFaceIdx; faceIdx < endFaceIdx; ++faceIdx) {
+				float transparency = faceTransparencies[faceIdx];
+				if (!(transparency < 1)) {
+					//multiplying by one changes nothing
+					continue;
+				}
+
+				if (IsBehind(faceSpheres[faceIdx], viewPos, viewDir)) {
+					continue;
+				}
+
+				if (!TryRasterizeFace(rasterTable, vertexInfos, viewTransform, faceIdx, receiverIdx, faceRaster)) {
+					continue;
+				}
+
+				if (transparency == 0) {
+					for (int wordIdx = 0; wordIdx < RasterWordCount; ++wordIdx) {
+						opaqueMask[wordIdx] |= faceRaster[wordIdx];
+					}
+					continue;
+				}
+
+				for (int wordIdx = 0; wordIdx < RasterWordCount; ++wordIdx) {
+					//samples that are already opaque or outside the hemisphere don't need their transmittance tracked
+					ulong bits = faceRaster[wordIdx] & ~opaqueMask[wordIdx] & HemisphereMask[wordIdx];
+					translucentMask[wordIdx] |= bits;
+					while (bits != 0) {
+						transmittances[wordIdx * RasterWordBits + LowestSetBitIdx(bits)] *= transparency;
+						bits &= bits - 1;
+					}
+				}
+			}
+		}
+
+		float occludedSum = 0;
+		for (int wordIdx = 0; wordIdx < RasterWordCount; ++wordIdx) {
+			ulong opaqueBits = opaqueMask[wordIdx] & HemisphereMask[wordIdx];
+			occludedSum += CountSetBits(opaqueBits);
+
+			//accumulate translucent samples and reset their transmittances for the next pass
+			ulong bits = translucentMask[wordIdx];
+			while (bits != 0) {
+				int sampleIdx = wordIdx * RasterWordBits + LowestSetBitIdx(bits);
+				if ((opaqueBits & (bits & (~bits + 1))) == 0) {
+					occludedSum += 1 - transmittances[sampleIdx];
+				}
+				transmittances[sampleIdx] = 1;
+				bits &= bits - 1;
+			}
+
+			opaqueMask[wordIdx] = 0;
+			translucentMask[wordIdx] = 0;
+		}
+
+		return occludedSum / HemisphereSampleCount;
+	}
+}
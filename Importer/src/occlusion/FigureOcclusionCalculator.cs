@@ -4,6 +4,9 @@ using System;
 using System.Collections.Generic;
 using System.Linq;
 
+/**
+ * Calculates the occlusion of a figure group on the GPU, or on the CPU when no device is given.
+ */
 public class FigureOcclusionCalculator : IDisposable {
 	public class Result {
 		public OcclusionInfo[] ParentOcclusion { get; }
@@ -23,10 +26,16 @@ public class FigureOcclusionCalculator : IDisposable {
 	private readonly InOutStructuredBufferManager<BasicRefinedVertexInfo> refinedVertexInfosBufferManager;
 	private readonly GpuOcclusionCalculator occlusionCalculator;
 
+	private readonly CpuBasicVertexRefiner cpuVertexRefiner;
+	private readonly CpuOcclusionCalculator cpuOcclusionCalculator;
+
 	private readonly ArraySegment parentSegment;
 	private readonly List<ArraySegment> surrogateSegments = new List<ArraySegment>();
 
 	private readonly List<ArraySegment> childSegments = new List<ArraySegment>();
+
+	private BasicRefinedVertexInfo[] referenceVertexInfos;
+	private OcclusionInfo[] referenceOcclusionInfos;
 	
 	public FigureOcclusionCalculator(ContentFileLocator fileLocator, Device device, ShaderCache shaderCache, FigureGroup figureGroup, FaceTransparenciesGroup faceTransparenciesGroup) {
 		this.device = device;
@@ -66,6 +75,17 @@ public class FigureOcclusionCalculator : IDisposable {
 			}
 		}
 		
+		//the CPU calculator is also used with a device, to find the vertices an incremental calculation must update
+		cpuVertexRefiner = new CpuBasicVertexRefiner(geometryConcatenator.Mesh.Stencils);
+		cpuOcclusionCalculator = new CpuOcclusionCalculator(
+			geometryConcatenator.Mesh.Topology,
+			geometryConcatenator.FaceTransparencies,
+			geometryConcatenator.FaceMasks,
+			geometryConcatenator.VertexMasks);
+		if (device == null) {
+			return;
+		}
+
 		groupControlPositionsBufferManager = new StructuredBufferManager<Vector3>(device, geometryConcatenator.Mesh.ControlVertexCount);
 		vertexRefiner = new BasicVertexRefiner(device, shaderCache, geometryConcatenator.Mesh.Stencils);
 		refinedVertexInfosBufferManager = new InOutStructuredBufferManager<BasicRefinedVertexInfo>(device, vertexRefiner.RefinedVertexCount);
@@ -77,18 +97,86 @@ public class FigureOcclusionCalculator : IDisposable {
 	}
 
 	public void Dispose() {
-		groupControlPositionsBufferManager.Dispose();
-		vertexRefiner.Dispose();
-		refinedVertexInfosBufferManager.Dispose();
-		occlusionCalculator.Dispose();
+		groupControlPositionsBufferManager?.Dispose();
+		vertexRefiner?.Dispose();
+		refinedVertexInfosBufferManager?.Dispose();
+		occlusionCalculator?.Dispose();
 	}
 	
+	//number of group vertices whose occlusion the last calculation computed rather than took from the reference
+	public int LastCalculatedVertexCount { get; private set; }
+
 	public Result CalculateOcclusionInformation(ChannelOutputsGroup outputsGroup) {
+		Vector3[] groupControlPositions = CalculateGroupControlPositions(outputsGroup, out var surrogateVertexInfos);
+
+		OcclusionInfo[] groupOcclusionInfos = device == null ?
+			cpuOcclusionCalculator.Run(RefineOnCpu(groupControlPositions, surrogateVertexInfos)) :
+			CalculateGroupOcclusionOnGpu(groupControlPositions, surrogateVertexInfos, null);
+		LastCalculatedVertexCount = groupOcclusionInfos.Length;
+
+		return MakeResult(groupOcclusionInfos);
+	}
+
+	/**
+	 * Calculates the occlusion of the outputs in full and remembers it as the reference for
+	 * CalculateOcclusionInformationIncrementally.
+	 */
+	public Result SetReference(ChannelOutputsGroup outputsGroup) {
+		Vector3[] groupControlPositions = CalculateGroupControlPositions(outputsGroup, out var surrogateVertexInfos);
+		BasicRefinedVertexInfo[] vertexInfos = RefineOnCpu(groupControlPositions, surrogateVertexInfos);
+
+		OcclusionInfo[] groupOcclusionInfos = device == null ?
+			cpuOcclusionCalculator.Run(vertexInfos) :
+			CalculateGroupOcclusionOnGpu(groupControlPositions, surrogateVertexInfos, null);
+		LastCalculatedVertexCount = groupOcclusionInfos.Length;
+
+		referenceVertexInfos = vertexInfos;
+		referenceOcclusionInfos = groupOcclusionInfos;
+		return MakeResult(groupOcclusionInfos);
+	}
+
+	/**
+	 * Calculates the same occlusion as CalculateOcclusionInformation, but only for the vertices that can be affected by
+	 * what moved since the reference: vertices that moved themselves and vertices that can see a moved face. Every other
+	 * vertex keeps its reference occlusion. A channel that only reshapes a small region therefore only costs the
+	 * vertices around that region.
+	 */
+	public Result CalculateOcclusionInformationIncrementally(ChannelOutputsGroup outputsGroup) {
+		if (referenceVertexInfos == null) {
+			throw new InvalidOperationException("no reference has been set");
+		}
+
+		Vector3[] groupControlPositions = CalculateGroupControlPositions(outputsGroup, out var surrogateVertexInfos);
+		BasicRefinedVertexInfo[] vertexInfos = RefineOnCpu(groupControlPositions, surrogateVertexInfos);
+
+		//the GPU may round differently from the CPU rasterizer, so its receivers are selected with padded coverage
+		bool[] verticesToCalculate = cpuOcclusionCalculator.FindAffectedReceivers(referenceVertexInfos, vertexInfos, device != null);
+		int calculatedVertexCount = verticesToCalculate.Count(isAffected => isAffected);
+
+		OcclusionInfo[] groupOcclusionInfos;
+		if (calculatedVertexCount == 0) {
+			groupOcclusionInfos = referenceOcclusionInfos;
+		} else if (device == null) {
+			groupOcclusionInfos = cpuOcclusionCalculator.Run(vertexInfos, verticesToCalculate, referenceOcclusionInfos);
+		} else {
+			groupOcclusionInfos = CalculateGroupOcclusionOnGpu(groupControlPositions, surrogateVertexInfos, verticesToCalculate);
+			for (int vertexIdx = 0; vertexIdx < groupOcclusionInfos.Length; ++vertexIdx) {
+				if (!verticesToCalculate[vertexIdx]) {
+					groupOcclusionInfos[vertexIdx] = referenceOcclusionInfos[vertexIdx];
+				}
+			}
+		}
+		LastCalculatedVertexCount = calculatedVertexCount;
+
+		return MakeResult(groupOcclusionInfos);
+	}
+
+	private Vector3[] CalculateGroupControlPositions(ChannelOutputsGroup outputsGroup, out List<BasicRefinedVertexInfo[]> surrogateVertexInfos) {
 		List<Vector3> groupControlPositions = new List<Vector3>();
 
 		Vector3[] parentDeltas = figureGroup.Parent.CalculateDeltas(outputsGroup.ParentOutputs);
 
-		List<BasicRefinedVertexInfo[]> surrogateVertexInfos = new List<BasicRefinedVertexInfo[]>();
+		surrogateVertexInfos = new List<BasicRefinedVertexInfo[]>();
 
 		//parent
 		{
@@ -103,8 +191,6 @@ public class FigureOcclusionCalculator : IDisposable {
 			}
 		}
 
-		int figureOffset = groupControlPositions.Count;
-
 		//children
 		for (int childIdx = 0; childIdx < figureGroup.Children.Length; ++childIdx) {
 			var figure = figureGroup.Children[childIdx];
@@ -113,20 +199,11 @@ public class FigureOcclusionCalculator : IDisposable {
 			var controlPositions = figure.CalculateControlPositions(outputs, parentDeltas);
 			groupControlPositions.AddRange(controlPositions);
 		}
-		
-		DeviceContext context = device.ImmediateContext;
-
-		groupControlPositionsBufferManager.Update(context, groupControlPositions.ToArray());
-		vertexRefiner.Refine(context, groupControlPositionsBufferManager.View, refinedVertexInfosBufferManager.OutView);
 
-		for (int surrogateIdx = 0; surrogateIdx < figureGroup.Parent.OcclusionBinding.Surrogates.Count; ++surrogateIdx) {
-			var segment = surrogateSegments[surrogateIdx];
-			var vertexInfos = surrogateVertexInfos[surrogateIdx];
-			refinedVertexInfosBufferManager.Update(context, vertexInfos, segment.Offset);
-		}
-		
-		OcclusionInfo[] groupOcclusionInfos = occlusionCalculator.Run(context, refinedVertexInfosBufferManager.InView);
+		return groupControlPositions.ToArray();
+	}
 
+	private Result MakeResult(OcclusionInfo[] groupOcclusionInfos) {
 		OcclusionInfo[] parentOcclusionInfos;
 		List<OcclusionInfo[]> childOcclusionInfos = new List<OcclusionInfo[]>();
 		
@@ -150,4 +227,32 @@ public class FigureOcclusionCalculator : IDisposable {
 		
 		return new Result(parentOcclusionInfos, childOcclusionInfos);
 	}
+
+	private OcclusionInfo[] CalculateGroupOcclusionOnGpu(Vector3[] groupControlPositions, List<BasicRefinedVertexInfo[]> surrogateVertexInfos,
+		bool[] verticesToCalculate) {
+		DeviceContext context = device.ImmediateContext;
+
+		groupControlPositionsBufferManager.Update(context, groupControlPositions);
+		vertexRefiner.Refine(context, groupControlPositionsBufferManager.View, refinedVertexInfosBufferManager.OutView);
+
+		for (int surrogateIdx = 0; surrogateIdx < surrogateVertexInfos.Count; ++surrogateIdx) {
+			var segment = surrogateSegments[surrogateIdx];
+			var vertexInfos = surrogateVertexInfos[surrogateIdx];
+			refinedVertexInfosBufferManager.Update(context, vertexInfos, segment.Offset);
+		}
+		
+		return occlusionCalculator.Run(context, refinedVertexInfosBufferManager.InView, verticesToCalculate);
+	}
+
+	private BasicRefinedVertexInfo[] RefineOnCpu(Vector3[] groupControlPositions, List<BasicRefinedVertexInfo[]> surrogateVertexInfos) {
+		BasicRefinedVertexInfo[] refinedVertexInfos = cpuVertexRefiner.Refine(groupControlPositions);
+
+		for (int surrogateIdx = 0; surrogateIdx < surrogateVertexInfos.Count; ++surrogateIdx) {
+			var segment = surrogateSegments[surrogateIdx];
+			var vertexInfos = surrogateVertexInfos[surrogateIdx];
+			Array.Copy(vertexInfos, 0, refinedVertexInfos, segment.Offset, vertexInfos.Length);
+		}
+
+		return refinedVertexInfos;
+	}
 }
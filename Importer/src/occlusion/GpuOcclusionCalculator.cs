@@ -58,7 +58,7 @@ public class GpuOcclusionCalculator : IDisposable {
 		vertexMasksView = BufferUtilities.ToStructuredBufferView(device, vertexMasks);
 	}
 
-	private static Vector4[] CalculateHemispherePointsAndWeights() {
+	internal static Vector4[] CalculateHemispherePointsAndWeights() {
 		Binner binner = new Binner(RasterDim, Binner.Mode.Midpoints);
 
 		Vector4[] pointsAndWeights = new Vector4[RasterDim * RasterDim];
@@ -134,7 +134,11 @@ public class GpuOcclusionCalculator : IDisposable {
 		faceMasksView.Dispose();
 	}
 	
-	public OcclusionInfo[] Run(DeviceContext context, ShaderResourceView vertexInfos) {
+	/**
+	 * Calculates the occlusion of every vertex. If receiversToCalculate is given, batches without any flagged receiver
+	 * are skipped and their entries in the result are left unspecified.
+	 */
+	public OcclusionInfo[] Run(DeviceContext context, ShaderResourceView vertexInfos, bool[] receiversToCalculate = null) {
 		context.ClearState();
 		context.ComputeShader.Set(shader);
 		context.ComputeShader.SetConstantBuffer(0, hemispherePointsAndWeightsConstantBuffer);
@@ -148,6 +152,10 @@ public class GpuOcclusionCalculator : IDisposable {
 		context.ComputeShader.SetUnorderedAccessView(0, outputBufferManager.View);
 
 		for (int baseVertexIdx = 0; baseVertexIdx < vertexCount; baseVertexIdx += BatchSize) {
+			if (receiversToCalculate != null && !IsAnyReceiverFlagged(receiversToCalculate, baseVertexIdx)) {
+				continue;
+			}
+
 			ArraySegment segment = new ArraySegment(baseVertexIdx, Math.Max(vertexCount - baseVertexIdx, BatchSize));
 			segmentBufferManager.Update(context, segment);
 			context.ComputeShader.SetConstantBuffer(1, segmentBufferManager.Buffer);
@@ -157,4 +165,14 @@ public class GpuOcclusionCalculator : IDisposable {
 		
 		return outputBufferManager.ReadContents(context);
 	}
+
+	private bool IsAnyReceiverFlagged(bool[] receiversToCalculate, int baseVertexIdx) {
+		int endVertexIdx = Math.Min(baseVertexIdx + BatchSize, vertexCount);
+		for (int vertexIdx = baseVertexIdx; vertexIdx < endVertexIdx; ++vertexIdx) {
+			if (receiversToCalculate[vertexIdx]) {
+				return true;
+			}
+		}
+		return false;
+	}
 }
@@ -1,6 +1,7 @@
 using SharpDX.Direct3D11;
 using System;
 using System.Collections.Generic;
+using System.Diagnostics;
 using System.Linq;
 
 class OccluderChannelPicker : IOperationVisitor {
@@ -116,15 +117,18 @@ public class OccluderParametersCalculator : IDisposable {
 		return inputs;
 	}
 	
-	private OcclusionInfo[] CalculateOcclusion(ChannelOutputs outputs) {
-		var outputsGroup = new ChannelOutputsGroup(outputs, new ChannelOutputs[0]);
-		return occlusionCalculator.CalculateOcclusionInformation(outputsGroup).ParentOcclusion;
+	private static ChannelOutputsGroup MakeOutputsGroup(ChannelOutputs outputs) {
+		return new ChannelOutputsGroup(outputs, new ChannelOutputs[0]);
 	}
 
 	public OccluderParameters CalculateOccluderParameters() {
+		var totalStopwatch = Stopwatch.StartNew();
+
 		var baseInputs = MakePosedShapeInputs();
 		var baseOutputs = figure.Evaluate(null, baseInputs);
-		var baseOcclusionInfos = CalculateOcclusion(baseOutputs);
+		var baseOcclusionInfos = occlusionCalculator.SetReference(MakeOutputsGroup(baseOutputs)).ParentOcclusion;
+		int totalVertexCount = occlusionCalculator.LastCalculatedVertexCount;
+		Console.WriteLine($"\tbase shape: {totalStopwatch.Elapsed.TotalMilliseconds:F0} ms");
 		
 		List<Channel> channels = new List<Channel>();
 		List<List<OcclusionDelta>> perVertexDeltas = new List<List<OcclusionDelta>>();
@@ -133,15 +137,16 @@ public class OccluderParametersCalculator : IDisposable {
 		}
 		
 		foreach (var channel in GetChannelsForOcclusionSystem()) {
-			Console.WriteLine($"\t{channel.Name}...");
-			
 			int occlusionChannelIdx = channels.Count;
 			channels.Add(channel);
 
+			//most channels only move a small region, so only the vertices that can see it are recalculated
+			var channelStopwatch = Stopwatch.StartNew();
 			var inputs = new ChannelInputs(baseInputs);
 			channel.SetValue(inputs, 1);
 			var outputs = figure.Evaluate(null, inputs);
-			var occlusionInfos = CalculateOcclusion(outputs);
+			var occlusionInfos = occlusionCalculator.CalculateOcclusionInformationIncrementally(MakeOutputsGroup(outputs)).ParentOcclusion;
+			Console.WriteLine($"\t{channel.Name}: {occlusionCalculator.LastCalculatedVertexCount} of {totalVertexCount} vertices recalculated in {channelStopwatch.Elapsed.TotalMilliseconds:F0} ms");
 			
 			for (int vertexIdx = 0; vertexIdx < occlusionInfos.Length; ++vertexIdx) {
 				if (Math.Abs(occlusionInfos[vertexIdx].Front - baseOcclusionInfos[vertexIdx].Front) > OcclusionDifferenceThreshold) {
@@ -156,6 +161,8 @@ public class OccluderParametersCalculator : IDisposable {
 			channels.Select(channel => channel.Name).ToList(),
 			PackedLists<OcclusionDelta>.Pack(perVertexDeltas));
 
+		Console.WriteLine($"\toccluder parameters for {channels.Count} channels baked in {totalStopwatch.Elapsed.TotalSeconds:F1} s");
+
 		return parameters;
 	}
 }
@@ -6,6 +6,7 @@ public static class FaceTransparencies {
 		if (surfaceProperties.MaterialSetForOpacities != null) {
 			var materialSetDir = figureDestDir.Subdirectory("material-sets").Subdirectory(surfaceProperties.MaterialSetForOpacities);
 			var transparenciesFile = materialSetDir.File("face-transparencies.array");
+			InputRecorder.Record(transparenciesFile);
 			return transparenciesFile.ReadArray<float>();
 		}
 		
@@ -17,8 +17,8 @@ public class BasicVertexRefiner : IDisposable {
 
 		this.refinerShader = shaderCache.GetComputeShader<BasicVertexRefiner>("subdivision/BasicVertexRefiner");
 
-		this.stencilSegmentsView = BufferUtilities.ToStructuredBufferView(device, stencils.Segments);
-		this.stencilElemsView = BufferUtilities.ToStructuredBufferView(device, stencils.Elems);
+		this.stencilSegmentsView = BufferUtilities.ToStructuredBufferView(device, stencils.Segments, MemoryAccounting.Stencils);
+		this.stencilElemsView = BufferUtilities.ToStructuredBufferView(device, stencils.Elems, MemoryAccounting.Stencils);
 	}
 	
 	public void Dispose() {
@@ -0,0 +1,47 @@
+using SharpDX;
+using System.Threading.Tasks;
+
+/**
+ * A CPU implementation of the refinement BasicVertexRefiner performs on the GPU: each refined vertex is its stencil's
+ * weighted sum of control vertices, with a normal from the stencil's u and v derivatives. Vertices are refined in
+ * parallel.
+ */
+public class CpuBasicVertexRefiner {
+	private readonly PackedLists<WeightedIndexWithDerivatives> stencils;
+	private readonly ParallelOptions parallelOptions;
+
+	public CpuBasicVertexRefiner(PackedLists<WeightedIndexWithDerivatives> stencils, int maxDegreeOfParallelism = -1) {
+		this.stencils = stencils;
+		parallelOptions = new ParallelOptions { MaxDegreeOfParallelism = maxDegreeOfParallelism };
+	}
+
+	public int RefinedVertexCount => stencils.Count;
+
+	public BasicRefinedVertexInfo[] Refine(Vector3[] controlVertexPositions) {
+		var segments = stencils.Segments;
+		var elems = stencils.Elems;
+
+		var refinedVertexInfos = new BasicRefinedVertexInfo[segments.Length];
+		Parallel.For(0, segments.Length, parallelOptions, vertexIdx => {
+			Vector3 position = Vector3.Zero;
+			Vector3 positionDu = Vector3.Zero;
+			Vector3 positionDv = Vector3.Zero;
+
+			var segment = segments[vertexIdx];
+			for (int i = segment.Offset; i < segment.Offset + segment.Count; ++i) {
+				var stencil = elems[i];
+				Vector3 controlVertexPosition = controlVertexPositions[stencil.Index];
+
+				position += stencil.Weight * controlVertexPosition;
+				positionDu += stencil.DuWeight * controlVertexPosition;
+				positionDv += stencil.DvWeight * controlVertexPosition;
+			}
+
+			refinedVertexInfos[vertexIdx] = new BasicRefinedVertexInfo {
+				position = position,
+				normal = Vector3.Normalize(Vector3.Cross(positionDu, positionDv))
+			};
+		});
+		return refinedVertexInfos;
+	}
+}
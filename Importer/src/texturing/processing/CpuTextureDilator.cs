@@ -0,0 +1,219 @@
+using SharpDX;
+using System;
+using System.Collections.Generic;
+using System.Threading.Tasks;
+
+/**
+ * A CPU implementation of the same dilation TextureDilator performs on the GPU, for imports without a device or where
+ * the GPU round trip dominates.
+ *
+ * The mask is rasterized conservatively to coverage, the covered texels are premultiplied into a box-filtered mip
+ * pyramid, and each texel composites the pyramid front-to-back from its own level down to the 1x1 level before
+ * un-premultiplying. Covered texels therefore keep their color and uncovered texels take the average of the nearest
+ * covered ones. Rows are processed in parallel.
+ */
+public class CpuTextureDilator : ITextureDilator {
+	private const int BytesPerPixel = 4;
+	private const int AlphaOffset = 3;
+
+	private class Level {
+		public int Width { get; }
+		public int Height { get; }
+		public byte[] Pixels { get; }
+
+		public Level(int width, int height) {
+			Width = width;
+			Height = height;
+			Pixels = new byte[width * height * BytesPerPixel];
+		}
+	}
+
+	private readonly ParallelOptions parallelOptions;
+
+	public CpuTextureDilator(int maxDegreeOfParallelism = -1) {
+		parallelOptions = new ParallelOptions { MaxDegreeOfParallelism = maxDegreeOfParallelism };
+	}
+
+	public void Dispose() {
+	}
+
+	public void Dilate(MultiUvTextureMask mask, Size2 size, bool isLinear, DataBox imageData) {
+		var coverage = new byte[size.Width * size.Height];
+		foreach (var perUvMask in mask.PerUvMasks) {
+			RasterizeMask(perUvMask, size, coverage);
+		}
+
+		var levels = new List<Level> { MakePremultipliedLevel(size, coverage, imageData) };
+		while (levels[levels.Count - 1].Width > 1 || levels[levels.Count - 1].Height > 1) {
+			levels.Add(Downsample(levels[levels.Count - 1]));
+		}
+
+		Composite(levels, imageData);
+	}
+
+	/**
+	 * Marks every texel that a masked triangle touches, matching the GPU's conservative rasterization.
+	 */
+	private void RasterizeMask(TextureMask mask, Size2 size, byte[] coverage) {
+		var uvs = mask.GetMaskVertices();
+		var indices = mask.GetMaskTriangleIndices();
+		int triangleCount = indices.Count / 3;
+
+		Vector2 ToPixel(int idx) {
+			Vector2 uv = uvs[idx];
+			return new Vector2(uv.X % 1 * size.Width, (1 - uv.Y % 1) * size.Height);
+		}
+
+		//concurrent writes only ever store 1, so triangles can be rasterized in parallel without locking
+		Parallel.For(0, triangleCount, parallelOptions, triangleIdx => {
+			RasterizeTriangle(
+				ToPixel(indices[triangleIdx * 3 + 0]),
+				ToPixel(indices[triangleIdx * 3 + 1]),
+				ToPixel(indices[triangleIdx * 3 + 2]),
+				size, coverage);
+		});
+	}
+
+	private static void RasterizeTriangle(Vector2 p0, Vector2 p1, Vector2 p2, Size2 size, byte[] coverage) {
+		float area = (p1.X - p0.X) * (p2.Y - p0.Y) - (p1.Y - p0.Y) * (p2.X - p0.X);
+		if (area == 0) {
+			return;
+		}
+		float sign = Math.Sign(area);
+
+		int minX = Math.Max((int) Math.Floor(Math.Min(p0.X, Math.Min(p1.X, p2.X))), 0);
+		int minY = Math.Max((int) Math.Floor(Math.Min(p0.Y, Math.Min(p1.Y, p2.Y))), 0);
+		int maxX = Math.Min((int) Math.Floor(Math.Max(p0.X, Math.Max(p1.X, p2.X))), size.Width - 1);
+		int maxY = Math.Min((int) Math.Floor(Math.Max(p0.Y, Math.Max(p1.Y, p2.Y))), size.Height - 1);
+
+		//edge functions a*x + b*y + c, oriented to be non-negative inside the triangle
+		Vector3 Edge(Vector2 from, Vector2 to) {
+			float a = -(to.Y - from.Y) * sign;
+			float b = (to.X - from.X) * sign;
+			return new Vector3(a, b, -(a * from.X + b * from.Y));
+		}
+		var e0 = Edge(p0, p1);
+		var e1 = Edge(p1, p2);
+		var e2 = Edge(p2, p0);
+
+		//a texel overlaps the triangle if, for every edge, its corner furthest inside is inside
+		bool Overlaps(Vector3 e, int x, int y) {
+			float cornerX = e.X > 0 ? x + 1 : x;
+			float cornerY = e.Y > 0 ? y + 1 : y;
+			return e.X * cornerX + e.Y * cornerY + e.Z >= 0;
+		}
+
+		for (int y = minY; y <= maxY; ++y) {
+			int rowOffset = y * size.Width;
+			for (int x = minX; x <= maxX; ++x) {
+				if (Overlaps(e0, x, y) && Overlaps(e1, x, y) && Overlaps(e2, x, y)) {
+					coverage[rowOffset + x] = 1;
+				}
+			}
+		}
+	}
+
+	/**
+	 * Copies the image with alpha set to coverage and color premultiplied by it. Coverage is 0 or 1, so this is exact.
+	 */
+	private unsafe Level MakePremultipliedLevel(Size2 size, byte[] coverage, DataBox imageData) {
+		var level = new Level(size.Width, size.Height);
+		var source = imageData.DataPointer;
+		int rowPitch = imageData.RowPitch;
+
+		Parallel.For(0, size.Height, parallelOptions, y => {
+			byte* sourceRow = (byte*) source + y * rowPitch;
+			int rowOffset = y * size.Width;
+			for (int x = 0; x < size.Width; ++x) {
+				int destIdx = (rowOffset + x) * BytesPerPixel;
+				if (coverage[rowOffset + x] != 0) {
+					level.Pixels[destIdx + 0] = sourceRow[x * BytesPerPixel + 0];
+					level.Pixels[destIdx + 1] = sourceRow[x * BytesPerPixel + 1];
+					level.Pixels[destIdx + 2] = sourceRow[x * BytesPerPixel + 2];
+					level.Pixels[destIdx + AlphaOffset] = 0xff;
+				}
+			}
+		});
+
+		return level;
+	}
+
+	/**
+	 * Produces the next mip with a 2x2 box filter, the same as GenerateMips does for UNorm textures.
+	 */
+	private Level Downsample(Level source) {
+		var dest = new Level(Math.Max(source.Width / 2, 1), Math.Max(source.Height / 2, 1));
+
+		Parallel.For(0, dest.Height, parallelOptions, y => {
+			int sourceY0 = Math.Min(y * 2, source.Height - 1);
+			int sourceY1 = Math.Min(y * 2 + 1, source.Height - 1);
+			for (int x = 0; x < dest.Width; ++x) {
+				int sourceX0 = Math.Min(x * 2, source.Width - 1);
+				int sourceX1 = Math.Min(x * 2 + 1, source.Width - 1);
+				int idx00 = (sourceY0 * source.Width + sourceX0) * BytesPerPixel;
+				int idx01 = (sourceY0 * source.Width + sourceX1) * BytesPerPixel;
+				int idx10 = (sourceY1 * source.Width + sourceX0) * BytesPerPixel;
+				int idx11 = (sourceY1 * source.Width + sourceX1) * BytesPerPixel;
+				int destIdx = (y * dest.Width + x) * BytesPerPixel;
+				for (int channel = 0; channel < BytesPerPixel; ++channel) {
+					int sum = source.Pixels[idx00 + channel] + source.Pixels[idx01 + channel] + source.Pixels[idx10 + channel] + source.Pixels[idx11 + channel];
+					dest.Pixels[destIdx + channel] = (byte) ((sum + 2) / 4);
+				}
+			}
+		});
+
+		return dest;
+	}
+
+	private unsafe void Composite(List<Level> levels, DataBox imageData) {
+		var dest = imageData.DataPointer;
+		int rowPitch = imageData.RowPitch;
+		int width = levels[0].Width;
+		const float Scale = 1 / 255f;
+
+		Parallel.For(0, levels[0].Height, parallelOptions, y => {
+			byte* destRow = (byte*) dest + y * rowPitch;
+			for (int x = 0; x < width; ++x) {
+				float r = 0, g = 0, b = 0, a = 0;
+				for (int levelIdx = 0; levelIdx < levels.Count; ++levelIdx) {
+					var level = levels[levelIdx];
+					int sampleX = x >> levelIdx;
+					int sampleY = y >> levelIdx;
+					if (sampleX >= level.Width || sampleY >= level.Height) {
+						//out-of-bounds loads return 0, and will for every smaller level too
+						break;
+					}
+
+					int idx = (sampleY * level.Width + sampleX) * BytesPerPixel;
+					float weight = (1 - a) * Scale;
+					r += level.Pixels[idx + 0] * weight;
+					g += level.Pixels[idx + 1] * weight;
+					b += level.Pixels[idx + 2] * weight;
+					a += level.Pixels[idx + AlphaOffset] * weight;
+
+					if (a >= 1) {
+						break;
+					}
+				}
+
+				byte* destPixel = destRow + x * BytesPerPixel;
+				if (a > 0) {
+					destPixel[0] = ToUnorm(r / a);
+					destPixel[1] = ToUnorm(g / a);
+					destPixel[2] = ToUnorm(b / a);
+					destPixel[AlphaOffset] = 0xff;
+				} else {
+					//nothing in the mask at all: the GPU writes 0/0, which stores as 0
+					destPixel[0] = 0;
+					destPixel[1] = 0;
+					destPixel[2] = 0;
+					destPixel[AlphaOffset] = 0;
+				}
+			}
+		});
+	}
+
+	private static byte ToUnorm(float value) {
+		return (byte) (Math.Min(Math.Max(value, 0), 1) * 255 + 0.5f);
+	}
+}
@@ -0,0 +1,10 @@
+using SharpDX;
+using System;
+
+/**
+ * Fills the texels outside a texture's UV islands with colors bled outward from the islands, so that filtering and
+ * mipmapping near island edges doesn't pick up unrelated colors.
+ */
+public interface ITextureDilator : IDisposable {
+	void Dilate(MultiUvTextureMask mask, Size2 size, bool isLinear, DataBox imageData);
+}
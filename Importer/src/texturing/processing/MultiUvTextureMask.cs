@@ -1,4 +1,6 @@
 ﻿using System.Collections.Generic;
+using System.IO;
+using System.Linq;
 
 public class MultiUvTextureMask {
 	private readonly Dictionary<UvSet, TextureMask> masksByUvSet = new Dictionary<UvSet, TextureMask>();
@@ -12,4 +14,12 @@ public class MultiUvTextureMask {
 			masksByUvSet.Add(mask.UvSet, mask);
 		}
 	}
+
+	public void WriteCacheKey(BinaryWriter writer) {
+		var masks = PerUvMasks.OrderBy(mask => mask.UvSet.Name).ToList();
+		writer.Write(masks.Count);
+		foreach (var mask in masks) {
+			mask.WriteCacheKey(writer);
+		}
+	}
 }
@@ -2,7 +2,7 @@ using System;
 using SharpDX;
 using SharpDX.Direct3D11;
 
-public class TextureDilator : IDisposable {
+public class TextureDilator : ITextureDilator {
 	private const int ShaderNumThreadsPerDim = 16;
 
 	private readonly Device device;
@@ -1,6 +1,7 @@
 using SharpDX;
 using System;
 using System.Collections.Generic;
+using System.IO;
 
 public class TextureMask {
 	public static TextureMask Make(UvSet uvSet, int[] surfaceMap, int surfaceIdx) {
@@ -57,4 +58,17 @@ public class TextureMask {
 	public Vector2[] GetMaskVertices() {
 		return uvSet.Uvs;
 	}
+
+	/**
+	 * Writes the UVs of every masked triangle, which is everything the rendered mask depends on.
+	 */
+	public void WriteCacheKey(BinaryWriter writer) {
+		var triangleIndices = GetMaskTriangleIndices();
+		writer.Write(triangleIndices.Count);
+		foreach (int idx in triangleIndices) {
+			Vector2 uv = uvSet.Uvs[idx];
+			writer.Write(uv.X);
+			writer.Write(uv.Y);
+		}
+	}
 }
@@ -4,6 +4,10 @@ using System;
 using System.Collections.Generic;
 using System.Diagnostics;
 using System.IO;
+using System.Linq;
+using System.Security.Cryptography;
+using System.Threading;
+using System.Threading.Tasks;
 
 public enum TextureProcessingType {
 	Color, SingleChannel, Normal, Bump
@@ -50,6 +54,45 @@ class TextureProcessingSettings {
 		throw new InvalidOperationException("texture type conflict");
 	}
 
+	private string ComputeKey(bool compress, string dilatorKind, bool includeFile) {
+		using (var sha = SHA256.Create()) {
+			using (var hashStream = new CryptoStream(Stream.Null, sha, CryptoStreamMode.Write)) {
+				var writer = new BinaryWriter(hashStream);
+				writer.Write(TextureProcessor.CacheVersion);
+				writer.Write((int) type);
+				writer.Write(isLinear);
+				writer.Write(compress);
+				writer.Write(dilatorKind);
+				mask.WriteCacheKey(writer);
+				writer.Flush();
+
+				if (includeFile) {
+					using (var fileStream = file.OpenRead()) {
+						fileStream.CopyTo(hashStream);
+					}
+				}
+
+				hashStream.FlushFinalBlock();
+			}
+			return BitConverter.ToString(sha.Hash).Replace("-", "").ToLowerInvariant();
+		}
+	}
+
+	/**
+	 * Hashes the source file's contents together with every setting that affects the processed output, including which
+	 * dilator produced it.
+	 */
+	public string ComputeCacheKey(bool compress, string dilatorKind) {
+		return ComputeKey(compress, dilatorKind, true);
+	}
+
+	/**
+	 * Hashes every setting that affects the processed output, but not the source file.
+	 */
+	public string ComputeSettingsKey(bool compress, string dilatorKind) {
+		return ComputeKey(compress, dilatorKind, false);
+	}
+
 	public void Merge(FileInfo file, TextureProcessingType type, bool isLinear, TextureMask mask) {
 		if (this.file.FullName != file.FullName) {
 			throw new InvalidOperationException("texture file conflict");
@@ -65,22 +108,60 @@ class TextureProcessingSettings {
 	}
 }
 
+/**
+ * Imports the textures registered by material and shape dumpers.
+ *
+ * Each texture is processed as a chain of jobs (load and dilate, convert, compress) and the chains of different
+ * textures run concurrently. Dilation uses the device's immediate context so those jobs are serialized; everything else
+ * runs on a bounded pool of workers. Registered actions run once all textures are done. Dilation can instead run on the
+ * CPU, which is also used when there is no device; it parallelizes internally, so its jobs stay serialized too.
+ *
+ * If a cache directory is supplied, each processed texture is also stored there under a hash of its source file,
+ * settings and mask, and later imports of the same texture copy the cached result instead of processing it again.
+ *
+ * If a manifest directory is supplied, an existing processed texture is only kept while its manifest says its source
+ * file and settings are unchanged; otherwise it is processed again. Without one, existing textures are always kept.
+ */
 public class TextureProcessor {
+	//bump this when a change to the processing would change its output, to invalidate cached results
+	public const int CacheVersion = 1;
+
 	private readonly Device device;
 	private readonly ShaderCache shaderCache;
 	private readonly DirectoryInfo destinationFolder;
 	private readonly string path;
 	private readonly bool compress;
+	private readonly int maxDegreeOfParallelism;
+	private readonly DirectoryInfo cacheDirectory;
+	private readonly bool dilateOnCpu;
+	private readonly DirectoryInfo manifestDirectory;
 	
 	private readonly Dictionary<string, TextureProcessingSettings> settingsByName = new Dictionary<string, TextureProcessingSettings>();
 	private readonly List<Action> actions = new List<Action>();
+	private readonly List<Action> completionActions = new List<Action>();
 
-	public TextureProcessor(Device device, ShaderCache shaderCache, DirectoryInfo destinationFolder, string path, bool compress) {
+	public TextureProcessor(Device device, ShaderCache shaderCache, DirectoryInfo destinationFolder, string path, bool compress, int maxDegreeOfParallelism = -1, DirectoryInfo cacheDirectory = null, bool dilateOnCpu = false, DirectoryInfo manifestDirectory = null) {
 		this.device = device;
 		this.shaderCache = shaderCache;
 		this.destinationFolder = destinationFolder;
 		this.path = path;
 		this.compress = compress;
+		this.maxDegreeOfParallelism = maxDegreeOfParallelism;
+		this.cacheDirectory = cacheDirectory;
+		this.dilateOnCpu = dilateOnCpu;
+		this.manifestDirectory = manifestDirectory;
+	}
+
+	private bool UsesCpuDilator => dilateOnCpu || device == null;
+
+	private string DilatorKind => UsesCpuDilator ? "cpu" : "gpu";
+
+	private ITextureDilator MakeDilator() {
+		if (UsesCpuDilator) {
+			return new CpuTextureDilator(maxDegreeOfParallelism);
+		} else {
+			return new TextureDilator(device, shaderCache);
+		}
 	}
 
 	private static void CompressTexture(FileInfo file, TextureProcessingType type, bool isLinear) {
@@ -117,62 +198,176 @@ public class TextureProcessor {
 		actions.Add(action);
 	}
 
-	private void ImportTexture(string name, TextureProcessingSettings settings) {
-		string destinationPath = Path.Combine(destinationFolder.FullName, name + ".dds");
-		if (new FileInfo(destinationPath).Exists) {
-			return;
+	/**
+	 * Registers an action to run once all textures are done and all registered actions have run.
+	 */
+	public void RegisterCompletionAction(Action action) {
+		completionActions.Add(action);
+	}
+
+	private JobGraph.Job[] AddImportJobs(JobGraph graph, ITextureDilator dilator, string name, FileInfo destinationFile, TextureProcessingSettings settings, FileInfo cacheFile, IncrementalStage stage) {
+		var inputs = new [] { settings.File.FullName };
+
+		if (destinationFile.Exists) {
+			//copied from the cache
+			stage?.Complete(inputs);
+			return new JobGraph.Job[0];
 		}
 
-		Console.WriteLine($"importing texture '{name}'...");
-		
-		using (var image = UnmanagedRgbaImage.Load(settings.File))  {
-			using (var dilator = new TextureDilator(device, shaderCache)) {
-				dilator.Dilate(settings.Mask, image.Size, settings.IsLinear, image.DataBox);
-			}
+		UnmanagedRgbaImage image = null;
 
-			InputOptions input = new InputOptions();
-			input.SetFormat(InputFormat.BGRA_8UB);
-			input.SetTextureLayout(TextureType.Texture2D, image.Size.Width, image.Size.Height, 1);
-			float gamma = settings.IsLinear ? 1f : 2.2f;
-			input.SetGamma(gamma, gamma);
-			input.SetMipmapData(image.PixelData, image.Size.Width, image.Size.Height, 1, 0, 0);
-			input.SetAlphaMode(AlphaMode.None);
-
-			input.SetMipmapGeneration(true);
-			input.SetMipmapFilter(MipmapFilter.Kaiser);
-			input.SetKaiserParameters(3, 4, 1);
-
-			if (settings.Type == TextureProcessingType.Bump) {
-				input.SetConvertToNormalMap(true);
-				input.SetNormalFilter(1, 0, 0, 0);
-				input.SetHeightEvaluation(1, 1, 1, 0);
-			} else if (settings.Type == TextureProcessingType.Normal) {
-				input.SetNormalMap(true);
+		//loading is done in the serialized job too, so that no more images are in memory than there are workers to convert them
+		var dilateJob = graph.AddSerialized(name, "load-and-dilate", () => {
+			Console.WriteLine($"importing texture '{name}'...");
+			image = UnmanagedRgbaImage.Load(settings.File);
+			dilator.Dilate(settings.Mask, image.Size, settings.IsLinear, image.DataBox);
+		});
+
+		var convertJob = graph.Add(name, "convert", () => {
+			using (image) {
+				ConvertTexture(image, destinationFile, settings);
 			}
+			image = null;
+		}, dilateJob);
+
+		var finalJob = convertJob;
+		if (compress) {
+			finalJob = graph.Add(name, "compress", () => {
+				CompressTexture(destinationFile, settings.Type, settings.IsLinear);
+			}, convertJob);
+		}
+
+		if (cacheFile != null) {
+			finalJob = graph.Add(name, "store", () => {
+				StoreInCache(destinationFile, cacheFile);
+			}, finalJob);
+		}
+
+		if (stage != null) {
+			finalJob = graph.Add(name, "manifest", () => {
+				stage.Complete(inputs);
+			}, finalJob);
+		}
+
+		return new [] { finalJob };
+	}
 
-			CompressionOptions compression = new CompressionOptions();
-			compression.SetQuality(Quality.Highest);
-			compression.SetFormat(Format.RGBA);
-
-			OutputOptions output = new OutputOptions();
-			destinationFolder.CreateWithParents();
-			output.SetFileName(destinationPath);
-			output.SetContainer(Container.Container_DDS10);
-			output.SetSrgbFlag(!settings.IsLinear);
-			
-			var compressor = new Compressor();
-			bool succeeded = compressor.Compress(input, compression, output);
-			if (!succeeded) {
-				throw new InvalidOperationException("texture conversion failed");
+	private static void StoreInCache(FileInfo file, FileInfo cacheFile) {
+		cacheFile.Directory.CreateWithParents();
+
+		//copy then rename so that an interrupted import can't leave a truncated file in the cache
+		var tempFile = new FileInfo(cacheFile.FullName + "." + Guid.NewGuid() + ".tmp");
+		file.CopyTo(tempFile.FullName);
+		try {
+			tempFile.MoveTo(cacheFile.FullName);
+		} catch (IOException) {
+			//another import stored the same result first
+			tempFile.Delete();
+		}
+	}
+
+	/**
+	 * Deletes each processed texture whose manifest is missing or out of date. Returns the stages whose manifests need
+	 * to be written once the texture has been processed again.
+	 */
+	private Dictionary<string, IncrementalStage> InvalidateChangedTextures(Dictionary<string, FileInfo> destinationFilesByName) {
+		var stagesByName = new Dictionary<string, IncrementalStage>();
+		if (manifestDirectory == null) {
+			return stagesByName;
+		}
+
+		foreach (var entry in destinationFilesByName) {
+			string name = entry.Key;
+			var stage = new IncrementalStage(
+				manifestDirectory.File(name + ".json"),
+				settingsByName[name].ComputeSettingsKey(compress, DilatorKind),
+				entry.Value);
+			if (!stage.IsUpToDate()) {
+				stage.Invalidate();
+				stagesByName.Add(name, stage);
 			}
-			
-			//force the previous output handler to be destructed so that the file is flushed and closed
-			output.SetFileName("nul");
+		}
+
+		return stagesByName;
+	}
+
+	/**
+	 * Looks up each texture that needs processing in the cache, copying the hits to their destination. Returns the
+	 * cache files that misses should be stored to.
+	 */
+	private Dictionary<string, FileInfo> ApplyCache(Dictionary<string, FileInfo> destinationFilesByName, out int hitCount) {
+		var cacheFilesByName = new Dictionary<string, FileInfo>();
+		if (cacheDirectory == null) {
+			hitCount = 0;
+			return cacheFilesByName;
+		}
+
+		var pending = destinationFilesByName
+			.Where(entry => !entry.Value.Exists)
+			.Select(entry => entry.Key)
+			.ToList();
 
-			if (compress) {
-				CompressTexture(new FileInfo(destinationPath), settings.Type, settings.IsLinear);
+		string dilatorKind = DilatorKind;
+		int hits = 0;
+		var parallelOptions = new ParallelOptions { MaxDegreeOfParallelism = maxDegreeOfParallelism };
+		Parallel.ForEach(pending, parallelOptions, name => {
+			string key = settingsByName[name].ComputeCacheKey(compress, dilatorKind);
+			var cacheFile = cacheDirectory.File(key + ".dds");
+			if (cacheFile.Exists) {
+				var destinationFile = destinationFilesByName[name];
+				destinationFile.Directory.CreateWithParents();
+				cacheFile.CopyTo(destinationFile.FullName, true);
+				Interlocked.Increment(ref hits);
+			} else {
+				lock (cacheFilesByName) {
+					cacheFilesByName.Add(name, cacheFile);
+				}
 			}
+		});
+
+		hitCount = hits;
+		return cacheFilesByName;
+	}
+
+	private void ConvertTexture(UnmanagedRgbaImage image, FileInfo destinationFile, TextureProcessingSettings settings) {
+		InputOptions input = new InputOptions();
+		input.SetFormat(InputFormat.BGRA_8UB);
+		input.SetTextureLayout(TextureType.Texture2D, image.Size.Width, image.Size.Height, 1);
+		float gamma = settings.IsLinear ? 1f : 2.2f;
+		input.SetGamma(gamma, gamma);
+		input.SetMipmapData(image.PixelData, image.Size.Width, image.Size.Height, 1, 0, 0);
+		input.SetAlphaMode(AlphaMode.None);
+
+		input.SetMipmapGeneration(true);
+		input.SetMipmapFilter(MipmapFilter.Kaiser);
+		input.SetKaiserParameters(3, 4, 1);
+
+		if (settings.Type == TextureProcessingType.Bump) {
+			input.SetConvertToNormalMap(true);
+			input.SetNormalFilter(1, 0, 0, 0);
+			input.SetHeightEvaluation(1, 1, 1, 0);
+		} else if (settings.Type == TextureProcessingType.Normal) {
+			input.SetNormalMap(true);
+		}
+
+		CompressionOptions compression = new CompressionOptions();
+		compression.SetQuality(Quality.Highest);
+		compression.SetFormat(Format.RGBA);
+
+		OutputOptions output = new OutputOptions();
+		destinationFile.Directory.CreateWithParents();
+		output.SetFileName(destinationFile.FullName);
+		output.SetContainer(Container.Container_DDS10);
+		output.SetSrgbFlag(!settings.IsLinear);
+		
+		var compressor = new Compressor();
+		bool succeeded = compressor.Compress(input, compression, output);
+		if (!succeeded) {
+			throw new InvalidOperationException("texture conversion failed");
 		}
+		
+		//force the previous output handler to be destructed so that the file is flushed and closed
+		output.SetFileName("nul");
 	}
 
 	public string RegisterForProcessing(FileInfo textureFile, TextureProcessingType type, bool isLinear, TextureMask mask) {
@@ -191,12 +386,44 @@ public class TextureProcessor {
 		return path + "/" + name;
 	}
 
-	public void ImportAll() {
-		foreach (var entry in settingsByName) {
-			ImportTexture(entry.Key, entry.Value);
+	public JobGraphStatistics ImportAll() {
+		//several names could in principle map to the same file, so deduplicate on the destination path
+		var destinationFilesByName = new Dictionary<string, FileInfo>();
+		var seenDestinations = new HashSet<string>();
+		foreach (var name in settingsByName.Keys) {
+			var destinationFile = destinationFolder.File(name + ".dds");
+			if (seenDestinations.Add(destinationFile.FullName)) {
+				destinationFilesByName.Add(name, destinationFile);
+			}
 		}
-		foreach (var action in actions) {
-			action.Invoke();
+
+		var stagesByName = InvalidateChangedTextures(destinationFilesByName);
+
+		var cacheFilesByName = ApplyCache(destinationFilesByName, out int cacheHitCount);
+
+		var graph = new JobGraph();
+
+		using (var dilator = MakeDilator()) {
+			var allTextureJobs = new List<JobGraph.Job>();
+			foreach (var entry in destinationFilesByName) {
+				string name = entry.Key;
+				var destinationFile = entry.Value;
+				destinationFile.Refresh();
+				cacheFilesByName.TryGetValue(name, out var cacheFile);
+				stagesByName.TryGetValue(name, out var stage);
+				allTextureJobs.AddRange(AddImportJobs(graph, dilator, name, destinationFile, settingsByName[name], cacheFile, stage));
+			}
+
+			var actionJobs = actions
+				.Select(action => graph.Add("action", "save", action, allTextureJobs.ToArray()))
+				.ToArray();
+			foreach (var action in completionActions) {
+				graph.Add("completion", "save", action, allTextureJobs.Concat(actionJobs).ToArray());
+			}
+
+			var statistics = graph.Run(maxDegreeOfParallelism);
+			Console.WriteLine($"texture processing: {cacheHitCount} cache hits; {statistics}");
+			return statistics;
 		}
 	}
 }
@@ -31,11 +31,82 @@ public class PackedLists<T> {
 		return new PackedLists<T>(segments, elems);
 	}
 
-	[ProtoMember(1)]
 	public ArraySegment[] Segments { get; private set; }
+	public T[] Elems { get; private set; }
+
+	//Segments and blittable elements are persisted as raw blocks so loading them is a block copy instead of a
+	//per-element decode. When the message is serialized with RawArrayBlocks as its context, the blocks are added just
+	//before it's written, they follow the message and members 5 and 6 hold their offsets, so they're copied straight
+	//out of the loaded file once it has been read; otherwise members 3 and 4 hold the blocks inline. Members 1 and 2
+	//are the element-by-element encoding, which is still read from older files and is still written for elements
+	//that aren't blittable.
+	[ProtoMember(1)]
+	private ArraySegment[] ElementwiseSegments {
+		get { return null; }
+		set { Segments = value; }
+	}
 
 	[ProtoMember(2)]
-	public T[] Elems { get; private set; }
+	private T[] ElementwiseElems {
+		get { return RawArrayEncoding.IsBlittable<T>() ? null : Elems; }
+		set { Elems = value; }
+	}
+
+	[ProtoMember(3)]
+	private byte[] RawSegments {
+		get { return segmentsBlockOffset == null ? RawArrayEncoding.Encode(Segments) : null; }
+		set { Segments = RawArrayEncoding.Decode<ArraySegment>(value); }
+	}
+
+	[ProtoMember(4)]
+	private byte[] RawElems {
+		get { return elemsBlockOffset == null && RawArrayEncoding.IsBlittable<T>() ? RawArrayEncoding.Encode(Elems) : null; }
+		set { Elems = RawArrayEncoding.Decode<T>(value); }
+	}
+
+	//only set while the lists are being written or read with raw array blocks, so the same lists mustn't be written
+	//with blocks on two threads at once
+	[ProtoMember(5)]
+	private long? segmentsBlockOffset;
+
+	[ProtoMember(6)]
+	private long? elemsBlockOffset;
+
+	[ProtoBeforeSerialization]
+	private void AddBlocks(SerializationContext context) {
+		var blocks = context?.Context as RawArrayBlocks;
+		if (blocks == null || !blocks.IsWriting) {
+			ClearBlockOffsets();
+			return;
+		}
+		segmentsBlockOffset = blocks.Add(Segments);
+		elemsBlockOffset = RawArrayEncoding.IsBlittable<T>() ? blocks.Add(Elems) : null;
+	}
+
+	[ProtoAfterSerialization]
+	private void ClearBlockOffsets() {
+		segmentsBlockOffset = null;
+		elemsBlockOffset = null;
+	}
+
+	[ProtoAfterDeserialization]
+	private void ReadBlocks(SerializationContext context) {
+		if (segmentsBlockOffset == null && elemsBlockOffset == null) {
+			return;
+		}
+
+		var blocks = context?.Context as RawArrayBlocks;
+		if (blocks == null || blocks.IsWriting) {
+			throw new InvalidOperationException("raw array block offset read without raw array blocks");
+		}
+		if (segmentsBlockOffset != null) {
+			Segments = blocks.Read<ArraySegment>(segmentsBlockOffset.Value);
+		}
+		if (elemsBlockOffset != null) {
+			Elems = blocks.Read<T>(elemsBlockOffset.Value);
+		}
+		ClearBlockOffsets();
+	}
 
 	public int Count => Segments.Length;
 	
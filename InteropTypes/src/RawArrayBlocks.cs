@@ -0,0 +1,82 @@
+using System;
+using System.IO;
+using System.Runtime.InteropServices;
+
+/**
+ * Raw array blocks stored after a protobuf message in the same file, so that loading copies each array straight out of
+ * the file's mapped view instead of first decoding it into an intermediate byte array.
+ *
+ * The blocks are passed as the context of the serialization. PackedLists adds its blittable arrays to them just before
+ * it's written and refers to them by offset; once read, it copies them out of the blocks at those offsets.
+ */
+public class RawArrayBlocks {
+	public const int Alignment = 16;
+
+	private readonly MemoryStream writeStream;
+	private readonly IntPtr readPointer;
+	private readonly long readSize;
+
+	private RawArrayBlocks(MemoryStream writeStream, IntPtr readPointer, long readSize) {
+		this.writeStream = writeStream;
+		this.readPointer = readPointer;
+		this.readSize = readSize;
+	}
+
+	public static RawArrayBlocks MakeForWriting() {
+		return new RawArrayBlocks(new MemoryStream(), IntPtr.Zero, 0);
+	}
+
+	/**
+	 * Reads blocks from memory, which must stay valid while they're active.
+	 */
+	public static RawArrayBlocks MakeForReading(IntPtr pointer, long size) {
+		return new RawArrayBlocks(null, pointer, size);
+	}
+
+	public bool IsWriting => writeStream != null;
+
+	public long Size => writeStream != null ? writeStream.Length : readSize;
+
+	public long? Add<T>(T[] array) {
+		if (writeStream == null) {
+			throw new InvalidOperationException("blocks are being read");
+		}
+		if (array == null) {
+			return null;
+		}
+
+		long offset = writeStream.Length;
+		byte[] bytes = RawArrayEncoding.Encode(array);
+		writeStream.Write(bytes, 0, bytes.Length);
+
+		int padding = (int) ((Alignment - writeStream.Length % Alignment) % Alignment);
+		writeStream.Write(new byte[padding], 0, padding);
+
+		return offset;
+	}
+
+	public T[] Read<T>(long offset) {
+		if (writeStream != null) {
+			throw new InvalidOperationException("blocks are being written");
+		}
+		if (offset < 0 || offset + RawArrayEncoding.HeaderSize > readSize) {
+			throw new InvalidOperationException("raw array block is out of range");
+		}
+
+		IntPtr blockPointer = readPointer + (int) offset;
+		int elementSize = Marshal.ReadInt32(blockPointer, 0);
+		int elementCount = Marshal.ReadInt32(blockPointer, sizeof(int));
+		long byteCount = RawArrayEncoding.CheckHeader<T>(elementSize, elementCount);
+		if (offset + RawArrayEncoding.HeaderSize + byteCount > readSize) {
+			throw new InvalidOperationException("raw array block is out of range");
+		}
+
+		T[] array = new T[elementCount];
+		RawArrayEncoding.CopyToArray(blockPointer + RawArrayEncoding.HeaderSize, array, byteCount);
+		return array;
+	}
+
+	public void WriteTo(Stream stream) {
+		writeStream.WriteTo(stream);
+	}
+}
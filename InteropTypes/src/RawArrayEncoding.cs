@@ -0,0 +1,139 @@
+using System;
+using System.Runtime.InteropServices;
+
+/**
+ * Encodes arrays of blittable structs as a raw little-endian block: an 8-byte header containing the element size and
+ * element count, followed by the elements' bytes. Decoding is a single block copy with no per-element work.
+ */
+public static class RawArrayEncoding {
+	public const int HeaderSize = sizeof(int) + sizeof(int);
+
+	private static class BlittabilityCache<T> {
+		public static readonly bool IsBlittable = CheckBlittable();
+
+		private static bool CheckBlittable() {
+			if (!typeof(T).IsValueType) {
+				return false;
+			}
+
+			try {
+				//only arrays of blittable types can be pinned
+				GCHandle.Alloc(new T[1], GCHandleType.Pinned).Free();
+				return true;
+			} catch (ArgumentException) {
+				return false;
+			}
+		}
+	}
+
+	public static bool IsBlittable<T>() {
+		return BlittabilityCache<T>.IsBlittable;
+	}
+
+	private static void CheckSupported<T>() {
+		if (!BitConverter.IsLittleEndian) {
+			throw new NotSupportedException("raw array encoding requires a little-endian platform");
+		}
+		if (!IsBlittable<T>()) {
+			throw new InvalidOperationException($"{typeof(T).Name} is not blittable");
+		}
+	}
+
+	public static byte[] Encode<T>(T[] array) {
+		if (array == null) {
+			return null;
+		}
+
+		CheckSupported<T>();
+
+		int elementSize = Marshal.SizeOf<T>();
+		int byteCount = checked(elementSize * array.Length);
+		byte[] bytes = new byte[HeaderSize + byteCount];
+		BitConverter.GetBytes(elementSize).CopyTo(bytes, 0);
+		BitConverter.GetBytes(array.Length).CopyTo(bytes, sizeof(int));
+
+		if (byteCount > 0) {
+			var handle = GCHandle.Alloc(array, GCHandleType.Pinned);
+			try {
+				Marshal.Copy(handle.AddrOfPinnedObject(), bytes, HeaderSize, byteCount);
+			} finally {
+				handle.Free();
+			}
+		}
+
+		return bytes;
+	}
+
+	/**
+	 * Checks a block header against the element type and returns the size of the block's elements in bytes.
+	 */
+	public static long CheckHeader<T>(int elementSize, int elementCount) {
+		CheckSupported<T>();
+
+		if (elementSize != Marshal.SizeOf<T>()) {
+			throw new InvalidOperationException($"raw array element size {elementSize} does not match size of {typeof(T).Name}");
+		}
+		if (elementCount < 0) {
+			throw new InvalidOperationException("raw array element count is negative");
+		}
+
+		return (long) elementSize * elementCount;
+	}
+
+	public static T[] Decode<T>(byte[] bytes) {
+		if (bytes == null) {
+			return null;
+		}
+
+		if (bytes.Length < HeaderSize) {
+			throw new InvalidOperationException("raw array block is missing its header");
+		}
+
+		int elementSize = BitConverter.ToInt32(bytes, 0);
+		int elementCount = BitConverter.ToInt32(bytes, sizeof(int));
+		long byteCount = CheckHeader<T>(elementSize, elementCount);
+		if (bytes.Length != HeaderSize + byteCount) {
+			throw new InvalidOperationException("raw array block size does not match its header");
+		}
+
+		T[] array = new T[elementCount];
+		if (byteCount > 0) {
+			var handle = GCHandle.Alloc(array, GCHandleType.Pinned);
+			try {
+				Marshal.Copy(bytes, HeaderSize, handle.AddrOfPinnedObject(), (int) byteCount);
+			} finally {
+				handle.Free();
+			}
+		}
+
+		return array;
+	}
+
+	/**
+	 * Copies the bytes of a block's elements from unmanaged memory straight into an array of a blittable type.
+	 */
+	public static void CopyToArray<T>(IntPtr source, T[] array, long byteCount) {
+		if (byteCount == 0) {
+			return;
+		}
+
+		var handle = GCHandle.Alloc(array, GCHandleType.Pinned);
+		try {
+			unsafe {
+				byte* sourcePtr = (byte*) source;
+				byte* destPtr = (byte*) handle.AddrOfPinnedObject();
+
+				//net452 has no Buffer.MemoryCopy, so copy a word at a time
+				long i = 0;
+				for (; i + sizeof(long) <= byteCount; i += sizeof(long)) {
+					*(long*) (destPtr + i) = *(long*) (sourcePtr + i);
+				}
+				for (; i < byteCount; ++i) {
+					destPtr[i] = sourcePtr[i];
+				}
+			}
+		} finally {
+			handle.Free();
+		}
+	}
+}
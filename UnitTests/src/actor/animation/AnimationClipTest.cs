@@ -0,0 +1,97 @@
+using Microsoft.VisualStudio.TestTools.UnitTesting;
+using SharpDX;
+using System;
+using System.Collections.Generic;
+using System.IO;
+using System.Linq;
+
+[TestClass]
+public class AnimationClipTest {
+	private static float AngleBetween(Quaternion a, Quaternion b) {
+		return (Quaternion.Invert(a) * b).AccurateAngle();
+	}
+
+	[TestMethod]
+	public void TestSmallestThreeRoundTrip() {
+		var rnd = new Random(0);
+		for (int i = 0; i < 1000; ++i) {
+			var q = new Quaternion((float) rnd.NextDouble() - 0.5f, (float) rnd.NextDouble() - 0.5f, (float) rnd.NextDouble() - 0.5f, (float) rnd.NextDouble() - 0.5f);
+			q.Normalize();
+
+			SmallestThreeQuaternion.Encode(q, out var word0, out var word1, out var word2);
+			var decoded = SmallestThreeQuaternion.Decode(word0, word1, word2);
+
+			Assert.AreEqual(0, AngleBetween(q, decoded), 2e-4);
+
+			//the three stored components are each within half a quantization step
+			float sign = Quaternion.Dot(q, decoded) < 0 ? -1 : 1;
+			int largestIdx = Enumerable.Range(0, 4).OrderByDescending(idx => Math.Abs(q[idx])).First();
+			for (int idx = 0; idx < 4; ++idx) {
+				if (idx != largestIdx) {
+					Assert.AreEqual(sign * q[idx], decoded[idx], SmallestThreeQuaternion.MaxComponentError + 1e-6f);
+				}
+			}
+		}
+	}
+
+	private static List<Pose> MakePoses(int boneCount, int frameCount) {
+		return Enumerable.Range(0, frameCount)
+			.Select(frameIdx => {
+				var boneRotations = Enumerable.Range(0, boneCount)
+					.Select(boneIdx => Quaternion.RotationAxis(Vector3.Normalize(new Vector3(1, boneIdx, 2)), (float) Math.Sin(0.1 * frameIdx * (boneIdx + 1))))
+					.ToArray();
+				return new Pose(new Vector3(frameIdx, 0, 0), boneRotations);
+			})
+			.ToList();
+	}
+
+	[TestMethod]
+	public void TestSaveAndSample() {
+		var poses = MakePoses(5, 100);
+		float maxError = 1e-3f;
+
+		var file = new FileInfo(Path.GetTempFileName());
+		try {
+			AnimationClip.Save(file, poses, maxError);
+
+			using (var clip = AnimationClip.Open(UnpackedArchiveFile.Make(file))) {
+				Assert.AreEqual(5, clip.BoneCount);
+				Assert.AreEqual(100, clip.FrameCount);
+
+				for (int frameIdx = 0; frameIdx < poses.Count; ++frameIdx) {
+					var pose = clip.GetPose(frameIdx);
+					MathAssert.AreEqual(poses[frameIdx].RootTranslation, pose.RootTranslation, 0);
+					for (int boneIdx = 0; boneIdx < 5; ++boneIdx) {
+						Assert.AreEqual(0, AngleBetween(poses[frameIdx].BoneRotations[boneIdx], pose.BoneRotations[boneIdx]), maxError + 2e-4);
+					}
+				}
+
+				//interpolation wraps from the last frame back to the first
+				var blender = new PoseBlender(5);
+				clip.Sample(99.5f, 1, blender);
+				MathAssert.AreEqual(new Vector3(49.5f, 0, 0), blender.GetResult().RootTranslation, 1e-4f);
+			}
+		} finally {
+			file.Delete();
+		}
+	}
+
+	[TestMethod]
+	public void TestConstantTrackIsReducedToEndpoints() {
+		var poses = Enumerable.Range(0, 50)
+			.Select(frameIdx => new Pose(Vector3.Zero, new [] { Quaternion.RotationYawPitchRoll(0.1f, 0.2f, 0.3f) }))
+			.ToList();
+
+		var file = new FileInfo(Path.GetTempFileName());
+		try {
+			AnimationClip.Save(file, poses);
+			file.Refresh();
+
+			//header, 50 translations, one track entry, two keys
+			long expectedSize = AnimationClip.HeaderSize + 50 * 12 + 8 + 2 * (2 + 6);
+			Assert.AreEqual(expectedSize, file.Length);
+		} finally {
+			file.Delete();
+		}
+	}
+}
@@ -0,0 +1,81 @@
+using Microsoft.VisualStudio.TestTools.UnitTesting;
+using System;
+using System.IO;
+using System.Linq;
+
+[TestClass]
+public class ArchivePackerTest {
+	private DirectoryInfo directory;
+	private DirectoryInfo sourceDirectory;
+
+	[TestInitialize]
+	public void Initialize() {
+		directory = new DirectoryInfo(Path.Combine(Path.GetTempPath(), "ArchivePackerTest-" + Guid.NewGuid()));
+		sourceDirectory = directory.Subdirectory("source");
+		sourceDirectory.Subdirectory("sub").CreateWithParents();
+		sourceDirectory.File("a.txt").WriteAllText("hello");
+		sourceDirectory.File("b.txt").WriteAllText("hello");
+		sourceDirectory.Subdirectory("sub").File("c.txt").WriteAllText("world");
+	}
+
+	[TestCleanup]
+	public void Cleanup() {
+		directory.Delete(true);
+	}
+
+	private static string ReadFile(PackedArchive archive, params string[] path) {
+		var record = archive.RootRecord;
+		for (int i = 0; i < path.Length - 1; ++i) {
+			record = record.Subdirectories.Single(subdirectory => subdirectory.Name == path[i]);
+		}
+		var fileRecord = record.Files.Single(file => file.Name == path[path.Length - 1]);
+		using (var reader = new StreamReader(archive.OpenStream(fileRecord))) {
+			return reader.ReadToEnd();
+		}
+	}
+
+	[TestMethod]
+	public void TestRepeatedPacksWithSamePacker() {
+		var packer = new ArchivePacker();
+
+		var firstFile = directory.File("first.archive");
+		var firstStatistics = packer.Pack(firstFile, sourceDirectory);
+		var secondFile = directory.File("second.archive");
+		var secondStatistics = packer.Pack(secondFile, sourceDirectory);
+
+		Assert.AreEqual(3, firstStatistics.FileCount);
+		Assert.AreEqual(2, firstStatistics.BlobCount);
+		Assert.AreEqual(firstStatistics.FileCount, secondStatistics.FileCount);
+		Assert.AreEqual(firstStatistics.BlobCount, secondStatistics.BlobCount);
+		CollectionAssert.AreEqual(File.ReadAllBytes(firstFile.FullName), File.ReadAllBytes(secondFile.FullName));
+
+		var incrementalStatistics = packer.PackIncremental(secondFile, sourceDirectory);
+		Assert.AreEqual(3, incrementalStatistics.FileCount);
+		Assert.AreEqual(2, incrementalStatistics.ReusedBlobCount);
+
+		using (var archive = new PackedArchive(secondFile)) {
+			Assert.AreEqual("hello", ReadFile(archive, "a.txt"));
+			Assert.AreEqual("hello", ReadFile(archive, "b.txt"));
+			Assert.AreEqual("world", ReadFile(archive, "sub", "c.txt"));
+		}
+	}
+
+	[TestMethod]
+	public void TestFailedIncrementalPackLeavesNoTempFile() {
+		var packer = new ArchivePacker();
+		var archiveFile = directory.File("test.archive");
+		packer.Pack(archiveFile, sourceDirectory);
+
+		//hold a changed source file open exclusively so that packing it fails
+		var changedFile = sourceDirectory.File("a.txt");
+		changedFile.WriteAllText("goodbye");
+		using (changedFile.Open(FileMode.Open, FileAccess.Read, FileShare.None)) {
+			Assert.ThrowsException<IOException>(() => packer.PackIncremental(archiveFile, sourceDirectory));
+		}
+
+		Assert.IsFalse(File.Exists(archiveFile.FullName + ".tmp"));
+		using (var archive = new PackedArchive(archiveFile)) {
+			Assert.AreEqual("hello", ReadFile(archive, "a.txt"));
+		}
+	}
+}
@@ -0,0 +1,98 @@
+using Microsoft.VisualStudio.TestTools.UnitTesting;
+using System;
+using System.IO;
+
+[TestClass]
+public class IncrementalStageTest {
+	private DirectoryInfo directory;
+	private FileInfo inputFile;
+	private FileInfo outputFile;
+	private FileInfo manifestFile;
+	private int runCount;
+
+	[TestInitialize]
+	public void Initialize() {
+		directory = new DirectoryInfo(Path.Combine(Path.GetTempPath(), "IncrementalStageTest-" + Guid.NewGuid()));
+		directory.Create();
+		inputFile = directory.File("input.txt");
+		outputFile = directory.File("output.txt");
+		manifestFile = directory.File("manifest.json");
+		inputFile.WriteAllText("a");
+		runCount = 0;
+	}
+
+	[TestCleanup]
+	public void Cleanup() {
+		directory.Delete(true);
+	}
+
+	private bool Run(string parameters) {
+		var stage = new IncrementalStage(manifestFile, parameters, outputFile);
+		return stage.Run(() => {
+			runCount += 1;
+			InputRecorder.Record(inputFile);
+			Assert.IsFalse(File.Exists(outputFile.FullName));
+			outputFile.WriteAllText(inputFile.ReadAllText());
+		});
+	}
+
+	[TestMethod]
+	public void TestSkipsWhenUnchanged() {
+		Assert.IsTrue(Run("p"));
+		Assert.IsFalse(Run("p"));
+		Assert.AreEqual(1, runCount);
+	}
+
+	[TestMethod]
+	public void TestRerunsWhenInputChanges() {
+		Run("p");
+		inputFile.WriteAllText("bb");
+		Assert.IsTrue(Run("p"));
+		Assert.AreEqual("bb", outputFile.ReadAllText());
+	}
+
+	[TestMethod]
+	public void TestSkipsWhenOnlyTimestampChanges() {
+		Run("p");
+		File.SetLastWriteTimeUtc(inputFile.FullName, DateTime.UtcNow.AddHours(1));
+		Assert.IsFalse(Run("p"));
+	}
+
+	[TestMethod]
+	public void TestRefreshesTimestampWhenHashMatches() {
+		Run("p");
+		var touchedTime = DateTime.UtcNow.AddHours(1);
+		File.SetLastWriteTimeUtc(inputFile.FullName, touchedTime);
+		Assert.IsFalse(Run("p"));
+
+		var manifest = ImportManifest.Load(manifestFile);
+		Assert.AreEqual(touchedTime.Ticks, manifest.Inputs[0].LastWriteTimeUtcTicks);
+		Assert.IsTrue(manifest.IsUpToDate("p", out bool hasRefreshedInputs));
+		Assert.IsFalse(hasRefreshedInputs);
+	}
+
+	[TestMethod]
+	public void TestRerunsWhenParametersChange() {
+		Run("p");
+		Assert.IsTrue(Run("q"));
+	}
+
+	[TestMethod]
+	public void TestRerunsWhenOutputIsDeleted() {
+		Run("p");
+		outputFile.Delete();
+		Assert.IsTrue(Run("p"));
+	}
+
+	[TestMethod]
+	public void TestRecordsOnlyWhileActive() {
+		using (var recorder = InputRecorder.Start()) {
+			using (var nested = InputRecorder.Start()) {
+				InputRecorder.Record(inputFile);
+				CollectionAssert.AreEqual(new [] { inputFile.FullName }, nested.Paths);
+			}
+			InputRecorder.Record(outputFile);
+			Assert.AreEqual(2, recorder.Paths.Count);
+		}
+	}
+}
@@ -1,4 +1,5 @@
 using Microsoft.VisualStudio.TestTools.UnitTesting;
+using System;
 
 [TestClass]
 public class IntegerUtilsTest {
@@ -58,4 +59,31 @@ public class IntegerUtilsTest {
 		//above range
 		Assert.AreEqual(ushort.MaxValue, IntegerUtils.ToUShort(2));
 	}
+
+	[TestMethod]
+	public void TestToHalf() {
+		Assert.AreEqual(0x0000, IntegerUtils.ToHalf(0));
+		Assert.AreEqual(0x3c00, IntegerUtils.ToHalf(1));
+		Assert.AreEqual(0x3800, IntegerUtils.ToHalf(0.5f));
+		Assert.AreEqual(0xbc00, IntegerUtils.ToHalf(-1));
+
+		//ties round to even
+		Assert.AreEqual(0x3c00, IntegerUtils.ToHalf(1 + (float) Math.Pow(2, -11)));
+		Assert.AreEqual(0x3c02, IntegerUtils.ToHalf(1 + 3 * (float) Math.Pow(2, -11)));
+
+		//subnormal
+		Assert.AreEqual(0x0001, IntegerUtils.ToHalf((float) Math.Pow(2, -24)));
+
+		//overflow
+		Assert.AreEqual(0x7c00, IntegerUtils.ToHalf(1e6f));
+	}
+
+	[TestMethod]
+	public void TestFromHalf() {
+		Assert.AreEqual(0, IntegerUtils.FromHalf(0x0000));
+		Assert.AreEqual(1, IntegerUtils.FromHalf(0x3c00));
+		Assert.AreEqual(0.5f, IntegerUtils.FromHalf(0x3800));
+		Assert.AreEqual((float) Math.Pow(2, -24), IntegerUtils.FromHalf(0x0001));
+		Assert.AreEqual(float.PositiveInfinity, IntegerUtils.FromHalf(0x7c00));
+	}
 }
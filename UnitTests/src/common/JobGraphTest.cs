@@ -0,0 +1,83 @@
+using Microsoft.VisualStudio.TestTools.UnitTesting;
+using System;
+using System.Collections.Generic;
+using System.Threading;
+
+[TestClass]
+public class JobGraphTest {
+	[TestMethod]
+	public void TestDependenciesRunFirst() {
+		var graph = new JobGraph();
+		var finished = new HashSet<string>();
+
+		JobGraph.Job Add(string name, params JobGraph.Job[] dependencies) {
+			return graph.Add(name, "test", () => {
+				lock (finished) {
+					foreach (var dependency in dependencies) {
+						Assert.IsTrue(finished.Contains(dependency.Name));
+					}
+				}
+				Thread.Sleep(1);
+				lock (finished) {
+					finished.Add(name);
+				}
+			}, dependencies);
+		}
+
+		var a = Add("a");
+		var b = Add("b");
+		var c = Add("c", a, b);
+		var d = Add("d", c);
+		Add("e", a, d);
+
+		var statistics = graph.Run(4);
+		Assert.AreEqual(5, statistics.JobCount);
+		Assert.AreEqual(5, finished.Count);
+	}
+
+	[TestMethod]
+	public void TestSerializedJobsDontOverlap() {
+		var graph = new JobGraph();
+		int runningCount = 0;
+		int maxRunningCount = 0;
+
+		for (int i = 0; i < 20; ++i) {
+			graph.AddSerialized("serial", "test", () => {
+				int count = Interlocked.Increment(ref runningCount);
+				lock (graph) {
+					maxRunningCount = Math.Max(maxRunningCount, count);
+				}
+				Thread.Sleep(1);
+				Interlocked.Decrement(ref runningCount);
+			});
+		}
+
+		graph.Run(8);
+		Assert.AreEqual(1, maxRunningCount);
+	}
+
+	[TestMethod]
+	public void TestFailureStopsDependents() {
+		var graph = new JobGraph();
+		bool dependentRan = false;
+
+		var failing = graph.Add("failing", "test", () => throw new InvalidOperationException("boom"));
+		graph.Add("dependent", "test", () => dependentRan = true, failing);
+
+		Assert.ThrowsException<InvalidOperationException>(() => graph.Run(2));
+		Assert.IsFalse(dependentRan);
+	}
+
+	[TestMethod]
+	public void TestDeepestReadyJobRunsFirst() {
+		var graph = new JobGraph();
+		var order = new List<string>();
+
+		var root = graph.Add("root", "test", () => order.Add("root"));
+		graph.Add("other-root", "test", () => order.Add("other-root"));
+		graph.Add("child", "test", () => order.Add("child"), root);
+
+		graph.Run(1);
+		CollectionAssert.AreEqual(new [] { "root", "child", "other-root" }, order);
+	}
+}
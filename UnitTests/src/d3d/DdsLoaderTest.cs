@@ -0,0 +1,173 @@
+using Microsoft.VisualStudio.TestTools.UnitTesting;
+using SharpDX;
+using SharpDX.Direct3D11;
+using System;
+using System.IO;
+using System.Runtime.InteropServices;
+using Format = SharpDX.DXGI.Format;
+
+[TestClass]
+public class DdsLoaderTest {
+	private const int HeaderSize = 4 + 124; //magic + header
+
+	internal static byte[] MakeRgbaDds(int width, int height, int mipCount) {
+		var stream = new MemoryStream();
+		var writer = new BinaryWriter(stream);
+
+		writer.Write(0x20534444); //magic
+		writer.Write(124); //size
+		writer.Write(0x1 | 0x2 | 0x4 | 0x1000 | 0x20000); //caps, height, width, pixel format, mip count
+		writer.Write(height);
+		writer.Write(width);
+		writer.Write(width * 4); //pitch
+		writer.Write(0); //depth
+		writer.Write(mipCount);
+		for (int i = 0; i < 11; ++i) {
+			writer.Write(0); //reserved
+		}
+
+		writer.Write(32); //pixel format size
+		writer.Write(0x40 | 0x1); //RGB, alpha pixels
+		writer.Write(0); //fourCC
+		writer.Write(32); //bit count
+		writer.Write(0x000000ff);
+		writer.Write(0x0000ff00);
+		writer.Write(0x00ff0000);
+		writer.Write(unchecked((int) 0xff000000));
+
+		writer.Write(0x1000); //caps: texture
+		writer.Write(0);
+		writer.Write(0);
+		writer.Write(0);
+		writer.Write(0);
+
+		int w = width;
+		int h = height;
+		for (int mipIdx = 0; mipIdx < mipCount; ++mipIdx) {
+			writer.Write(new byte[w * h * 4]);
+			w = Math.Max(w / 2, 1);
+			h = Math.Max(h / 2, 1);
+		}
+
+		return stream.ToArray();
+	}
+
+	private static DdsImage Decode(byte[] bytes, int maxsize, out IntPtr basePointer) {
+		var handle = GCHandle.Alloc(bytes, GCHandleType.Pinned);
+		try {
+			basePointer = handle.AddrOfPinnedObject();
+			return DdsLoader.Decode(new DataPointer(basePointer, bytes.Length), maxsize);
+		} finally {
+			handle.Free();
+		}
+	}
+
+	[TestMethod]
+	public void TestDecodeMipChain() {
+		var bytes = MakeRgbaDds(8, 4, 3);
+		var image = Decode(bytes, 0, out var basePointer);
+
+		Assert.AreEqual(ResourceDimension.Texture2D, image.Dimension);
+		Assert.AreEqual(Format.R8G8B8A8_UNorm, image.Format);
+		Assert.AreEqual(8, image.Width);
+		Assert.AreEqual(4, image.Height);
+		Assert.AreEqual(3, image.MipCount);
+		Assert.AreEqual(1, image.ArraySize);
+		Assert.IsFalse(image.IsCubeMap);
+		Assert.AreEqual(8 * 4 * 4 + 4 * 2 * 4 + 2 * 1 * 4, image.ByteCount);
+
+		Assert.AreEqual(3, image.Subresources.Length);
+		Assert.AreEqual(HeaderSize, (long) image.Subresources[0].DataPointer - (long) basePointer);
+		Assert.AreEqual(8 * 4, image.Subresources[0].RowPitch);
+		Assert.AreEqual(HeaderSize + 128, (long) image.Subresources[1].DataPointer - (long) basePointer);
+		Assert.AreEqual(4 * 4, image.Subresources[1].RowPitch);
+		Assert.AreEqual(HeaderSize + 128 + 32, (long) image.Subresources[2].DataPointer - (long) basePointer);
+	}
+
+	[TestMethod]
+	public void TestDecodeSkipsMipsLargerThanMaxsize() {
+		var bytes = MakeRgbaDds(8, 4, 3);
+		var image = Decode(bytes, 4, out var basePointer);
+
+		Assert.AreEqual(4, image.Width);
+		Assert.AreEqual(2, image.Height);
+		Assert.AreEqual(2, image.MipCount);
+		Assert.AreEqual(2, image.Subresources.Length);
+		Assert.AreEqual(4 * 2 * 4 + 2 * 1 * 4, image.ByteCount);
+		Assert.AreEqual(HeaderSize + 128, (long) image.Subresources[0].DataPointer - (long) basePointer);
+	}
+
+	[TestMethod]
+	public void TestDecodeRejectsTruncatedData() {
+		var bytes = MakeRgbaDds(8, 4, 3);
+		Array.Resize(ref bytes, bytes.Length - 1);
+		Assert.ThrowsException<SharpDXException>(() => Decode(bytes, 0, out var basePointer));
+	}
+
+	[TestMethod]
+	public void TestDecodeRejectsBadMagic() {
+		var bytes = MakeRgbaDds(8, 4, 1);
+		bytes[0] = 0;
+		Assert.ThrowsException<SharpDXException>(() => Decode(bytes, 0, out var basePointer));
+	}
+
+	[TestMethod]
+	public void TestParseHeaderReadsOnlyHeader() {
+		var bytes = MakeRgbaDds(16, 8, 5);
+		var handle = GCHandle.Alloc(bytes, GCHandleType.Pinned);
+		try {
+			var description = DdsLoader.ParseHeader(new DataPointer(handle.AddrOfPinnedObject(), HeaderSize));
+			Assert.AreEqual(16, description.Width);
+			Assert.AreEqual(8, description.Height);
+			Assert.AreEqual(1, description.Depth);
+			Assert.AreEqual(5, description.MipCount);
+			Assert.AreEqual(HeaderSize, description.DataOffset);
+			Assert.AreEqual(bytes.Length, DdsLoader.GetRequiredFileSize(description, 0, 5));
+			Assert.AreEqual(HeaderSize + 16 * 8 * 4, DdsLoader.GetRequiredFileSize(description, 0, 1));
+		} finally {
+			handle.Free();
+		}
+	}
+
+	[TestMethod]
+	public void TestMipDimensions() {
+		var description = new DdsDescription(ResourceDimension.Texture2D, Format.R8G8B8A8_UNorm, 16, 4, 1, 5, 1, false, HeaderSize);
+		Assert.AreEqual(4, description.GetMipWidth(2));
+		Assert.AreEqual(1, description.GetMipHeight(2));
+		Assert.AreEqual(1, description.GetMipHeight(4));
+
+		Assert.AreEqual(0, description.GetFirstMipWithin(0));
+		Assert.AreEqual(0, description.GetFirstMipWithin(16));
+		Assert.AreEqual(1, description.GetFirstMipWithin(15));
+		Assert.AreEqual(2, description.GetFirstMipWithin(4));
+		Assert.AreEqual(4, description.GetFirstMipWithin(1));
+	}
+
+	[TestMethod]
+	public void TestDecodeMipRange() {
+		var bytes = MakeRgbaDds(16, 8, 5);
+		var handle = GCHandle.Alloc(bytes, GCHandleType.Pinned);
+		try {
+			var basePointer = handle.AddrOfPinnedObject();
+			var image = DdsLoader.Decode(new DataPointer(basePointer, bytes.Length), 1, 2);
+
+			Assert.AreEqual(1, image.FirstMip);
+			Assert.AreEqual(2, image.MipCount);
+			Assert.IsFalse(image.IsComplete);
+			Assert.AreEqual(8, image.Width);
+			Assert.AreEqual(4, image.Height);
+			Assert.AreEqual(8 * 4 * 4 + 4 * 2 * 4, image.ByteCount);
+			Assert.AreEqual(2, image.Subresources.Length);
+			Assert.AreEqual(HeaderSize + 16 * 8 * 4, (long) image.Subresources[0].DataPointer - (long) basePointer);
+			Assert.AreEqual(HeaderSize + 16 * 8 * 4 + 8 * 4 * 4, (long) image.Subresources[1].DataPointer - (long) basePointer);
+
+			//a range which ends early doesn't need the rest of the file
+			var truncatedImage = DdsLoader.Decode(new DataPointer(basePointer, (int) DdsLoader.GetRequiredFileSize(image.Description, 0, 2)), 0, 2);
+			Assert.AreEqual(2, truncatedImage.MipCount);
+
+			Assert.ThrowsException<SharpDXException>(() => DdsLoader.Decode(new DataPointer(basePointer, bytes.Length), 4, 2));
+		} finally {
+			handle.Free();
+		}
+	}
+}
@@ -0,0 +1,62 @@
+using Microsoft.VisualStudio.TestTools.UnitTesting;
+using SharpDX;
+using System.Runtime.InteropServices;
+
+[TestClass]
+public class TextureCacheTest {
+	private const int InitialResolution = 8;
+
+	[TestMethod]
+	public void TestBudgetPressureDropsTopMipsDownToInitialResolution() {
+		var bytes = DdsLoaderTest.MakeRgbaDds(64, 32, 7);
+		var handle = GCHandle.Alloc(bytes, GCHandleType.Pinned);
+		try {
+			var dataPointer = new DataPointer(handle.AddrOfPinnedObject(), bytes.Length);
+			var description = DdsLoader.ParseHeader(dataPointer);
+
+			//each reduction requests the next mip down, which is what the reload decodes
+			int residentFirstMip = 0;
+			int[] expectedWidths = { 32, 16, 8 };
+			foreach (int expectedWidth in expectedWidths) {
+				int requestedResolution = TextureCache.GetReducedResolution(description, residentFirstMip, InitialResolution);
+				Assert.AreEqual(expectedWidth, requestedResolution);
+
+				int firstMip = description.GetFirstMipWithin(requestedResolution);
+				Assert.AreEqual(residentFirstMip + 1, firstMip);
+
+				var image = DdsLoader.Decode(dataPointer, firstMip, description.MipCount - firstMip);
+				Assert.AreEqual(expectedWidth, image.Width);
+				Assert.AreEqual(expectedWidth / 2, image.Height);
+				residentFirstMip = image.FirstMip;
+			}
+
+			//the initial resolution is the floor
+			Assert.AreEqual(-1, TextureCache.GetReducedResolution(description, residentFirstMip, InitialResolution));
+
+			//raising goes back up a mip at a time, ending at full resolution
+			Assert.AreEqual(16, TextureCache.GetRaisedResolution(description, residentFirstMip));
+			Assert.AreEqual(32, TextureCache.GetRaisedResolution(description, 2));
+			int fullResolution = TextureCache.GetRaisedResolution(description, 1);
+			Assert.AreEqual(0, fullResolution);
+			var fullImage = DdsLoader.Decode(dataPointer, description.GetFirstMipWithin(fullResolution), description.MipCount);
+			Assert.AreEqual(64, fullImage.Width);
+			Assert.AreEqual(7, fullImage.MipCount);
+		} finally {
+			handle.Free();
+		}
+	}
+
+	[TestMethod]
+	public void TestSmallestMipCannotBeReduced() {
+		var bytes = DdsLoaderTest.MakeRgbaDds(4, 4, 3);
+		var handle = GCHandle.Alloc(bytes, GCHandleType.Pinned);
+		try {
+			var description = DdsLoader.ParseHeader(new DataPointer(handle.AddrOfPinnedObject(), bytes.Length));
+			Assert.AreEqual(2, TextureCache.GetReducedResolution(description, 0, 1));
+			Assert.AreEqual(1, TextureCache.GetReducedResolution(description, 1, 1));
+			Assert.AreEqual(-1, TextureCache.GetReducedResolution(description, 2, 1));
+		} finally {
+			handle.Free();
+		}
+	}
+}
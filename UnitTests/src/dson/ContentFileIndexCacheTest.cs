@@ -0,0 +1,39 @@
+using Microsoft.VisualStudio.TestTools.UnitTesting;
+using System;
+using System.IO;
+
+[TestClass]
+public class ContentFileIndexCacheTest {
+	private DirectoryInfo packageDirectory;
+	private FileInfo manifestFile;
+
+	[TestInitialize]
+	public void Initialize() {
+		packageDirectory = new DirectoryInfo(Path.Combine(Path.GetTempPath(), "ContentFileIndexCacheTest-" + Guid.NewGuid()));
+		packageDirectory.Create();
+		manifestFile = packageDirectory.File("Manifest.dsx");
+		manifestFile.WriteAllText("<DAZInstallManifest/>");
+	}
+
+	[TestCleanup]
+	public void Cleanup() {
+		packageDirectory.Delete(true);
+	}
+
+	[TestMethod]
+	public void TestTouchedManifestIsRefreshedOnce() {
+		var package = new ContentFileIndexCache.Package {
+			Manifest = ImportManifest.Input.Make(manifestFile)
+		};
+
+		Assert.IsTrue(package.IsUnchanged(packageDirectory, manifestFile, out bool isRefreshed));
+		Assert.IsFalse(isRefreshed);
+
+		File.SetLastWriteTimeUtc(manifestFile.FullName, DateTime.UtcNow.AddHours(1));
+		Assert.IsTrue(package.IsUnchanged(packageDirectory, manifestFile, out isRefreshed));
+		Assert.IsTrue(isRefreshed);
+
+		Assert.IsTrue(package.IsUnchanged(packageDirectory, manifestFile, out isRefreshed));
+		Assert.IsFalse(isRefreshed);
+	}
+}
@@ -0,0 +1,51 @@
+using DsonTypes;
+using Microsoft.VisualStudio.TestTools.UnitTesting;
+using System;
+
+[TestClass]
+public class DsonFragmentIndexTest {
+	private const string Document = @"{
+	""file_version"": ""0.6.0.0"",
+	""asset_info"": { ""id"": ""/data/test.dsf"", ""contributor"": { ""author"": ""a [b] {c}"" } },
+	""geometry_library"": [
+		{ ""name"": ""geo"", ""vertices"": { ""values"": [ [0, 1.5e-3, -2], [3, 4, 5] ] }, ""id"": ""geo"" }
+	],
+	""node_library"": [
+		{ ""id"": ""hip"", ""label"": ""Hip \""root\"" }"" },
+		{ ""label"": ""no id"" },
+		{ ""id"": ""dup"", ""label"": ""first"" },
+		{ ""id"": ""dup"", ""label"": ""second"" }
+	],
+	""scene"": { ""nodes"": [ { ""id"": ""not-a-library-object"" } ] }
+}";
+
+	private static string FragmentText(DsonFragmentIndex.Fragment fragment) {
+		return Document.Substring(fragment.Start, fragment.Length);
+	}
+
+	[TestMethod]
+	public void TestIndexesLibraryObjects() {
+		var index = DsonFragmentIndex.Build(Document);
+
+		CollectionAssert.AreEquivalent(new [] { "geo", "hip", "dup" }, index.Keys);
+
+		Assert.AreEqual(typeof(Geometry), index["geo"].Type);
+		StringAssert.StartsWith(FragmentText(index["geo"]), "{ \"name\": \"geo\"");
+		StringAssert.EndsWith(FragmentText(index["geo"]), "\"id\": \"geo\" }");
+
+		Assert.AreEqual(typeof(Node), index["hip"].Type);
+		Assert.AreEqual("{ \"id\": \"hip\", \"label\": \"Hip \\\"root\\\" }\" }", FragmentText(index["hip"]));
+	}
+
+	[TestMethod]
+	public void TestLaterDuplicateWins() {
+		var index = DsonFragmentIndex.Build(Document);
+		StringAssert.Contains(FragmentText(index["dup"]), "second");
+	}
+
+	[TestMethod]
+	public void TestMalformedDocumentThrows() {
+		Assert.ThrowsException<InvalidOperationException>(() => DsonFragmentIndex.Build("{ \"node_library\": [ { \"id\": \"a\" "));
+		Assert.ThrowsException<InvalidOperationException>(() => DsonFragmentIndex.Build("[]"));
+	}
+}
@@ -0,0 +1,47 @@
+using Microsoft.VisualStudio.TestTools.UnitTesting;
+using System.Collections.Generic;
+
+[TestClass]
+public class CpuOccluderTest {
+	private const float Acc = 1e-3f;
+	private const string ChannelName = "morph";
+
+	private static OcclusionInfo CalculateOcclusion(OcclusionInfo baseOcclusion, OcclusionInfo morphOcclusion, double channelValue) {
+		var channel = new Channel(ChannelName, 0, null, 0, 0, 1, false, true, false, ChannelName);
+		var channelSystem = new ChannelSystem(null, new List<Channel> { channel });
+
+		var packedBaseOcclusion = OcclusionInfo.Pack(baseOcclusion);
+		var deltas = PackedLists<OcclusionDelta>.Pack(new List<List<OcclusionDelta>> {
+			new List<OcclusionDelta> { new OcclusionDelta(0, OcclusionInfo.Pack(morphOcclusion)) }
+		});
+		var parameters = new OccluderParameters(new [] { packedBaseOcclusion }, new List<string> { ChannelName }, deltas);
+
+		var occluder = new CpuOccluder(channelSystem, new [] { baseOcclusion }, parameters);
+		var outputs = new ChannelOutputs(null, new [] { channelValue });
+		return OcclusionInfo.Unpack(occluder.CalculateOcclusion(outputs)[0]);
+	}
+
+	[TestMethod]
+	public void TestUnweightedDeltaLeavesBaseOcclusion() {
+		var occlusion = CalculateOcclusion(new OcclusionInfo(0.5f, 0.3f), new OcclusionInfo(0.8f, 0.1f), 0);
+		Assert.AreEqual(0.5f, occlusion.Front, Acc);
+		Assert.AreEqual(0.3f, occlusion.Back, Acc);
+	}
+
+	[TestMethod]
+	public void TestFullyWeightedDeltaGivesMorphOcclusion() {
+		var occlusion = CalculateOcclusion(new OcclusionInfo(0.5f, 0.5f), new OcclusionInfo(0.8f, 0.2f), 1);
+		Assert.AreEqual(0.8f, occlusion.Front, Acc);
+		Assert.AreEqual(0.2f, occlusion.Back, Acc);
+	}
+
+	[TestMethod]
+	public void TestWithoutParameters() {
+		var channelSystem = new ChannelSystem(null, new List<Channel>());
+		var unmorphedOcclusionInfos = new [] { new OcclusionInfo(0.25f, 0.75f) };
+		var occluder = new CpuOccluder(channelSystem, unmorphedOcclusionInfos, null);
+
+		var packedOcclusionInfos = occluder.CalculateOcclusion(channelSystem.DefaultOutputs);
+		CollectionAssert.AreEqual(OcclusionInfo.PackArray(unmorphedOcclusionInfos), packedOcclusionInfos);
+	}
+}
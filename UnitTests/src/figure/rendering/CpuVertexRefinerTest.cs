@@ -0,0 +1,86 @@
+using Microsoft.VisualStudio.TestTools.UnitTesting;
+using SharpDX;
+using System;
+
+[TestClass]
+public class CpuVertexRefinerTest {
+	private const float Acc = 1e-6f;
+
+	private static ControlVertexInfo MakeControlVertexInfo(Vector3 position, float front, float back) {
+		return ControlVertexInfo.Make(position, OcclusionInfo.Pack(new OcclusionInfo(front, back)));
+	}
+
+	private static void AssertAreEqual(Vector3 expected, Vector3 actual) {
+		Assert.AreEqual(expected.X, actual.X, Acc);
+		Assert.AreEqual(expected.Y, actual.Y, Acc);
+		Assert.AreEqual(expected.Z, actual.Z, Acc);
+	}
+
+	[TestMethod]
+	public void TestRefineVertices() {
+		//spatial vertex 0 is the midpoint of the two control vertices; spatial vertex 1 is control vertex 1
+		var stencils = new PackedLists<WeightedIndexWithDerivatives>(
+			new [] { new ArraySegment(0, 2), new ArraySegment(2, 1) },
+			new [] {
+				new WeightedIndexWithDerivatives(0, 0.5f, -1, 0),
+				new WeightedIndexWithDerivatives(1, 0.5f, +1, 0),
+				new WeightedIndexWithDerivatives(1, 1, 0, 1)
+			});
+		var mesh = new SubdivisionMesh(2, new QuadTopology(2, new Quad[0]), stencils);
+		var texturedToSpatialIdxMap = new [] { 0, 1, 1 };
+		var refiner = new CpuVertexRefiner(mesh, texturedToSpatialIdxMap);
+		Assert.AreEqual(3, refiner.RefinedVertexCount);
+
+		var controlVertexInfos = new [] {
+			MakeControlVertexInfo(new Vector3(0, 0, 0), 0.0625f, 0),
+			MakeControlVertexInfo(new Vector3(2, 4, 6), 1, 0.0625f)
+		};
+		var controlScatteredIlluminations = new [] { Vector3.UnitX, Vector3.UnitY };
+
+		var refinedVertices = refiner.RefineVertices(controlVertexInfos, controlScatteredIlluminations);
+
+		AssertAreEqual(new Vector3(1, 2, 3), refinedVertices[0].position);
+		AssertAreEqual(new Vector3(2, 4, 6), refinedVertices[0].positionDs);
+		AssertAreEqual(Vector3.Zero, refinedVertices[0].positionDt);
+		Assert.AreEqual(0.75f * 0.75f * 0.75f * 0.75f, refinedVertices[0].occlusion.X, Acc);
+		Assert.AreEqual(0.25f * 0.25f * 0.25f * 0.25f, refinedVertices[0].occlusion.Y, Acc);
+		AssertAreEqual(new Vector3(0.5f, 0.5f, 0), refinedVertices[0].scatteredIllumination);
+
+		for (int vertexIdx = 1; vertexIdx < 3; ++vertexIdx) {
+			AssertAreEqual(new Vector3(2, 4, 6), refinedVertices[vertexIdx].position);
+			AssertAreEqual(new Vector3(2, 4, 6), refinedVertices[vertexIdx].positionDt);
+			Assert.AreEqual(1, refinedVertices[vertexIdx].occlusion.X, Acc);
+			Assert.AreEqual(0.0625f, refinedVertices[vertexIdx].occlusion.Y, Acc);
+			AssertAreEqual(Vector3.UnitY, refinedVertices[vertexIdx].scatteredIllumination);
+		}
+
+		//missing scattered illumination is taken to be zero
+		var unlitRefinedVertices = refiner.RefineVertices(controlVertexInfos, null);
+		AssertAreEqual(Vector3.Zero, unlitRefinedVertices[0].scatteredIllumination);
+		AssertAreEqual(refinedVertices[0].position, unlitRefinedVertices[0].position);
+	}
+
+	[TestMethod]
+	public void TestControlVertexInfoStoresFourthRootOcclusion() {
+		var controlVertexInfo = ControlVertexInfo.Make(new Vector3(1, 2, 3), OcclusionInfo.Pack(new OcclusionInfo(0.0625f, 1)));
+		AssertAreEqual(new Vector3(1, 2, 3), controlVertexInfo.position);
+		Vector2 fourthRootOcclusion = controlVertexInfo.UnpackFourthRootOcclusion();
+		Assert.AreEqual(0.5f, fourthRootOcclusion.X, Acc);
+		Assert.AreEqual(1, fourthRootOcclusion.Y, Acc);
+
+		//the fourth roots are stored as halves, so raising them back to the fourth power only approximates the occlusion
+		const float RoundTripAcc = 2e-3f;
+		foreach (float occlusion in new [] { 0, 0.001f, 0.1f, 0.37f, 0.5f, 0.9f, 1 }) {
+			uint packedOcclusion = OcclusionInfo.Pack(new OcclusionInfo(occlusion, 1 - occlusion));
+			OcclusionInfo expected = OcclusionInfo.Unpack(packedOcclusion);
+			Vector2 roundTripped = ControlVertexInfo.Make(Vector3.Zero, packedOcclusion).UnpackFourthRootOcclusion();
+			Assert.AreEqual(expected.Front, (float) Math.Pow(roundTripped.X, 4), RoundTripAcc);
+			Assert.AreEqual(expected.Back, (float) Math.Pow(roundTripped.Y, 4), RoundTripAcc);
+		}
+	}
+
+	[TestMethod]
+	public void TestRefinedVertexMatchesStreamOutLayout() {
+		Assert.AreEqual(14 * sizeof(float), RefinedVertex.SizeInBytes);
+	}
+}
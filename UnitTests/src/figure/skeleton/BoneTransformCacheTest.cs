@@ -0,0 +1,89 @@
+using Microsoft.VisualStudio.TestTools.UnitTesting;
+using SharpDX;
+using System;
+
+[TestClass]
+public class BoneTransformCacheTest {
+	private Bone root, spine, leftArm, leftHand, rightArm;
+	private ChannelSystem channelSystem;
+	private BoneSystem boneSystem;
+
+	[TestInitialize]
+	public void Initialize() {
+		var builder = new BoneSystemBuilder();
+		root = builder.AddBone("root", null, new Vector3(0, 0, 0), new Vector3(0, 1, 0), Vector3.Zero);
+		spine = builder.AddBone("spine", root, new Vector3(0, 1, 0), new Vector3(0, 2, 0), new Vector3(0, 0, 10));
+		leftArm = builder.AddBone("leftArm", spine, new Vector3(1, 2, 0), new Vector3(2, 2, 0), new Vector3(20, 0, 0));
+		leftHand = builder.AddBone("leftHand", leftArm, new Vector3(2, 2, 0), new Vector3(3, 2, 0), Vector3.Zero);
+		rightArm = builder.AddBone("rightArm", spine, new Vector3(-1, 2, 0), new Vector3(-2, 2, 0), new Vector3(0, 30, 0));
+		channelSystem = builder.BuildChannelSystem();
+		boneSystem = builder.BuildBoneSystem();
+	}
+
+	private void AssertMatchesFullRecomputation(ChannelOutputs outputs, StagedSkinningTransform[] actual) {
+		var expected = boneSystem.GetBoneTransforms(outputs);
+		for (int boneIdx = 0; boneIdx < expected.Length; ++boneIdx) {
+			foreach (var testPoint in new [] { Vector3.Zero, Vector3.UnitX, Vector3.UnitY, Vector3.UnitZ }) {
+				float distance = Vector3.Distance(expected[boneIdx].Transform(testPoint), actual[boneIdx].Transform(testPoint));
+				Assert.AreEqual(0, distance, 1e-6);
+			}
+		}
+	}
+
+	[TestMethod]
+	public void TestOnlyChangedSubtreeIsRecomputed() {
+		var cache = new BoneTransformCache(boneSystem);
+		var inputs = channelSystem.MakeDefaultChannelInputs();
+
+		var outputs = channelSystem.Evaluate(null, inputs);
+		AssertMatchesFullRecomputation(outputs, cache.GetBoneTransforms(outputs));
+		Assert.AreEqual(5, cache.RecomputedBoneCount);
+
+		//unchanged
+		AssertMatchesFullRecomputation(outputs, cache.GetBoneTransforms(outputs));
+		Assert.AreEqual(0, cache.RecomputedBoneCount);
+
+		leftArm.Rotation.SetValue(inputs, new Vector3(10, 20, 30));
+		outputs = channelSystem.Evaluate(null, inputs);
+		AssertMatchesFullRecomputation(outputs, cache.GetBoneTransforms(outputs));
+		Assert.AreEqual(2, cache.RecomputedBoneCount);
+
+		rightArm.Scale.SetValue(inputs, new Vector3(1, 2, 1));
+		outputs = channelSystem.Evaluate(null, inputs);
+		AssertMatchesFullRecomputation(outputs, cache.GetBoneTransforms(outputs));
+		Assert.AreEqual(1, cache.RecomputedBoneCount);
+
+		spine.Translation.SetValue(inputs, new Vector3(0, 0.5f, 0));
+		outputs = channelSystem.Evaluate(null, inputs);
+		AssertMatchesFullRecomputation(outputs, cache.GetBoneTransforms(outputs));
+		Assert.AreEqual(4, cache.RecomputedBoneCount);
+	}
+
+	[TestMethod]
+	public void TestRandomEditsMatchFullRecomputation() {
+		var cache = new BoneTransformCache(boneSystem);
+		var inputs = channelSystem.MakeDefaultChannelInputs();
+		var bones = new [] { root, spine, leftArm, leftHand, rightArm };
+
+		var random = new Random(0);
+		float NextFloat() => (float) random.NextDouble() * 2 - 1;
+
+		for (int editIdx = 0; editIdx < 100; ++editIdx) {
+			var bone = bones[random.Next(bones.Length)];
+			switch (random.Next(3)) {
+				case 0:
+					bone.Rotation.SetValue(inputs, 90 * new Vector3(NextFloat(), NextFloat(), NextFloat()));
+					break;
+				case 1:
+					bone.Translation.SetValue(inputs, new Vector3(NextFloat(), NextFloat(), NextFloat()));
+					break;
+				default:
+					bone.Scale.SetValue(inputs, new Vector3(1.5f + NextFloat(), 1.5f + NextFloat(), 1.5f + NextFloat()));
+					break;
+			}
+
+			var outputs = channelSystem.Evaluate(null, inputs);
+			AssertMatchesFullRecomputation(outputs, cache.GetBoneTransforms(outputs));
+		}
+	}
+}
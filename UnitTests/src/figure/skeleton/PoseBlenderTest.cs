@@ -0,0 +1,68 @@
+using Microsoft.VisualStudio.TestTools.UnitTesting;
+using SharpDX;
+using System;
+
+[TestClass]
+public class PoseBlenderTest {
+	private const int BoneCount = 3;
+
+	private static Pose MakePose(Vector3 rootTranslation, float angle) {
+		var rotations = new Quaternion[BoneCount];
+		for (int i = 0; i < BoneCount; ++i) {
+			rotations[i] = Quaternion.RotationAxis(Vector3.UnitY, angle * (i + 1));
+		}
+		return new Pose(rootTranslation, rotations);
+	}
+
+	[TestMethod]
+	public void TestBlendIntoExistingPose() {
+		var blender = new PoseBlender(BoneCount);
+		blender.Add(0.5f, MakePose(new Vector3(2, 0, 0), 0.2f));
+		blender.Add(0.5f, MakePose(new Vector3(0, 4, 0), 0.4f));
+
+		var result = Pose.MakeIdentity(BoneCount);
+		blender.GetResult(result);
+
+		MathAssert.AreEqual(new Vector3(1, 2, 0), result.RootTranslation, 1e-6f);
+		for (int i = 0; i < BoneCount; ++i) {
+			var expected = Quaternion.RotationAxis(Vector3.UnitY, 0.3f * (i + 1));
+			Assert.AreEqual(1, result.BoneRotations[i].Length(), 1e-6);
+			Assert.AreEqual(1, Math.Abs(Quaternion.Dot(expected, result.BoneRotations[i])), 1e-4);
+		}
+
+		var allocatedResult = blender.GetResult();
+		MathAssert.AreEqual(result.RootTranslation, allocatedResult.RootTranslation, 0);
+		CollectionAssert.AreEqual(result.BoneRotations, allocatedResult.BoneRotations);
+	}
+
+	[TestMethod]
+	public void TestSteadyStateDoesNotAllocate() {
+		const int BigBoneCount = 170;
+		const int FrameCount = 10000;
+
+		var poses = new [] { Pose.MakeIdentity(BigBoneCount), Pose.MakeIdentity(BigBoneCount) };
+		var blender = new PoseBlender(BigBoneCount);
+		var result = Pose.MakeIdentity(BigBoneCount);
+
+		void BlendFrame(int frameIdx) {
+			float alpha = (frameIdx % 100) / 100f;
+			blender.Reset();
+			blender.Add(1 - alpha, poses[0]);
+			blender.Add(alpha, poses[1]);
+			blender.GetResult(result);
+		}
+
+		BlendFrame(0); //JIT
+
+		AppDomain.MonitoringIsEnabled = true;
+		long allocatedBefore = AppDomain.CurrentDomain.MonitoringTotalAllocatedMemorySize;
+		for (int frameIdx = 0; frameIdx < FrameCount; ++frameIdx) {
+			BlendFrame(frameIdx);
+		}
+		long allocated = AppDomain.CurrentDomain.MonitoringTotalAllocatedMemorySize - allocatedBefore;
+
+		//the counter advances in allocation-context sized steps, so allow a little slack; a single rotation array per
+		//frame would be tens of megabytes
+		Assert.IsTrue(allocated < 64 * 1024, $"allocated {allocated} bytes over {FrameCount} frames");
+	}
+}
@@ -98,4 +98,35 @@ public class RigidBoneSystemTest {
 			}
 		}
 	}
+
+	[TestMethod]
+	public void TestBoneTransformsMatchChainedTransforms() {
+		var builder = new BoneSystemBuilder();
+		var bone0 = builder.AddBone("bone0", null, new Vector3(1, 0, 0), new Vector3(2, 0, 0), new Vector3(10, 20, 30));
+		var bone1 = builder.AddBone("bone1", bone0, new Vector3(2, 0, 0), new Vector3(3, 0, 0), new Vector3(40, 0, 0));
+		builder.AddBone("bone2", bone0, new Vector3(1, 1, 0), new Vector3(1, 2, 0), Vector3.Zero);
+		builder.AddBone("bone3", bone1, new Vector3(3, 0, 0), new Vector3(4, 0, 0), new Vector3(0, 50, 0));
+		var channelSystem = builder.BuildChannelSystem();
+		var boneSystem = builder.BuildBoneSystem();
+
+		var rigidBoneSystem = new RigidBoneSystem(boneSystem);
+		rigidBoneSystem.Synchronize(channelSystem.DefaultOutputs);
+
+		var inputs = rigidBoneSystem.MakeZeroInputs();
+		inputs.RootTranslation = new Vector3(1, 2, 3);
+		for (int boneIdx = 0; boneIdx < rigidBoneSystem.Bones.Length; ++boneIdx) {
+			rigidBoneSystem.Bones[boneIdx].SetRotation(inputs, Quaternion.RotationYawPitchRoll(0.1f * boneIdx, 0.2f, 0.3f));
+		}
+
+		var boneTransforms = new RigidTransform[rigidBoneSystem.Bones.Length];
+		rigidBoneSystem.GetBoneTransforms(inputs, boneTransforms);
+
+		foreach (var bone in rigidBoneSystem.Bones) {
+			var expected = bone.GetChainedTransform(inputs);
+			var actual = boneTransforms[bone.Index];
+			foreach (var testPoint in new [] { Vector3.Zero, Vector3.UnitX, Vector3.UnitY, Vector3.UnitZ }) {
+				Assert.AreEqual(0, Vector3.Distance(expected.Transform(testPoint), actual.Transform(testPoint)), 1e-5);
+			}
+		}
+	}
 }
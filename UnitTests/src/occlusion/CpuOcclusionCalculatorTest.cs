@@ -0,0 +1,120 @@
+using Microsoft.VisualStudio.TestTools.UnitTesting;
+using SharpDX;
+using System;
+using System.Linq;
+
+[TestClass]
+public class CpuOcclusionCalculatorTest {
+	private const float Acc = 1e-3f;
+	private const float Height = 1;
+
+	/**
+	 * A receiver at the origin facing +Z, under a quad spanning [minX, maxX] x [-extent, extent] at z = Height.
+	 */
+	private static OcclusionInfo CalculateReceiverOcclusion(float minX, float maxX, float transparency, bool flipWinding = false,
+		uint receiverMask = 0, uint faceMask = 0) {
+		const float Extent = 1000;
+
+		var vertexInfos = new [] {
+			new BasicRefinedVertexInfo { position = Vector3.Zero, normal = Vector3.UnitZ },
+			new BasicRefinedVertexInfo { position = new Vector3(minX, -Extent, Height), normal = -Vector3.UnitZ },
+			new BasicRefinedVertexInfo { position = new Vector3(maxX, -Extent, Height), normal = -Vector3.UnitZ },
+			new BasicRefinedVertexInfo { position = new Vector3(maxX, +Extent, Height), normal = -Vector3.UnitZ },
+			new BasicRefinedVertexInfo { position = new Vector3(minX, +Extent, Height), normal = -Vector3.UnitZ }
+		};
+		var face = flipWinding ? new Quad(4, 3, 2, 1) : new Quad(1, 2, 3, 4);
+		var topology = new QuadTopology(vertexInfos.Length, new [] { face });
+
+		var calculator = new CpuOcclusionCalculator(topology, new [] { transparency }, new [] { faceMask },
+			new [] { receiverMask, 0u, 0u, 0u, 0u });
+		return calculator.Run(vertexInfos)[0];
+	}
+
+	[TestMethod]
+	public void TestFullyCoveredHemisphere() {
+		var occlusion = CalculateReceiverOcclusion(-1000, 1000, 0);
+		Assert.AreEqual(1, occlusion.Front, Acc);
+		Assert.AreEqual(0, occlusion.Back, Acc);
+
+		var flippedOcclusion = CalculateReceiverOcclusion(-1000, 1000, 0, flipWinding: true);
+		Assert.AreEqual(occlusion.Front, flippedOcclusion.Front);
+		Assert.AreEqual(occlusion.Back, flippedOcclusion.Back);
+	}
+
+	[TestMethod]
+	public void TestTranslucentOccluder() {
+		var occlusion = CalculateReceiverOcclusion(-1000, 1000, 0.25f);
+		Assert.AreEqual(0.75, occlusion.Front, Acc);
+		Assert.AreEqual(0, occlusion.Back, Acc);
+	}
+
+	[TestMethod]
+	public void TestHalfCoveredHemisphere() {
+		//the hemisphere's sample columns are symmetric about x = 0, so the quad covers exactly half of them
+		var occlusion = CalculateReceiverOcclusion(0, 1000, 0);
+		Assert.AreEqual(0.5, occlusion.Front, Acc);
+		Assert.AreEqual(0, occlusion.Back, Acc);
+	}
+
+	[TestMethod]
+	public void TestMaskedOccluderIsIgnored() {
+		var occlusion = CalculateReceiverOcclusion(-1000, 1000, 0, receiverMask: 0b10, faceMask: 0b11);
+		Assert.AreEqual(0, occlusion.Front);
+		Assert.AreEqual(0, occlusion.Back);
+	}
+
+	[TestMethod]
+	public void TestIncrementalCalculationMatchesFullCalculation() {
+		const int FaceCount = 64;
+		const int MovedFaceCount = 3;
+
+		var random = new Random(0);
+		Vector3 NextVector(float scale) => scale * new Vector3((float) random.NextDouble() * 2 - 1, (float) random.NextDouble() * 2 - 1, (float) random.NextDouble() * 2 - 1);
+
+		//scattered small quads, each with its own vertices
+		var referenceVertexInfos = new BasicRefinedVertexInfo[FaceCount * Quad.SideCount];
+		var faces = new Quad[FaceCount];
+		for (int faceIdx = 0; faceIdx < FaceCount; ++faceIdx) {
+			Vector3 center = NextVector(4);
+			for (int i = 0; i < Quad.SideCount; ++i) {
+				referenceVertexInfos[faceIdx * Quad.SideCount + i] = new BasicRefinedVertexInfo {
+					position = center + NextVector(0.5f),
+					normal = Vector3.Normalize(NextVector(1))
+				};
+			}
+			int baseIdx = faceIdx * Quad.SideCount;
+			faces[faceIdx] = new Quad(baseIdx + 0, baseIdx + 1, baseIdx + 2, baseIdx + 3);
+		}
+		var transparencies = Enumerable.Range(0, FaceCount).Select(faceIdx => new [] { 0, 0.5f, 1 }[faceIdx % 3]).ToArray();
+
+		var calculator = new CpuOcclusionCalculator(new QuadTopology(referenceVertexInfos.Length, faces), transparencies,
+			new uint[FaceCount], new uint[referenceVertexInfos.Length]);
+		var referenceOcclusionInfos = calculator.Run(referenceVertexInfos);
+
+		var unchangedReceivers = calculator.FindAffectedReceivers(referenceVertexInfos, referenceVertexInfos, false);
+		Assert.IsFalse(unchangedReceivers.Any(isAffected => isAffected));
+		var paddedUnchangedReceivers = calculator.FindAffectedReceivers(referenceVertexInfos, referenceVertexInfos, true);
+		Assert.IsFalse(paddedUnchangedReceivers.Any(isAffected => isAffected));
+
+		var vertexInfos = (BasicRefinedVertexInfo[]) referenceVertexInfos.Clone();
+		for (int vertexIdx = 0; vertexIdx < MovedFaceCount * Quad.SideCount; ++vertexIdx) {
+			vertexInfos[vertexIdx].position += NextVector(0.5f);
+		}
+
+		var affectedReceivers = calculator.FindAffectedReceivers(referenceVertexInfos, vertexInfos, false);
+
+		//padded selection must include every receiver the exact selection does
+		var paddedAffectedReceivers = calculator.FindAffectedReceivers(referenceVertexInfos, vertexInfos, true);
+		for (int vertexIdx = 0; vertexIdx < vertexInfos.Length; ++vertexIdx) {
+			Assert.IsTrue(paddedAffectedReceivers[vertexIdx] || !affectedReceivers[vertexIdx]);
+		}
+
+		var incrementalOcclusionInfos = calculator.Run(vertexInfos, affectedReceivers, referenceOcclusionInfos);
+		var fullOcclusionInfos = calculator.Run(vertexInfos);
+
+		for (int vertexIdx = 0; vertexIdx < vertexInfos.Length; ++vertexIdx) {
+			Assert.AreEqual(fullOcclusionInfos[vertexIdx].Front, incrementalOcclusionInfos[vertexIdx].Front);
+			Assert.AreEqual(fullOcclusionInfos[vertexIdx].Back, incrementalOcclusionInfos[vertexIdx].Back);
+		}
+	}
+}
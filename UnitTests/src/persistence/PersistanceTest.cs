@@ -0,0 +1,144 @@
+using Microsoft.VisualStudio.TestTools.UnitTesting;
+using ProtoBuf;
+using SharpDX;
+using System;
+using System.IO;
+using System.Linq;
+using System.Runtime.InteropServices;
+
+[TestClass]
+public class PersistanceTest {
+	[ProtoContract]
+	public class ElementwisePackedLists {
+		[ProtoMember(1)]
+		public ArraySegment[] Segments { get; set; }
+
+		[ProtoMember(2)]
+		public WeightedIndex[] Elems { get; set; }
+	}
+
+	private static T RoundTrip<T>(object obj) {
+		var stream = new MemoryStream();
+		Persistance.Write(stream, obj);
+		stream.Position = 0;
+		return Persistance.Read<T>(stream);
+	}
+
+	private static T ReadFromMemory<T>(byte[] bytes) {
+		var handle = GCHandle.Alloc(bytes, GCHandleType.Pinned);
+		try {
+			return Persistance.Read<T>(new DataPointer(handle.AddrOfPinnedObject(), bytes.Length));
+		} finally {
+			handle.Free();
+		}
+	}
+
+	private static void AssertSegmentsEqual(ArraySegment[] expected, ArraySegment[] actual) {
+		CollectionAssert.AreEqual(expected.Select(s => s.Offset).ToArray(), actual.Select(s => s.Offset).ToArray());
+		CollectionAssert.AreEqual(expected.Select(s => s.Count).ToArray(), actual.Select(s => s.Count).ToArray());
+	}
+
+	[TestMethod]
+	public void TestRawArrayEncodingRoundTrip() {
+		var array = new [] { new WeightedIndex(3, 0.25f), new WeightedIndex(-1, 1e30f) };
+		var bytes = RawArrayEncoding.Encode(array);
+		Assert.AreEqual(RawArrayEncoding.HeaderSize + 2 * 8, bytes.Length);
+		CollectionAssert.AreEqual(array, RawArrayEncoding.Decode<WeightedIndex>(bytes));
+	}
+
+	[TestMethod]
+	public void TestRawArrayEncodingRejectsMismatchedElementSize() {
+		var bytes = RawArrayEncoding.Encode(new [] { new WeightedIndex(3, 0.25f) });
+		Assert.ThrowsException<InvalidOperationException>(() => RawArrayEncoding.Decode<int>(bytes));
+	}
+
+	[TestMethod]
+	public void TestBlittablePackedListsRoundTrip() {
+		var lists = new PackedLists<WeightedIndex>(
+			new [] { new ArraySegment(0, 1), new ArraySegment(1, 0), new ArraySegment(1, 2) },
+			new [] { new WeightedIndex(0, 0.5f), new WeightedIndex(7, 0.25f), new WeightedIndex(9, 1) });
+
+		var result = RoundTrip<PackedLists<WeightedIndex>>(lists);
+
+		AssertSegmentsEqual(lists.Segments, result.Segments);
+		CollectionAssert.AreEqual(lists.Elems, result.Elems);
+	}
+
+	[TestMethod]
+	public void TestNonBlittablePackedListsRoundTrip() {
+		var lists = new PackedLists<string>(
+			new [] { new ArraySegment(0, 2), new ArraySegment(2, 1) },
+			new [] { "a", "b", "c" });
+
+		var result = RoundTrip<PackedLists<string>>(lists);
+
+		AssertSegmentsEqual(lists.Segments, result.Segments);
+		CollectionAssert.AreEqual(lists.Elems, result.Elems);
+	}
+
+	[TestMethod]
+	public void TestReadElementwisePackedLists() {
+		var elementwise = new ElementwisePackedLists {
+			Segments = new [] { new ArraySegment(0, 1), new ArraySegment(1, 1) },
+			Elems = new [] { new WeightedIndex(0, 0.5f), new WeightedIndex(7, 0.25f) }
+		};
+
+		var result = RoundTrip<PackedLists<WeightedIndex>>(elementwise);
+
+		AssertSegmentsEqual(elementwise.Segments, result.Segments);
+		CollectionAssert.AreEqual(elementwise.Elems, result.Elems);
+	}
+
+	[TestMethod]
+	public void TestPackedListsRoundTripWithTrailingBlocks() {
+		var lists = new PackedLists<WeightedIndex>(
+			new [] { new ArraySegment(0, 1), new ArraySegment(1, 2) },
+			new [] { new WeightedIndex(0, 0.5f), new WeightedIndex(7, 0.25f), new WeightedIndex(9, 1) });
+
+		var stream = new MemoryStream();
+		Persistance.WriteWithBlocks(stream, lists);
+		byte[] bytes = stream.ToArray();
+		Assert.AreEqual(0, bytes[0], "expected a raw array block header");
+
+		var result = ReadFromMemory<PackedLists<WeightedIndex>>(bytes);
+
+		AssertSegmentsEqual(lists.Segments, result.Segments);
+		CollectionAssert.AreEqual(lists.Elems, result.Elems);
+	}
+
+	[TestMethod]
+	public void TestRepeatedWritesDontShareBlockOffsets() {
+		var lists = new PackedLists<WeightedIndex>(
+			new [] { new ArraySegment(0, 2) },
+			new [] { new WeightedIndex(1, 0.5f), new WeightedIndex(4, 0.5f) });
+
+		var firstStream = new MemoryStream();
+		Persistance.WriteWithBlocks(firstStream, lists);
+		var secondStream = new MemoryStream();
+		Persistance.WriteWithBlocks(secondStream, lists);
+		CollectionAssert.AreEqual(firstStream.ToArray(), secondStream.ToArray());
+
+		//writing without blocks afterwards still stores the arrays inline
+		var inlineStream = new MemoryStream();
+		Persistance.Write(inlineStream, lists);
+		inlineStream.Position = 0;
+		var result = Persistance.Read<PackedLists<WeightedIndex>>(inlineStream);
+		AssertSegmentsEqual(lists.Segments, result.Segments);
+		CollectionAssert.AreEqual(lists.Elems, result.Elems);
+	}
+
+	[TestMethod]
+	public void TestReadInlineBlocksFromMemory() {
+		var lists = new PackedLists<WeightedIndex>(
+			new [] { new ArraySegment(0, 1) },
+			new [] { new WeightedIndex(3, 0.75f) });
+
+		var stream = new MemoryStream();
+		Persistance.Write(stream, lists);
+
+		var result = ReadFromMemory<PackedLists<WeightedIndex>>(stream.ToArray());
+
+		AssertSegmentsEqual(lists.Segments, result.Segments);
+		CollectionAssert.AreEqual(lists.Elems, result.Elems);
+	}
+}
@@ -0,0 +1,60 @@
+using Microsoft.VisualStudio.TestTools.UnitTesting;
+using SharpDX;
+
+[TestClass]
+public class CpuTextureDilatorTest {
+	private const uint Color = 0xff336699;
+
+	private static MultiUvTextureMask MakeMask(float maxU) {
+		var uvs = new [] {
+			new Vector2(0, 0),
+			new Vector2(maxU, 0),
+			new Vector2(maxU, 1),
+			new Vector2(0, 1)
+		};
+		var mask = new MultiUvTextureMask();
+		mask.Merge(new TextureMask(new UvSet("test", uvs, new [] { new Quad(0, 1, 2, 3) }), new [] { 0 }, 0));
+		return mask;
+	}
+
+	private static UnmanagedRgbaImage Dilate(MultiUvTextureMask mask) {
+		var image = new UnmanagedRgbaImage(new Size2(4, 4));
+		for (int y = 0; y < 4; ++y) {
+			for (int x = 0; x < 4; ++x) {
+				//unmasked texels get a color that must not bleed into the result
+				image[y * 4 + x] = x < 2 ? Color : 0xff000000;
+			}
+		}
+
+		using (var dilator = new CpuTextureDilator()) {
+			dilator.Dilate(mask, image.Size, false, image.DataBox);
+		}
+		return image;
+	}
+
+	[TestMethod]
+	public void TestMaskedTexelsKeepColorAndUnmaskedTexelsAreFilled() {
+		using (var image = Dilate(MakeMask(0.4f))) {
+			for (int y = 0; y < 4; ++y) {
+				Assert.AreEqual(Color, image[y * 4 + 0]);
+				Assert.AreEqual(Color, image[y * 4 + 1]);
+
+				for (int x = 2; x < 4; ++x) {
+					uint pixel = image[y * 4 + x];
+					for (int shift = 0; shift < 32; shift += 8) {
+						Assert.AreEqual((Color >> shift) & 0xff, (pixel >> shift) & 0xff, 1);
+					}
+				}
+			}
+		}
+	}
+
+	[TestMethod]
+	public void TestEmptyMaskProducesZero() {
+		using (var image = Dilate(new MultiUvTextureMask())) {
+			for (int i = 0; i < 16; ++i) {
+				Assert.AreEqual(0u, image[i]);
+			}
+		}
+	}
+}
@@ -0,0 +1,114 @@
+using Microsoft.VisualStudio.TestTools.UnitTesting;
+using SharpDX;
+using SharpDX.Direct3D11;
+using System;
+using System.Collections.Generic;
+using System.Threading;
+using Valve.VR;
+
+[TestClass]
+public class AsyncFramePreparerTest {
+	private class SyntheticFrame : IPreparedFrame {
+		public float Time { get; }
+		public bool IsDisposed { get; private set; }
+
+		public SyntheticFrame(float time) {
+			Time = time;
+		}
+
+		public void Dispose() {
+			IsDisposed = true;
+		}
+
+		public void DoPrework(DeviceContext context, TrackedDevicePose_t[] poses) {
+		}
+
+		public Texture2D RenderView(DeviceContext context, HiddenAreaMesh mesh, Matrix viewTransform, Matrix projectionTransform) {
+			return null;
+		}
+
+		public void DrawCompanionWindowUi(DeviceContext context) {
+		}
+
+		public void DoPostwork(DeviceContext context) {
+		}
+	}
+
+	private static FrameUpdateParameters MakeParameters(int frameIdx) {
+		return new FrameUpdateParameters(frameIdx, 1, new TrackedDevicePose_t[0], Vector3.Zero);
+	}
+
+	[TestMethod]
+	public void TestFramesFinishInOrder() {
+		const int FrameCount = 50;
+		const int Depth = 3;
+
+		int maxInFlightCount = 0;
+		int inFlightCount = 0;
+		var finished = new List<float>();
+
+		using (var preparer = new AsyncFramePreparer(parameters => {
+			Thread.Sleep(1);
+			return new SyntheticFrame(parameters.Time);
+		}, Depth)) {
+			//keep the pipeline full, then drain it
+			for (int frameIdx = 0; frameIdx < FrameCount + Depth; ++frameIdx) {
+				if (frameIdx >= Depth) {
+					var frame = (SyntheticFrame) preparer.FinishPreparingFrame();
+					inFlightCount -= 1;
+					finished.Add(frame.Time);
+
+					//synthetic submit work
+					Thread.Sleep(1);
+					frame.Dispose();
+				}
+
+				if (frameIdx < FrameCount) {
+					preparer.StartPreparingFrame(MakeParameters(frameIdx));
+					inFlightCount += 1;
+					maxInFlightCount = Math.Max(maxInFlightCount, inFlightCount);
+				}
+			}
+
+			Assert.IsTrue(preparer.LastFrameTiming.PrepareTime > TimeSpan.Zero);
+		}
+
+		Assert.AreEqual(Depth, maxInFlightCount);
+		Assert.AreEqual(FrameCount, finished.Count);
+		for (int i = 0; i < FrameCount; ++i) {
+			Assert.AreEqual(i, finished[i]);
+		}
+	}
+
+	[TestMethod]
+	public void TestStartBlocksWhenRingIsFull() {
+		using (var preparer = new AsyncFramePreparer(parameters => new SyntheticFrame(parameters.Time), 2)) {
+			preparer.StartPreparingFrame(MakeParameters(0));
+			preparer.StartPreparingFrame(MakeParameters(1));
+
+			var third = new Thread(() => preparer.StartPreparingFrame(MakeParameters(2)));
+			third.Start();
+			Assert.IsFalse(third.Join(50));
+
+			Assert.AreEqual(0, ((SyntheticFrame) preparer.FinishPreparingFrame()).Time);
+			Assert.IsTrue(third.Join(1000));
+		}
+	}
+
+	[TestMethod]
+	public void TestPrepareFailureIsRethrown() {
+		using (var preparer = new AsyncFramePreparer(parameters => throw new InvalidOperationException("boom"))) {
+			preparer.StartPreparingFrame(MakeParameters(0));
+			Assert.ThrowsException<InvalidOperationException>(() => preparer.FinishPreparingFrame());
+		}
+	}
+
+	[TestMethod]
+	public void TestDisposeReleasesUnfinishedFrames() {
+		var frame = new SyntheticFrame(0);
+		var preparer = new AsyncFramePreparer(parameters => frame);
+		preparer.StartPreparingFrame(MakeParameters(0));
+		preparer.Dispose();
+		Assert.IsTrue(frame.IsDisposed);
+	}
+}
@@ -0,0 +1,70 @@
+using Microsoft.VisualStudio.TestTools.UnitTesting;
+using System;
+using System.Linq;
+
+[TestClass]
+public class FrameProfilerTest {
+	private const double Acc = 1e-3;
+
+	[TestCleanup]
+	public void Cleanup() {
+		FrameProfiler.IsEnabled = false;
+		FrameProfiler.Reset();
+	}
+
+	[TestMethod]
+	public void TestPercentiles() {
+		var stage = FrameProfiler.RegisterStage("test-percentiles");
+		FrameProfiler.Reset();
+		FrameProfiler.IsEnabled = true;
+
+		//frames take 1ms to 100ms, shuffled
+		var random = new Random(0);
+		foreach (int milliseconds in Enumerable.Range(1, 100).OrderBy(i => random.Next())) {
+			stage.Add(TimeSpan.FromMilliseconds(milliseconds));
+			FrameProfiler.EndFrame();
+		}
+
+		var summary = FrameProfiler.Summarize().Single(entry => entry.Name == "test-percentiles");
+		Assert.AreEqual(100, summary.FrameCount);
+		Assert.AreEqual(50.5, summary.Mean, Acc);
+		Assert.AreEqual(50, summary.P50, Acc);
+		Assert.AreEqual(95, summary.P95, Acc);
+		Assert.AreEqual(99, summary.P99, Acc);
+		Assert.AreEqual(100, summary.Max, Acc);
+	}
+
+	[TestMethod]
+	public void TestRingKeepsMostRecentFrames() {
+		var stage = FrameProfiler.RegisterStage("test-ring");
+		FrameProfiler.Reset();
+		FrameProfiler.IsEnabled = true;
+
+		for (int i = 0; i < FrameProfiler.Capacity; ++i) {
+			stage.Add(TimeSpan.FromMilliseconds(100));
+			FrameProfiler.EndFrame();
+		}
+		for (int i = 0; i < FrameProfiler.Capacity; ++i) {
+			stage.Add(TimeSpan.FromMilliseconds(1));
+			FrameProfiler.EndFrame();
+		}
+
+		var summary = FrameProfiler.Summarize().Single(entry => entry.Name == "test-ring");
+		Assert.AreEqual(FrameProfiler.Capacity, summary.FrameCount);
+		Assert.AreEqual(1, summary.Max, Acc);
+	}
+
+	[TestMethod]
+	public void TestDisabledRecordsNothing() {
+		var stage = FrameProfiler.RegisterStage("test-disabled");
+		FrameProfiler.Reset();
+		FrameProfiler.IsEnabled = false;
+
+		using (stage.Measure()) {
+			stage.Add(TimeSpan.FromMilliseconds(1));
+		}
+		FrameProfiler.EndFrame();
+
+		Assert.AreEqual(0, FrameProfiler.RecordedFrameCount);
+	}
+}
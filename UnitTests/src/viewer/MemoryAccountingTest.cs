@@ -0,0 +1,67 @@
+using Microsoft.VisualStudio.TestTools.UnitTesting;
+
+[TestClass]
+public class MemoryAccountingTest {
+	[TestCleanup]
+	public void Cleanup() {
+		MemoryAccounting.BudgetBytes = 0;
+		MemoryAccounting.ResetHighWaterMarks();
+	}
+
+	[TestMethod]
+	public void TestLiveAndHighWater() {
+		var category = MemoryAccounting.RegisterCategory("test-live-and-high-water");
+
+		var a = MemoryAccounting.Track(category, 100);
+		var b = MemoryAccounting.Track(category, 50);
+		Assert.AreEqual(150, category.LiveBytes);
+		Assert.AreEqual(2, category.AllocationCount);
+
+		a.Dispose();
+		a.Dispose(); //releasing twice has no further effect
+		Assert.AreEqual(50, category.LiveBytes);
+		Assert.AreEqual(150, category.HighWaterBytes);
+		Assert.AreEqual(1, category.AllocationCount);
+
+		b.Dispose();
+		Assert.AreEqual(0, category.LiveBytes);
+		Assert.AreEqual(150, category.HighWaterBytes);
+	}
+
+	[TestMethod]
+	public void TestOwnerAttribution() {
+		var category = MemoryAccounting.RegisterCategory("test-owner-attribution");
+
+		MemoryAllocation inner, outer;
+		using (MemoryAccounting.AttributeTo("test-outer")) {
+			using (MemoryAccounting.AttributeTo("test-inner")) {
+				inner = MemoryAccounting.Track(category, 10);
+			}
+			outer = MemoryAccounting.Track(category, 20);
+		}
+		Assert.IsNull(MemoryAccounting.CurrentOwner);
+
+		var owners = MemoryAccounting.Summarize().Owners;
+		Assert.AreEqual(10, owners.Find(owner => owner.Name == "test-inner").LiveBytes);
+		Assert.AreEqual(20, owners.Find(owner => owner.Name == "test-outer").LiveBytes);
+
+		inner.Dispose();
+		outer.Dispose();
+	}
+
+	[TestMethod]
+	public void TestBudgetRecordsOwner() {
+		var category = MemoryAccounting.RegisterCategory("test-budget");
+		MemoryAccounting.ResetHighWaterMarks();
+		MemoryAccounting.BudgetBytes = MemoryAccounting.Total.LiveBytes + 100;
+
+		var withinBudget = MemoryAccounting.Track(category, 60, "test-first");
+		Assert.IsNull(MemoryAccounting.OverBudgetOwner);
+
+		var overBudget = MemoryAccounting.Track(category, 60, "test-second");
+		Assert.AreEqual("test-second", MemoryAccounting.OverBudgetOwner);
+
+		withinBudget.Dispose();
+		overBudget.Dispose();
+	}
+}
@@ -73,6 +73,7 @@ public class Actor : IDisposable {
 		foreach (var clothingFigure in clothingFigures) {
 			clothingFigure.Dispose();
 		}
+		model.Dispose();
 	}
 	
 	public List<Character> Characters => characters;
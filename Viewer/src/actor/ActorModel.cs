@@ -1,7 +1,7 @@
 using System;
 using System.Collections.Generic;
 
-public class ActorModel {
+public class ActorModel : IDisposable {
 	public static ActorModel Load(FigureDefinition definition, string initialAnimationName) {
 		AnimationModel animationModel = AnimationModel.Load(definition, initialAnimationName);
 		BehaviorModel behaviorModel = new BehaviorModel();
@@ -26,6 +26,10 @@ public class ActorModel {
 		//hack to turn on eCTRLConfident at start
 		mainDefinition.ChannelSystem.ChannelsByName["eCTRLConfident?value"].SetValue(inputs, 1);
 	}
+
+	public void Dispose() {
+		animation.Dispose();
+	}
 	
 	public FigureDefinition MainDefinition => mainDefinition;
 	public ChannelInputs Inputs => inputs;
@@ -3,14 +3,32 @@ using System.Collections.Generic;
 using System.IO;
 using System.Linq;
 
-public class Animation {
+/**
+ * An animation is either backed by a memory-mapped clip file, which is only opened the first time the animation is
+ * sampled, or by an in-memory list of poses.
+ */
+public class Animation : IDisposable {
+	public const string ClipExtension = ".clip";
+	public const string LegacyExtension = ".dat";
+
 	public string Label { get; }
-	public List<Pose> PosesByFrame { get; }
+	private readonly IArchiveFile clipFile;
+	private readonly List<Pose> posesByFrame;
+	private AnimationClip clip;
+
+	public static bool IsAnimationFile(IArchiveFile file) {
+		string extension = Path.GetExtension(file.Name);
+		return extension == ClipExtension || extension == LegacyExtension;
+	}
 
 	public static Animation Load(IArchiveFile animationFile) {
 		string label = Path.GetFileNameWithoutExtension(animationFile.Name);
-		List<Pose> posesByFrame = Persistance.Load<List<Pose>>(animationFile);
-		return new Animation(label, posesByFrame);
+		if (Path.GetExtension(animationFile.Name) == LegacyExtension) {
+			List<Pose> posesByFrame = Persistance.Load<List<Pose>>(animationFile);
+			return new Animation(label, posesByFrame);
+		} else {
+			return new Animation(label, animationFile);
+		}
 	}
 
 	public static Animation MakeNone(BoneSystem boneSystem) {
@@ -21,7 +39,52 @@ public class Animation {
 
 	public Animation(string label, List<Pose> posesByFrame) {
 		Label = label;
-		PosesByFrame = posesByFrame;
+		this.posesByFrame = posesByFrame;
+	}
+
+	public Animation(string label, IArchiveFile clipFile) {
+		Label = label;
+		this.clipFile = clipFile;
+	}
+
+	public void Dispose() {
+		clip?.Dispose();
+		clip = null;
+	}
+
+	private AnimationClip Clip {
+		get {
+			if (clip == null) {
+				clip = AnimationClip.Open(clipFile);
+			}
+			return clip;
+		}
+	}
+
+	public int FrameCount => posesByFrame != null ? posesByFrame.Count : Clip.FrameCount;
+
+	/**
+	 * Adds the pose at a (fractional, looping) frame to the blender.
+	 */
+	public void Sample(float frame, float weight, PoseBlender blender) {
+		if (posesByFrame != null) {
+			int frameCount = posesByFrame.Count;
+			float currentFrameIdx = frame % frameCount;
+			int baseFrameIdx = (int) currentFrameIdx;
+			float alpha = currentFrameIdx - baseFrameIdx;
+			blender.Add(weight * (1 - alpha), posesByFrame[IntegerUtils.Mod(baseFrameIdx + 0, frameCount)]);
+			blender.Add(weight * alpha, posesByFrame[IntegerUtils.Mod(baseFrameIdx + 1, frameCount)]);
+		} else {
+			Clip.Sample(frame, weight, blender);
+		}
+	}
+
+	public Pose GetPose(int frameIdx) {
+		if (posesByFrame != null) {
+			return posesByFrame[frameIdx];
+		} else {
+			return Clip.GetPose(frameIdx);
+		}
 	}
 }
 
@@ -62,7 +125,7 @@ public class AnimationMenuLevel : IMenuLevel {
 	}
 }
 
-public class AnimationModel {
+public class AnimationModel : IDisposable {
 	public static AnimationModel Load(FigureDefinition figureDefinition, string startingAnimationName) {
 		List<Animation> animations = new List<Animation>();
 		Animation activeAnimation = null;
@@ -73,7 +136,7 @@ public class AnimationModel {
 
 		IArchiveDirectory animationDir = figureDefinition.Directory.Subdirectory("animations");
 		if (animationDir != null) {
-			foreach (IArchiveFile animationFile in animationDir.GetFiles()) {
+			foreach (IArchiveFile animationFile in animationDir.GetFiles().Where(Animation.IsAnimationFile)) {
 				Animation animation = Animation.Load(animationFile);
 				animations.Add(animation);
 				if (animation.Label == startingAnimationName) {
@@ -92,6 +155,12 @@ public class AnimationModel {
 		this.Animations = animations;
 		this.ActiveAnimation = activeAnimation;
 	}
+
+	public void Dispose() {
+		foreach (var animation in Animations) {
+			animation.Dispose();
+		}
+	}
 	
 	public string ActiveName {
 		get {
@@ -15,6 +15,8 @@ public class ActorBehavior {
 	private readonly InverseKinematicsAnimator ikAnimator;
 	private readonly IProceduralAnimator proceduralAnimator;
 	private readonly DragHandle dragHandle;
+	private readonly PoseBlender poseBlender;
+	private readonly Pose blendedPose;
 
 	public ActorBehavior(ControllerManager controllerManager, ActorModel model, InverterParameters inverterParameters) {
 		this.model = model;
@@ -22,25 +24,19 @@ public class ActorBehavior {
 		ikAnimator = new InverseKinematicsAnimator(controllerManager, model.MainDefinition, inverterParameters);
 		proceduralAnimator = new StandardProceduralAnimator(model.MainDefinition, model.Behavior);
 		dragHandle = new DragHandle(controllerManager, InitialSettings.InitialTransform);
+		poseBlender = new PoseBlender(model.MainDefinition.BoneSystem.Bones.Count);
+		blendedPose = Pose.MakeIdentity(model.MainDefinition.BoneSystem.Bones.Count);
 
 		model.PoseReset += ikAnimator.Reset;
 	}
 	
 	private Pose GetBlendedPose(float time) {
-		var posesByFrame = model.Animation.ActiveAnimation.PosesByFrame;
+		var animation = model.Animation.ActiveAnimation;
+		float currentFrameIdx = time * FramesPerSecond;
 
-		float unloopedFrameIdx = time * FramesPerSecond;
- 		float currentFrameIdx = unloopedFrameIdx % posesByFrame.Count;
-
-		int baseFrameIdx = (int) currentFrameIdx;
-		Pose prevFramePose = posesByFrame[IntegerUtils.Mod(baseFrameIdx + 0, posesByFrame.Count)];
-		Pose nextFramePose = posesByFrame[IntegerUtils.Mod(baseFrameIdx + 1, posesByFrame.Count)];
-		
-		var poseBlender = new PoseBlender(model.MainDefinition.BoneSystem.Bones.Count);
-		float alpha = currentFrameIdx - baseFrameIdx;
-		poseBlender.Add(1 - alpha, prevFramePose);
-		poseBlender.Add(alpha, nextFramePose);
-		var blendedPose = poseBlender.GetResult();
+		poseBlender.Reset();
+		animation.Sample(currentFrameIdx, 1, poseBlender);
+		poseBlender.GetResult(blendedPose);
 		return blendedPose;
 	}
 
@@ -0,0 +1,330 @@
+using SharpDX;
+using System;
+using System.Collections.Generic;
+using System.IO;
+
+/**
+ * A memory-mapped, compressed animation clip that is sampled on demand.
+ *
+ * Each bone's rotations are stored as a track of keyframes chosen so that interpolating between keys reproduces
+ * every original frame to within a maximum angular error. Keys are stored in 48-bit smallest-three form.
+ *
+ * Layout (little-endian):
+ *	header: magic, version, bone count, frame count (4 x int32)
+ *	root translations: frameCount x Vector3
+ *	track table: boneCount x (first key, key count) (2 x int32)
+ *	key frame indices: keyCount x uint16
+ *	key rotations: keyCount x 3 x uint16
+ *
+ * The first and last frames are always keys.
+ */
+public class AnimationClip : IDisposable {
+	public const int Magic = 0x50494c43; //"CLIP"
+	public const int Version = 2;
+	public const int HeaderSize = 4 * sizeof(int);
+	public const float DefaultMaxError = 2e-3f; //radians
+	private const int TranslationSize = 3 * sizeof(float);
+	private const int TrackSize = 2 * sizeof(int);
+	private const int KeyFrameSize = sizeof(ushort);
+	private const int KeyRotationSize = 3 * sizeof(ushort);
+
+	private static Quaternion Interpolate(Quaternion a, Quaternion b, float alpha) {
+		if (Quaternion.Dot(a, b) < 0) {
+			b = -b;
+		}
+		var result = (1 - alpha) * a + alpha * b;
+		result.Normalize();
+		return result;
+	}
+
+	private static float AngleBetween(Quaternion a, Quaternion b) {
+		return (Quaternion.Invert(a) * b).AccurateAngle();
+	}
+
+	/**
+	 * Returns the frame indices to keep as keys for one bone so that interpolating between the (quantized) keys is
+	 * within maxError of every original frame.
+	 */
+	private static List<int> ReduceKeys(Quaternion[] rotations, Quaternion[] quantizedRotations, float maxError) {
+		int frameCount = rotations.Length;
+		var isKey = new bool[frameCount];
+		isKey[0] = true;
+		isKey[frameCount - 1] = true;
+
+		var pendingSpans = new Stack<(int, int)>();
+		pendingSpans.Push((0, frameCount - 1));
+		while (pendingSpans.Count > 0) {
+			var (startFrame, endFrame) = pendingSpans.Pop();
+
+			int worstFrame = -1;
+			float worstError = maxError;
+			for (int frameIdx = startFrame + 1; frameIdx < endFrame; ++frameIdx) {
+				float alpha = (float) (frameIdx - startFrame) / (endFrame - startFrame);
+				var interpolated = Interpolate(quantizedRotations[startFrame], quantizedRotations[endFrame], alpha);
+				float error = AngleBetween(rotations[frameIdx], interpolated);
+				if (error > worstError) {
+					worstFrame = frameIdx;
+					worstError = error;
+				}
+			}
+
+			if (worstFrame != -1) {
+				isKey[worstFrame] = true;
+				pendingSpans.Push((startFrame, worstFrame));
+				pendingSpans.Push((worstFrame, endFrame));
+			}
+		}
+
+		var keys = new List<int>();
+		for (int frameIdx = 0; frameIdx < frameCount; ++frameIdx) {
+			if (isKey[frameIdx]) {
+				keys.Add(frameIdx);
+			}
+		}
+		return keys;
+	}
+
+	public static void Save(FileInfo file, List<Pose> posesByFrame, float maxError = DefaultMaxError) {
+		int frameCount = posesByFrame.Count;
+		if (frameCount == 0) {
+			throw new ArgumentException("clip must have at least one frame");
+		}
+		if (frameCount > ushort.MaxValue) {
+			throw new ArgumentException("clip has too many frames");
+		}
+
+		int boneCount = posesByFrame[0].BoneRotations.Length;
+		foreach (var pose in posesByFrame) {
+			if (pose.BoneRotations.Length != boneCount) {
+				throw new ArgumentException("bone count mismatch");
+			}
+		}
+
+		var keyFrames = new List<int>[boneCount];
+		var encodedRotations = new ushort[boneCount][];
+		for (int boneIdx = 0; boneIdx < boneCount; ++boneIdx) {
+			var rotations = new Quaternion[frameCount];
+			var quantizedRotations = new Quaternion[frameCount];
+			var encodedTrack = new ushort[frameCount * 3];
+			for (int frameIdx = 0; frameIdx < frameCount; ++frameIdx) {
+				rotations[frameIdx] = Quaternion.Normalize(posesByFrame[frameIdx].BoneRotations[boneIdx]);
+				SmallestThreeQuaternion.Encode(rotations[frameIdx], out encodedTrack[frameIdx * 3 + 0], out encodedTrack[frameIdx * 3 + 1], out encodedTrack[frameIdx * 3 + 2]);
+				quantizedRotations[frameIdx] = SmallestThreeQuaternion.Decode(encodedTrack[frameIdx * 3 + 0], encodedTrack[frameIdx * 3 + 1], encodedTrack[frameIdx * 3 + 2]);
+			}
+
+			keyFrames[boneIdx] = ReduceKeys(rotations, quantizedRotations, maxError);
+			encodedRotations[boneIdx] = encodedTrack;
+		}
+
+		try {
+			using (var writer = new BinaryWriter(file.Create())) {
+				writer.Write(Magic);
+				writer.Write(Version);
+				writer.Write(boneCount);
+				writer.Write(frameCount);
+
+				foreach (var pose in posesByFrame) {
+					writer.Write(pose.RootTranslation.X);
+					writer.Write(pose.RootTranslation.Y);
+					writer.Write(pose.RootTranslation.Z);
+				}
+
+				int firstKey = 0;
+				for (int boneIdx = 0; boneIdx < boneCount; ++boneIdx) {
+					writer.Write(firstKey);
+					writer.Write(keyFrames[boneIdx].Count);
+					firstKey += keyFrames[boneIdx].Count;
+				}
+
+				for (int boneIdx = 0; boneIdx < boneCount; ++boneIdx) {
+					foreach (int frameIdx in keyFrames[boneIdx]) {
+						writer.Write((ushort) frameIdx);
+					}
+				}
+
+				for (int boneIdx = 0; boneIdx < boneCount; ++boneIdx) {
+					foreach (int frameIdx in keyFrames[boneIdx]) {
+						writer.Write(encodedRotations[boneIdx][frameIdx * 3 + 0]);
+						writer.Write(encodedRotations[boneIdx][frameIdx * 3 + 1]);
+						writer.Write(encodedRotations[boneIdx][frameIdx * 3 + 2]);
+					}
+				}
+			}
+		} catch (Exception) {
+			file.Delete();
+			throw;
+		}
+	}
+
+	public static bool IsCurrentVersion(FileInfo file) {
+		if (!file.Exists || file.Length < HeaderSize) {
+			return false;
+		}
+
+		using (var reader = new BinaryReader(file.OpenRead())) {
+			return reader.ReadInt32() == Magic && reader.ReadInt32() == Version;
+		}
+	}
+
+	public static AnimationClip Open(IArchiveFile file) {
+		return new AnimationClip(file.OpenDataView());
+	}
+
+	public static Pose LoadPose(IArchiveFile file, int frameIdx) {
+		using (var clip = Open(file)) {
+			return clip.GetPose(frameIdx);
+		}
+	}
+
+	private readonly IArchiveFileDataView dataView;
+	private readonly int boneCount;
+	private readonly int frameCount;
+	private readonly IntPtr translationsPtr;
+	private readonly IntPtr tracksPtr;
+	private readonly IntPtr keyFramesPtr;
+	private readonly IntPtr keyRotationsPtr;
+
+	private AnimationClip(IArchiveFileDataView dataView) {
+		this.dataView = dataView;
+
+		try {
+			var dataPointer = dataView.DataPointer;
+			if (dataPointer.Size < HeaderSize) {
+				throw new InvalidOperationException("animation clip is missing its header");
+			}
+
+			unsafe {
+				int* header = (int*) dataPointer.Pointer;
+				if (header[0] != Magic) {
+					throw new InvalidOperationException("not an animation clip");
+				}
+				if (header[1] != Version) {
+					throw new InvalidOperationException("unsupported animation clip version; re-run the importer");
+				}
+				boneCount = header[2];
+				frameCount = header[3];
+			}
+
+			if (frameCount <= 0 || boneCount < 0) {
+				throw new InvalidOperationException("invalid animation clip header");
+			}
+
+			translationsPtr = dataPointer.Pointer + HeaderSize;
+			tracksPtr = translationsPtr + frameCount * TranslationSize;
+			keyFramesPtr = tracksPtr + boneCount * TrackSize;
+
+			long keyCount = 0;
+			unsafe {
+				int* tracks = (int*) tracksPtr;
+				for (int boneIdx = 0; boneIdx < boneCount; ++boneIdx) {
+					int firstKey = tracks[boneIdx * 2 + 0];
+					int trackKeyCount = tracks[boneIdx * 2 + 1];
+					if (firstKey != keyCount || trackKeyCount <= 0) {
+						throw new InvalidOperationException("invalid animation clip track table");
+					}
+					keyCount += trackKeyCount;
+				}
+			}
+			keyRotationsPtr = keyFramesPtr + (int) (keyCount * KeyFrameSize);
+
+			long expectedSize = HeaderSize + (long) frameCount * TranslationSize + (long) boneCount * TrackSize + keyCount * (KeyFrameSize + KeyRotationSize);
+			if (dataPointer.Size != expectedSize) {
+				throw new InvalidOperationException("animation clip size does not match its header");
+			}
+		} catch (Exception) {
+			dataView.Dispose();
+			throw;
+		}
+	}
+
+	public void Dispose() {
+		dataView.Dispose();
+	}
+
+	public int BoneCount => boneCount;
+	public int FrameCount => frameCount;
+
+	/**
+	 * Adds the clip's pose at a (fractional, looping) frame to a blender with the given weight. Interpolation past
+	 * the last frame wraps around to the first. Does not allocate.
+	 */
+	public unsafe void Sample(float frame, float weight, PoseBlender blender) {
+		if (blender.BoneCount != boneCount) {
+			throw new ArgumentException("bone count mismatch");
+		}
+
+		frame %= frameCount;
+		if (frame < 0) {
+			frame += frameCount;
+		}
+		int baseFrameIdx = Math.Min((int) frame, frameCount - 1);
+		float frameAlpha = frame - baseFrameIdx;
+
+		Vector3* translations = (Vector3*) translationsPtr;
+		var rootTranslation = Vector3.Lerp(translations[baseFrameIdx], translations[(baseFrameIdx + 1) % frameCount], frameAlpha);
+		blender.AddRootTranslation(weight, rootTranslation);
+
+		int* tracks = (int*) tracksPtr;
+		ushort* allKeyFrames = (ushort*) keyFramesPtr;
+		ushort* allKeyRotations = (ushort*) keyRotationsPtr;
+
+		for (int boneIdx = 0; boneIdx < boneCount; ++boneIdx) {
+			int firstKey = tracks[boneIdx * 2 + 0];
+			int keyCount = tracks[boneIdx * 2 + 1];
+			ushort* keyFrames = allKeyFrames + firstKey;
+			ushort* keyRotations = allKeyRotations + firstKey * 3;
+
+			//binary search for the last key at or before baseFrameIdx
+			int lo = 0;
+			int hi = keyCount - 1;
+			while (lo < hi) {
+				int mid = (lo + hi + 1) >> 1;
+				if (keyFrames[mid] <= baseFrameIdx) {
+					lo = mid;
+				} else {
+					hi = mid - 1;
+				}
+			}
+			int prevKey = lo;
+			int nextKey;
+			int nextKeyFrame;
+			if (prevKey == keyCount - 1) {
+				nextKey = 0;
+				nextKeyFrame = frameCount;
+			} else {
+				nextKey = prevKey + 1;
+				nextKeyFrame = keyFrames[nextKey];
+			}
+
+			int prevKeyFrame = keyFrames[prevKey];
+			float alpha = (frame - prevKeyFrame) / (nextKeyFrame - prevKeyFrame);
+
+			ushort* prevRotation = keyRotations + prevKey * 3;
+			ushort* nextRotation = keyRotations + nextKey * 3;
+			SmallestThreeQuaternion.Decode(prevRotation[0], prevRotation[1], prevRotation[2], out float ax, out float ay, out float az, out float aw);
+			SmallestThreeQuaternion.Decode(nextRotation[0], nextRotation[1], nextRotation[2], out float bx, out float by, out float bz, out float bw);
+
+			float prevWeight = 1 - alpha;
+			float nextWeight = alpha;
+			if (ax * bx + ay * by + az * bz + aw * bw < 0) {
+				nextWeight = -nextWeight;
+			}
+
+			blender.AddRotation(boneIdx, weight,
+				prevWeight * ax + nextWeight * bx,
+				prevWeight * ay + nextWeight * by,
+				prevWeight * az + nextWeight * bz,
+				prevWeight * aw + nextWeight * bw);
+		}
+	}
+
+	public Pose GetPose(int frameIdx) {
+		if (frameIdx < 0 || frameIdx >= frameCount) {
+			throw new ArgumentOutOfRangeException(nameof(frameIdx));
+		}
+
+		var blender = new PoseBlender(boneCount);
+		Sample(frameIdx, 1, blender);
+		return blender.GetResult();
+	}
+}
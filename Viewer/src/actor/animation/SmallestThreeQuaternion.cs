@@ -0,0 +1,69 @@
+using SharpDX;
+using System;
+
+/**
+ * 48-bit "smallest three" quaternion encoding: the largest-magnitude component is dropped (and made positive by
+ * negating the quaternion if necessary) and the remaining three, which must lie in [-1/sqrt(2), 1/sqrt(2)], are
+ * quantized to 15 bits each. The index of the dropped component is stored in the top bits of the first two words.
+ */
+public static class SmallestThreeQuaternion {
+	private const int ComponentBits = 15;
+	private const int ComponentMask = (1 << ComponentBits) - 1;
+	private const float ComponentRange = 0.70710678f; //1/sqrt(2)
+	private const float EncodeScale = ComponentMask / (2 * ComponentRange);
+	private const float DecodeScale = (2 * ComponentRange) / ComponentMask;
+
+	public static float MaxComponentError => DecodeScale / 2;
+
+	private static ushort QuantizeComponent(float f) {
+		float quantized = (float) Math.Round((f + ComponentRange) * EncodeScale);
+		return (ushort) MathUtil.Clamp(quantized, 0, ComponentMask);
+	}
+
+	public static void Encode(Quaternion q, out ushort word0, out ushort word1, out ushort word2) {
+		q.Normalize();
+
+		int largestIdx = 0;
+		float largestMagnitude = Math.Abs(q[0]);
+		for (int i = 1; i < 4; ++i) {
+			float magnitude = Math.Abs(q[i]);
+			if (magnitude > largestMagnitude) {
+				largestIdx = i;
+				largestMagnitude = magnitude;
+			}
+		}
+
+		if (q[largestIdx] < 0) {
+			q = -q;
+		}
+
+		float a = q[largestIdx == 0 ? 1 : 0];
+		float b = q[largestIdx <= 1 ? 2 : 1];
+		float c = q[largestIdx <= 2 ? 3 : 2];
+
+		word0 = (ushort) (QuantizeComponent(a) | ((largestIdx & 1) << ComponentBits));
+		word1 = (ushort) (QuantizeComponent(b) | ((largestIdx >> 1) << ComponentBits));
+		word2 = QuantizeComponent(c);
+	}
+
+	public static void Decode(ushort word0, ushort word1, ushort word2, out float x, out float y, out float z, out float w) {
+		int largestIdx = (word0 >> ComponentBits) | ((word1 >> ComponentBits) << 1);
+
+		float a = (word0 & ComponentMask) * DecodeScale - ComponentRange;
+		float b = (word1 & ComponentMask) * DecodeScale - ComponentRange;
+		float c = (word2 & ComponentMask) * DecodeScale - ComponentRange;
+		float largest = (float) Math.Sqrt(Math.Max(0, 1 - a * a - b * b - c * c));
+
+		switch (largestIdx) {
+			case 0: x = largest; y = a; z = b; w = c; break;
+			case 1: x = a; y = largest; z = b; w = c; break;
+			case 2: x = a; y = b; z = largest; w = c; break;
+			default: x = a; y = b; z = c; w = largest; break;
+		}
+	}
+
+	public static Quaternion Decode(ushort word0, ushort word1, ushort word2) {
+		Decode(word0, word1, word2, out float x, out float y, out float z, out float w);
+		return new Quaternion(x, y, z, w);
+	}
+}
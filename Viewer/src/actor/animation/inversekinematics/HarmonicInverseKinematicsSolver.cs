@@ -1,21 +1,68 @@
 using System;
 using System.Collections.Generic;
+using System.Diagnostics;
 using System.Linq;
 using SharpDX;
 using static System.Math;
 using static MathExtensions;
 
+public struct InverseKinematicsSolveStatistics {
+	public int Iterations { get; }
+
+	//largest distance from a goal's source to its target at the start of the last iteration
+	public float Residual { get; }
+
+	public bool Converged { get; }
+	public TimeSpan Elapsed { get; }
+
+	public InverseKinematicsSolveStatistics(int iterations, float residual, bool converged, TimeSpan elapsed) {
+		Iterations = iterations;
+		Residual = residual;
+		Converged = converged;
+		Elapsed = elapsed;
+	}
+
+	public override string ToString() {
+		return String.Format("{0} iterations, residual {1:F4}, {2}, {3:F3}ms",
+			Iterations, Residual, Converged ? "converged" : "not converged", Elapsed.TotalMilliseconds);
+	}
+}
+
+/**
+ * Moves each goal's source towards its target in small steps, stopping once every source is within Tolerance of its
+ * target or after MaxIterations.
+ *
+ * The solve starts from the given inputs, so callers warm start it by passing the previous frame's solution; the
+ * InverseKinematicsAnimator does this by reapplying its pose deltas to each frame's base pose.
+ */
 public class HarmonicInverseKinematicsSolver : IInverseKinematicsSolver {
-	private const int Iterations = 10;
+	public const int DefaultMaxIterations = 10;
+	public const float DefaultTolerance = 0.01f; //cm
 
 	private readonly RigidBoneSystem boneSystem;
 	private readonly BoneAttributes[] boneAttributes;
 	private readonly bool[] areOrientable;
+	private readonly RigidTransform[] boneTransformsBuffer;
+
+	public int MaxIterations { get; }
+	public float Tolerance { get; }
+
+	public InverseKinematicsSolveStatistics LastSolveStatistics { get; private set; }
+
+	public HarmonicInverseKinematicsSolver(RigidBoneSystem boneSystem, BoneAttributes[] boneAttributes, int maxIterations = DefaultMaxIterations, float tolerance = DefaultTolerance) {
+		if (maxIterations < 1) {
+			throw new ArgumentOutOfRangeException(nameof(maxIterations), "at least one iteration is required");
+		}
+		if (tolerance < 0) {
+			throw new ArgumentOutOfRangeException(nameof(tolerance), "tolerance must not be negative");
+		}
 
-	public HarmonicInverseKinematicsSolver(RigidBoneSystem boneSystem, BoneAttributes[] boneAttributes) {
 		this.boneSystem = boneSystem;
 		this.boneAttributes = boneAttributes;
 		areOrientable = MakeAreOrientable(boneSystem);
+		boneTransformsBuffer = new RigidTransform[boneSystem.Bones.Length];
+		MaxIterations = maxIterations;
+		Tolerance = tolerance;
 	}
 
 	private static bool[] MakeAreOrientable(RigidBoneSystem boneSystem) {
@@ -272,11 +319,21 @@ public class HarmonicInverseKinematicsSolver : IInverseKinematicsSolver {
 		parentBone.SetTwistOnly(inputs, parentNewLocalRotation);
 	}
 
-	private void ApplyPositionGoal(InverseKinematicsGoal goal, RigidBoneSystemInputs inputs) {
-		var boneTransforms = boneSystem.GetBoneTransforms(inputs);
-		var centersOfMass = GetCentersOfMass(boneTransforms);
+	/**
+	 * Steps the source towards the target and returns the distance between them before the step. No step is taken if
+	 * the source is already within tolerance.
+	 */
+	private float ApplyPositionGoal(InverseKinematicsGoal goal, RigidBoneSystemInputs inputs) {
+		var boneTransforms = boneTransformsBuffer;
+		boneSystem.GetBoneTransforms(inputs, boneTransforms);
 		
 		var sourcePosition = boneTransforms[goal.SourceBone.Index].Transform(goal.SourceBone.CenterPoint + goal.UnposedSourcePosition);
+		float residual = Vector3.Distance(sourcePosition, goal.TargetPosition);
+		if (residual <= Tolerance) {
+			return residual;
+		}
+
+		var centersOfMass = GetCentersOfMass(boneTransforms);
 
 		var bones = GetBoneChain(goal.SourceBone, goal.HasOrientation).ToArray();
 		//var bones = new RigidBone[] { boneSystem.BonesByName["lForearmBend"], boneSystem.BonesByName["lShldrBend"] };
@@ -305,18 +362,35 @@ public class HarmonicInverseKinematicsSolver : IInverseKinematicsSolver {
 		ApplyPartialSolution(rootTranslationPartialSolution, inputs, time);
 
 		CountertransformOffChainBones(boneTransforms, centersOfMass, inputs, bones);
+
+		return residual;
 	}
 
-	private void DoIteration(int iteration, InverseKinematicsGoal goal, RigidBoneSystemInputs inputs) {
+	private float DoIteration(int iteration, InverseKinematicsGoal goal, RigidBoneSystemInputs inputs) {
 		ApplyOrientationGoal(goal, inputs);
-		ApplyPositionGoal(goal, inputs);
+		return ApplyPositionGoal(goal, inputs);
 	}
 	
 	public void Solve(RigidBoneSystem boneSystem, List<InverseKinematicsGoal> goals, RigidBoneSystemInputs inputs) {
-		for (int i = 0; i < Iterations; ++i) {
+		long startTimestamp = Stopwatch.GetTimestamp();
+
+		int iterationCount = 0;
+		float residual = 0;
+		bool converged = true;
+		for (int i = 0; i < MaxIterations && goals.Count > 0; ++i) {
+			residual = 0;
 			foreach (var goal in goals) {
-				DoIteration(i, goal, inputs);
+				residual = Max(residual, DoIteration(i, goal, inputs));
+			}
+			iterationCount += 1;
+
+			converged = residual <= Tolerance;
+			if (converged) {
+				break;
 			}
 		}
+
+		var elapsed = TimeSpan.FromSeconds((double) (Stopwatch.GetTimestamp() - startTimestamp) / Stopwatch.Frequency);
+		LastSolveStatistics = new InverseKinematicsSolveStatistics(iterationCount, residual, converged, elapsed);
 	}
 }
@@ -2,6 +2,8 @@ using SharpDX;
 using System.Collections.Generic;
 
 public class InverseKinematicsAnimator {
+	private static readonly ProfilerStage SolveStage = FrameProfiler.RegisterStage("inverse-kinematics");
+
 	private readonly ChannelSystem channelSystem;
 	private readonly RigidBoneSystem boneSystem;
 	private readonly IInverseKinematicsGoalProvider goalProvider;
@@ -47,7 +49,9 @@ public class InverseKinematicsAnimator {
 		
 		List<InverseKinematicsGoal> goals = goalProvider.GetGoals(updateParameters, resultInputs, previousFrameControlVertexInfos);
 		
-		solver.Solve(boneSystem, goals, resultInputs);
+		using (SolveStage.Measure()) {
+			solver.Solve(boneSystem, goals, resultInputs);
+		}
 		poseDeltas = boneSystem.CalculateDeltas(baseInputs, resultInputs);
 		
 		boneSystem.WriteInputs(channelInputs, channelOutputs, resultInputs);
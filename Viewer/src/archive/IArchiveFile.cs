@@ -6,6 +6,16 @@ public interface IArchiveFileDataView : IDisposable {
 	DataPointer DataPointer { get; }
 }
 
+/**
+ * The view of an empty file, which can't be mapped.
+ */
+public class EmptyArchiveFileDataView : IArchiveFileDataView {
+	public DataPointer DataPointer => new DataPointer(IntPtr.Zero, 0);
+
+	public void Dispose() {
+	}
+}
+
 public interface IArchiveFile {
 	string Name { get; }
 	Stream OpenRead();
@@ -6,11 +6,15 @@ public class PackedArchiveFileRecord {
 	public string Name { get; }
 	public long Offset { get; }
 	public long Size { get; }
+	public long LastWriteTime { get; } //source file timestamp in UTC ticks, used for incremental repacking
+	public string Hash { get; } //content hash or null if the file wasn't hashed during packing
 
-	public PackedArchiveFileRecord(string name, long offset, long size) {
+	public PackedArchiveFileRecord(string name, long offset, long size, long lastWriteTime = 0, string hash = null) {
 		Name = name;
 		Offset = offset;
 		Size = size;
+		LastWriteTime = lastWriteTime;
+		Hash = hash;
 	}
 }
 
@@ -31,6 +35,7 @@ public class PackedArchive : IDisposable {
 
 	private readonly MemoryMappedFile map;
 	private readonly long payloadOffset;
+	private readonly PackedArchiveDirectoryRecord rootRecord;
 	private readonly PackedArchiveDirectory root;
 
 	public PackedArchive(FileInfo file) {
@@ -42,7 +47,6 @@ public class PackedArchive : IDisposable {
 			payloadOffset = headerAccessor.ReadInt64(sizeof(long));
 		}
 
-		PackedArchiveDirectoryRecord rootRecord;
 		using (var listingStream = map.CreateViewStream(HeaderSize, listingSize, MemoryMappedFileAccess.Read)) {
 			rootRecord = Persistance.Read<PackedArchiveDirectoryRecord>(listingStream);
 		}
@@ -52,6 +56,7 @@ public class PackedArchive : IDisposable {
 
 
 	public PackedArchiveDirectory Root => root;
+	public PackedArchiveDirectoryRecord RootRecord => rootRecord;
 
 	public void Dispose() {
 		map.Dispose();
@@ -6,6 +6,7 @@ using System.IO.MemoryMappedFiles;
 public class PackedArchiveFileDataView : IArchiveFileDataView {
 	private readonly MemoryMappedViewAccessor accessor;
 	private readonly DataPointer dataPointer;
+	private readonly MemoryAllocation allocation;
 	
 	public PackedArchiveFileDataView(MemoryMappedViewAccessor accessor, long size) {
 		this.accessor = accessor;
@@ -16,6 +17,8 @@ public class PackedArchiveFileDataView : IArchiveFileDataView {
 			ptr += accessor.PointerOffset;
 			dataPointer = new DataPointer((IntPtr) ptr, (int) size);
 		}
+
+		allocation = MemoryAccounting.Track(MemoryAccounting.ArchiveViews, size);
 	}
 
 	public DataPointer DataPointer => dataPointer;
@@ -23,6 +26,7 @@ public class PackedArchiveFileDataView : IArchiveFileDataView {
 	public void Dispose() {
 		accessor.SafeMemoryMappedViewHandle.ReleasePointer();
 		accessor.Dispose();
+		allocation.Dispose();
 	}
 }
 
@@ -38,6 +42,10 @@ public class PackedArchiveFile : IArchiveFile {
 	public string Name => record.Name;
 
 	public IArchiveFileDataView OpenDataView() {
+		if (record.Size == 0) {
+			//CreateViewAccessor interprets size = 0 as "whole file"
+			return new EmptyArchiveFileDataView();
+		}
 		return new PackedArchiveFileDataView(archive.OpenAccessor(record), record.Size);
 	}
 
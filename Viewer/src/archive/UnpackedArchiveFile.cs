@@ -7,6 +7,7 @@ public class UnpackedArchiveFileDataView : IArchiveFileDataView {
 	private readonly MemoryMappedFile map;
 	private readonly MemoryMappedViewAccessor accessor;
 	private readonly DataPointer dataPointer;
+	private readonly MemoryAllocation allocation;
 	
 	public UnpackedArchiveFileDataView(FileInfo file) {
 		long size = file.Length;
@@ -18,6 +19,8 @@ public class UnpackedArchiveFileDataView : IArchiveFileDataView {
 			accessor.SafeMemoryMappedViewHandle.AcquirePointer(ref ptr);
 			dataPointer = new DataPointer((IntPtr) ptr, (int) size);
 		}
+
+		allocation = MemoryAccounting.Track(MemoryAccounting.ArchiveViews, size);
 	}
 
 	public DataPointer DataPointer => dataPointer;
@@ -26,6 +29,7 @@ public class UnpackedArchiveFileDataView : IArchiveFileDataView {
 		accessor.SafeMemoryMappedViewHandle.ReleasePointer();
 		accessor.Dispose();
 		map.Dispose();
+		allocation.Dispose();
 	}
 }
 
@@ -55,6 +59,9 @@ public class UnpackedArchiveFile : IArchiveFile {
 	}
 
 	public IArchiveFileDataView OpenDataView() {
+		if (info.Length == 0) {
+			return new EmptyArchiveFileDataView();
+		}
 		return new UnpackedArchiveFileDataView(info);
 	}
 }
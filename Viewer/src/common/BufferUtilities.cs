@@ -4,7 +4,11 @@ using Buffer = SharpDX.Direct3D11.Buffer;
 using Device = SharpDX.Direct3D11.Device;
 
 public class BufferUtilities {
-	public static ShaderResourceView ToStructuredBufferView<T>(Device device, T[] array) where T : struct {
+	/**
+	 * Uploads the array to an immutable structured buffer, counted against the given memory category (GPU buffers by
+	 * default) until the view is disposed.
+	 */
+	public static ShaderResourceView ToStructuredBufferView<T>(Device device, T[] array, MemoryCounter memoryCategory = null) where T : struct {
 		if (array == null) {
 			return null;
 		}
@@ -13,8 +17,11 @@ public class BufferUtilities {
 			return null; //buffers cannot have size zero
 		}
 
-		using (Buffer buffer = Buffer.Create(device, BindFlags.ShaderResource, array, usage: ResourceUsage.Immutable, optionFlags: ResourceOptionFlags.BufferStructured, structureByteStride: Marshal.SizeOf<T>())) {
-			return new ShaderResourceView(device, buffer);
+		int elementSizeInBytes = Marshal.SizeOf<T>();
+		using (Buffer buffer = Buffer.Create(device, BindFlags.ShaderResource, array, usage: ResourceUsage.Immutable, optionFlags: ResourceOptionFlags.BufferStructured, structureByteStride: elementSizeInBytes)) {
+			var view = new ShaderResourceView(device, buffer);
+			MemoryAccounting.TrackUntilDisposed(memoryCategory ?? MemoryAccounting.GpuBuffers, view, (long) array.Length * elementSizeInBytes);
+			return view;
 		}
 	}
 
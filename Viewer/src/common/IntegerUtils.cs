@@ -1,11 +1,18 @@
 using System;
 using System.Collections.Generic;
 using System.Linq;
+using System.Runtime.InteropServices;
 using System.Text;
 using System.Threading.Tasks;
 using SharpDX.Direct3D11;
 
 public static class IntegerUtils {
+	[StructLayout(LayoutKind.Explicit)]
+	private struct FloatBits {
+		[FieldOffset(0)] public float value;
+		[FieldOffset(0)] public uint bits;
+	}
+
 	public static int RoundUp(int num, int divisor) {
 		return (num + divisor - 1) / divisor;
 	}
@@ -42,6 +49,73 @@ public static class IntegerUtils {
 		return (value + 0.5f) / (float) (ushort.MaxValue + 1);
 	}
 
+	/**
+	 * Converts a float to the bits of a half float, rounding to nearest even like HLSL's f32tof16.
+	 */
+	public static ushort ToHalf(float f) {
+		uint bits = new FloatBits { value = f }.bits;
+		uint sign = (bits >> 16) & 0x8000;
+		int exponent = (int) ((bits >> 23) & 0xff);
+		uint mantissa = bits & 0x7fffff;
+
+		if (exponent == 0xff) {
+			//infinity or NaN
+			return (ushort) (sign | 0x7c00 | (mantissa != 0 ? 0x200u : 0));
+		}
+
+		int halfExponent = exponent - 127 + 15;
+		if (halfExponent >= 0x1f) {
+			return (ushort) (sign | 0x7c00);
+		}
+
+		int shift;
+		uint halfBits;
+		if (halfExponent <= 0) {
+			//subnormal
+			if (halfExponent < -10) {
+				return (ushort) sign;
+			}
+			mantissa |= 0x800000;
+			shift = 14 - halfExponent;
+			halfBits = mantissa >> shift;
+		} else {
+			shift = 13;
+			halfBits = ((uint) halfExponent << 10) | (mantissa >> shift);
+		}
+
+		//a carry out of the mantissa correctly bumps the exponent
+		uint remainder = mantissa & ((1u << shift) - 1);
+		uint halfway = 1u << (shift - 1);
+		if (remainder > halfway || (remainder == halfway && (halfBits & 1) != 0)) {
+			halfBits += 1;
+		}
+
+		return (ushort) (sign | halfBits);
+	}
+
+	/**
+	 * Converts the bits of a half float to a float, like HLSL's f16tof32.
+	 */
+	public static float FromHalf(ushort half) {
+		uint sign = (uint) (half & 0x8000) << 16;
+		int exponent = (half >> 10) & 0x1f;
+		uint mantissa = (uint) half & 0x3ff;
+
+		if (exponent == 0) {
+			//zero or subnormal, which is exactly representable as mantissa * 2^-24
+			float magnitude = mantissa * (1f / (1 << 24));
+			return sign != 0 ? -magnitude : magnitude;
+		}
+
+		uint bits;
+		if (exponent == 0x1f) {
+			bits = sign | 0x7f800000 | (mantissa << 13);
+		} else {
+			bits = sign | ((uint) (exponent - 15 + 127) << 23) | (mantissa << 13);
+		}
+		return new FloatBits { bits = bits }.value;
+	}
+
 	public static uint Pack(ushort lower, ushort upper) {
 		return ((uint) upper << 16) | lower;
 	}
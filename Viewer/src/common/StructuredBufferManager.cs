@@ -9,6 +9,7 @@ public class StructuredBufferManager<T> : IDisposable where T : struct {
 	private readonly Device device;
 	private readonly Buffer buffer;
 	private readonly ShaderResourceView view;
+	private readonly MemoryAllocation allocation;
 
 	public StructuredBufferManager(Device device, int count) {
 		this.device = device;
@@ -28,12 +29,14 @@ public class StructuredBufferManager<T> : IDisposable where T : struct {
 			};
 			this.buffer = new Buffer(device, description);
 			this.view = new ShaderResourceView(device, buffer);
+			this.allocation = MemoryAccounting.Track(MemoryAccounting.GpuBuffers, description.SizeInBytes);
 		}
 	}
 
 	public void Dispose() {
 		buffer?.Dispose();
 		view?.Dispose();
+		allocation?.Dispose();
 	}
 
 	public ShaderResourceView View => view;
@@ -0,0 +1,60 @@
+using SharpDX.Direct3D11;
+using System;
+using Format = SharpDX.DXGI.Format;
+
+/**
+ * The validated header of a DDS file: everything needed to lay out the texture without reading its pixel data.
+ */
+public class DdsDescription {
+	public ResourceDimension Dimension { get; }
+	public Format Format { get; }
+	public int Width { get; }
+	public int Height { get; }
+	public int Depth { get; }
+	public int MipCount { get; }
+	public int ArraySize { get; }
+	public bool IsCubeMap { get; }
+	public int DataOffset { get; } //offset of the first subresource from the start of the file
+
+	public DdsDescription(ResourceDimension dimension, Format format, int width, int height, int depth, int mipCount, int arraySize, bool isCubeMap, int dataOffset) {
+		Dimension = dimension;
+		Format = format;
+		Width = width;
+		Height = height;
+		Depth = depth;
+		MipCount = mipCount;
+		ArraySize = arraySize;
+		IsCubeMap = isCubeMap;
+		DataOffset = dataOffset;
+	}
+
+	public int GetMipWidth(int mipIdx) {
+		return Math.Max(Width >> mipIdx, 1);
+	}
+
+	public int GetMipHeight(int mipIdx) {
+		return Math.Max(Height >> mipIdx, 1);
+	}
+
+	public int GetMipDepth(int mipIdx) {
+		return Math.Max(Depth >> mipIdx, 1);
+	}
+
+	/**
+	 * Returns the most detailed mip whose dimensions are all at most maxSize, or 0 if maxSize is 0 (unlimited). The
+	 * last mip is returned if even it is too large.
+	 */
+	public int GetFirstMipWithin(int maxSize) {
+		if (maxSize == 0) {
+			return 0;
+		}
+
+		for (int mipIdx = 0; mipIdx < MipCount; ++mipIdx) {
+			if (GetMipWidth(mipIdx) <= maxSize && GetMipHeight(mipIdx) <= maxSize && GetMipDepth(mipIdx) <= maxSize) {
+				return mipIdx;
+			}
+		}
+
+		return MipCount - 1;
+	}
+}
@@ -0,0 +1,36 @@
+using SharpDX;
+using SharpDX.Direct3D11;
+using Format = SharpDX.DXGI.Format;
+
+/**
+ * A range of mips from a parsed DDS file, with the location of each of their subresources in the file's memory.
+ * Contains no GPU resources, so it can be produced on any thread.
+ */
+public class DdsImage {
+	public DdsDescription Description { get; }
+	public int FirstMip { get; }
+	public int MipCount { get; }
+	public DataBox[] Subresources { get; } //ordered by array slice, then by mip
+	public long ByteCount { get; }
+
+	public DdsImage(DdsDescription description, int firstMip, int mipCount, DataBox[] subresources, long byteCount) {
+		Description = description;
+		FirstMip = firstMip;
+		MipCount = mipCount;
+		Subresources = subresources;
+		ByteCount = byteCount;
+	}
+
+	public ResourceDimension Dimension => Description.Dimension;
+	public Format Format => Description.Format;
+	public int Width => Description.GetMipWidth(FirstMip);
+	public int Height => Description.GetMipHeight(FirstMip);
+	public int Depth => Description.GetMipDepth(FirstMip);
+	public int ArraySize => Description.ArraySize;
+	public bool IsCubeMap => Description.IsCubeMap;
+
+	/**
+	 * True if the image includes the most detailed mip of the file.
+	 */
+	public bool IsComplete => FirstMip == 0;
+}
@@ -8,7 +8,7 @@ using SharpDX.Win32;
 using System.Diagnostics;
 using SharpDX.Direct3D;
 
-static class DdsLoader {
+public static class DdsLoader {
 	[StructLayout(LayoutKind.Sequential, Pack = 1)]
 	struct DdsPixelFormat {
 		public static readonly int SIZE = Marshal.SizeOf<DdsPixelFormat>();
@@ -424,22 +424,10 @@ static class DdsLoader {
 		return Format.Unknown;
 	}
 
-	private static void CreateTextureFromDDS(
-		Device d3dDevice,
+	private static DdsDescription ParseDescription(
 		DdsHeader header,
 		DdsHeaderDxt10? headerDxt10,
-		IntPtr bitData,
-		int bitSize,
-		int maxsize,
-		ResourceUsage usage,
-		BindFlags bindFlags,
-		CpuAccessFlags cpuAccessFlags,
-		ResourceOptionFlags miscFlags,
-		bool forceSRGB,
-		out Resource texture,
-		out ShaderResourceView textureView) {
-		Result hr = Result.Ok;
-
+		int dataOffset) {
 		int width = (int)header.width;
 		int height = (int)header.height;
 		int depth = (int)header.depth;
@@ -580,15 +568,7 @@ static class DdsLoader {
 				throw new SharpDXException(ErrorCodeHelper.ToResult(ErrorCode.NotSupported));
 		}
 
-		// Create the texture
-		DataBox[] initData = new DataBox[mipCount * arraySize];
-
-		FillInitData(width, height, depth, mipCount, (int)arraySize, format, maxsize, bitSize, bitData,
-			out int twidth, out int theight, out int tdepth, out int skipMip, initData);
-
-		CreateD3DResources(d3dDevice, resDim, twidth, theight, tdepth, mipCount - skipMip, (int)arraySize,
-			format, usage, bindFlags, cpuAccessFlags, miscFlags, forceSRGB,
-			isCubeMap, initData, out texture, out textureView);
+		return new DdsDescription(resDim, format, width, height, depth, mipCount, (int)arraySize, isCubeMap, dataOffset);
 	}
 
 	private static void GetSurfaceInfo(
@@ -698,90 +678,73 @@ static class DdsLoader {
 		outNumRows = numRows;
 	}
 
-	private static void FillInitData(
-		int width,
-		int height,
-		int depth,
-		int mipCount,
-		int arraySize,
-		Format format,
-		int maxsize,
-		int bitSize,
-		IntPtr bitData,
-		out int twidth,
-		out int theight,
-		out int tdepth,
-		out int skipMip,
-		DataBox[] initData) {
-		if (bitData == IntPtr.Zero || initData == null) {
-			throw new SharpDXException(Result.InvalidPointer);
+	private static long GetMipByteCount(DdsDescription description, int mipIdx, out int rowBytes, out int sliceBytes) {
+		GetSurfaceInfo(description.GetMipWidth(mipIdx),
+			description.GetMipHeight(mipIdx),
+			description.Format,
+			out sliceBytes,
+			out rowBytes,
+			out int numRows);
+		return (long) sliceBytes * description.GetMipDepth(mipIdx);
+	}
+
+	/**
+	 * Returns the total size of the pixel data for one array slice, i.e. the stride between array slices.
+	 */
+	private static long GetArraySliceByteCount(DdsDescription description) {
+		long byteCount = 0;
+		for (int mipIdx = 0; mipIdx < description.MipCount; ++mipIdx) {
+			byteCount += GetMipByteCount(description, mipIdx, out int rowBytes, out int sliceBytes);
 		}
+		return byteCount;
+	}
 
-		skipMip = 0;
-		twidth = 0;
-		theight = 0;
-		tdepth = 0;
-		
-		IntPtr pSrcBits = bitData;
-		IntPtr pEndBits = bitData + bitSize;
+	/**
+	 * Returns the number of bytes from the start of the file up to the end of the given mip range in the last array
+	 * slice, i.e. the minimum file size from which the range can be extracted.
+	 */
+	public static long GetRequiredFileSize(DdsDescription description, int firstMip, int mipCount) {
+		long mipRangeEnd = 0;
+		for (int mipIdx = 0; mipIdx < firstMip + mipCount; ++mipIdx) {
+			mipRangeEnd += GetMipByteCount(description, mipIdx, out int rowBytes, out int sliceBytes);
+		}
+		return description.DataOffset + (description.ArraySize - 1) * GetArraySliceByteCount(description) + mipRangeEnd;
+	}
 
-		int index = 0;
-		for (int j = 0; j < arraySize; j++) {
-			int w = width;
-			int h = height;
-			int d = depth;
-			for (int i = 0; i < mipCount; i++) {
-				GetSurfaceInfo(w,
-					h,
-					format,
-					out int NumBytes,
-					out int RowBytes,
-					out int NumRows
-				);
-
-				if ((mipCount <= 1) || (maxsize == 0) || (w <= maxsize && h <= maxsize && d <= maxsize)) {
-					if (twidth == 0) {
-						twidth = w;
-						theight = h;
-						tdepth = d;
-					}
+	private static DdsImage LocateSubresources(DdsDescription description, DataPointer dataPointer, int firstMip, int mipCount) {
+		if (firstMip < 0 || mipCount <= 0 || firstMip + mipCount > description.MipCount) {
+			throw new SharpDXException(Result.InvalidArg);
+		}
 
-					Debug.Assert(index < mipCount * arraySize);
-					initData[index].DataPointer = pSrcBits;
-					initData[index].RowPitch = RowBytes;
-					initData[index].SlicePitch = NumBytes;
-					++index;
-				} else if (j == 0) {
-					// Count number of skipped mipmaps (first item only)
-					++skipMip;
-				}
+		if (GetRequiredFileSize(description, firstMip, mipCount) > dataPointer.Size) {
+			throw new SharpDXException(ErrorCodeHelper.ToResult(ErrorCode.HandleEof));
+		}
 
-				if ((long)pSrcBits + (NumBytes * d) > (long)pEndBits) {
-					throw new SharpDXException(ErrorCodeHelper.ToResult(ErrorCode.HandleEof));
-				}
+		long arraySliceByteCount = GetArraySliceByteCount(description);
 
-				pSrcBits += NumBytes * d;
+		long firstMipOffset = 0;
+		for (int mipIdx = 0; mipIdx < firstMip; ++mipIdx) {
+			firstMipOffset += GetMipByteCount(description, mipIdx, out int rowBytes, out int sliceBytes);
+		}
 
-				w = w >> 1;
-				h = h >> 1;
-				d = d >> 1;
-				if (w == 0) {
-					w = 1;
-				}
-				if (h == 0) {
-					h = 1;
-				}
-				if (d == 0) {
-					d = 1;
-				}
+		DataBox[] subresources = new DataBox[mipCount * description.ArraySize];
+		long byteCount = 0;
+		int index = 0;
+		for (int arrayIdx = 0; arrayIdx < description.ArraySize; ++arrayIdx) {
+			long offset = description.DataOffset + arrayIdx * arraySliceByteCount + firstMipOffset;
+			for (int mipIdx = firstMip; mipIdx < firstMip + mipCount; ++mipIdx) {
+				long mipByteCount = GetMipByteCount(description, mipIdx, out int rowBytes, out int sliceBytes);
+				subresources[index].DataPointer = new IntPtr((long) dataPointer.Pointer + offset);
+				subresources[index].RowPitch = rowBytes;
+				subresources[index].SlicePitch = sliceBytes;
+				++index;
+
+				offset += mipByteCount;
+				byteCount += mipByteCount;
 			}
 		}
 
-		if (index > 0) {
-			return;
-		} else {
-			throw new SharpDXException(Result.Fail);
-		}
+		return new DdsImage(description, firstMip, mipCount, subresources, byteCount);
 	}
 
 	private static Format MakeSRGB(Format format) {
@@ -946,24 +909,10 @@ static class DdsLoader {
 		}
 	}
 
-	public static void CreateDDSTextureFromMemory(Device d3dDevice,
-		DataPointer dataPointer,
-		out Resource texture,
-		out ShaderResourceView textureView,
-		int maxsize = 0,
-		ResourceUsage usage = ResourceUsage.Default,
-		BindFlags bindFlags = BindFlags.ShaderResource,
-		CpuAccessFlags cpuAccessFlags = CpuAccessFlags.None,
-		ResourceOptionFlags miscFlags = ResourceOptionFlags.None,
-		bool forceSRGB = false
-	) {
-		texture = null;
-		textureView = null;
-
-		if (d3dDevice == null) {
-			throw new SharpDXException(Result.InvalidArg);
-		}
-
+	/**
+	 * Parses and validates the headers of a DDS file. Only the first HeaderSize bytes of the file need to be readable.
+	 */
+	public static DdsDescription ParseHeader(DataPointer dataPointer) {
 		// Validate DDS file in memory
 		if (dataPointer.Size < (sizeof(uint) + DdsHeader.SIZE)) {
 			throw new SharpDXException(Result.Fail);
@@ -1003,10 +952,69 @@ static class DdsLoader {
 			+ DdsHeader.SIZE
 			+ (bDXT10Header ? DdsHeaderDxt10.SIZE : 0);
 
-		CreateTextureFromDDS(d3dDevice, header, headerDxt10,
-			dataPointer.Pointer + offset, dataPointer.Size - offset, maxsize,
-			usage, bindFlags, cpuAccessFlags, miscFlags, forceSRGB,
-			out texture, out textureView);
+		return ParseDescription(header, headerDxt10, offset);
+	}
+
+	/**
+	 * The largest number of bytes ParseHeader reads.
+	 */
+	public static int HeaderSize => sizeof(uint) + DdsHeader.SIZE + DdsHeaderDxt10.SIZE;
+
+	/**
+	 * Locates a range of mips in a DDS file in memory without touching the GPU. Only the header and the requested mips
+	 * are read, so when the memory is a mapped view, less detailed mips can be loaded without paging in the larger ones.
+	 * The returned image's subresources point into the supplied memory, which must stay valid until the texture has been
+	 * created from it.
+	 */
+	public static DdsImage Decode(DataPointer dataPointer, int firstMip, int mipCount) {
+		var description = ParseHeader(dataPointer);
+		return LocateSubresources(description, dataPointer, firstMip, mipCount);
+	}
+
+	/**
+	 * Locates all mips no larger than maxsize (0 for unlimited) in a DDS file in memory.
+	 */
+	public static DdsImage Decode(DataPointer dataPointer, int maxsize = 0) {
+		var description = ParseHeader(dataPointer);
+		int firstMip = description.GetFirstMipWithin(maxsize);
+		return LocateSubresources(description, dataPointer, firstMip, description.MipCount - firstMip);
+	}
+
+	public static void CreateTexture(Device d3dDevice,
+		DdsImage image,
+		out Resource texture,
+		out ShaderResourceView textureView,
+		ResourceUsage usage = ResourceUsage.Default,
+		BindFlags bindFlags = BindFlags.ShaderResource,
+		CpuAccessFlags cpuAccessFlags = CpuAccessFlags.None,
+		ResourceOptionFlags miscFlags = ResourceOptionFlags.None,
+		bool forceSRGB = false
+	) {
+		CreateD3DResources(d3dDevice, image.Dimension, image.Width, image.Height, image.Depth, image.MipCount, image.ArraySize,
+			image.Format, usage, bindFlags, cpuAccessFlags, miscFlags, forceSRGB,
+			image.IsCubeMap, image.Subresources, out texture, out textureView);
+	}
+
+	public static void CreateDDSTextureFromMemory(Device d3dDevice,
+		DataPointer dataPointer,
+		out Resource texture,
+		out ShaderResourceView textureView,
+		int maxsize = 0,
+		ResourceUsage usage = ResourceUsage.Default,
+		BindFlags bindFlags = BindFlags.ShaderResource,
+		CpuAccessFlags cpuAccessFlags = CpuAccessFlags.None,
+		ResourceOptionFlags miscFlags = ResourceOptionFlags.None,
+		bool forceSRGB = false
+	) {
+		texture = null;
+		textureView = null;
+
+		if (d3dDevice == null) {
+			throw new SharpDXException(Result.InvalidArg);
+		}
+
+		var image = Decode(dataPointer, maxsize);
+		CreateTexture(d3dDevice, image, out texture, out textureView, usage, bindFlags, cpuAccessFlags, miscFlags, forceSRGB);
 	}
 
 	public static void CreateDDSTextureFromMemory(Device d3dDevice,
@@ -12,16 +12,20 @@ public class InOutStructuredBufferManager<T> : IDisposable where T : struct {
 	public ShaderResourceView InView { get; }
 	public UnorderedAccessView OutView { get; }
 
+	private readonly MemoryAllocation allocation;
+
 	public InOutStructuredBufferManager(Device device, int elementCount) {
 		Buffer = new Buffer(device, elementCount * elementSizeInBytes, ResourceUsage.Default, BindFlags.UnorderedAccess | BindFlags.ShaderResource, CpuAccessFlags.None, ResourceOptionFlags.BufferStructured, structureByteStride: elementSizeInBytes);
 		InView = new ShaderResourceView(device, Buffer);
 		OutView = new UnorderedAccessView(device, Buffer);
+		allocation = MemoryAccounting.Track(MemoryAccounting.GpuBuffers, (long) elementCount * elementSizeInBytes);
 	}
 	
 	public void Dispose() {
 		Buffer.Dispose();
 		InView.Dispose();
 		OutView.Dispose();
+		allocation.Dispose();
 	}
 
 	public void Update(DeviceContext context, T[] data, int offset) {
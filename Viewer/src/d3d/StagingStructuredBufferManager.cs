@@ -7,6 +7,7 @@ using Device = SharpDX.Direct3D11.Device;
 
 public class StagingStructuredBufferManager<T> : IDisposable where T : struct {
 	private Buffer buffer;
+	private readonly MemoryAllocation allocation;
 
 	private T[][] arrays;
 	private int nextArrayIdx;
@@ -15,6 +16,7 @@ public class StagingStructuredBufferManager<T> : IDisposable where T : struct {
 		int elementSizeInBytes = Marshal.SizeOf<T>();
 
 		buffer = new Buffer(device, elementCount * elementSizeInBytes, ResourceUsage.Staging, BindFlags.None, CpuAccessFlags.Read, ResourceOptionFlags.BufferStructured, structureByteStride: elementSizeInBytes);
+		allocation = MemoryAccounting.Track(MemoryAccounting.GpuBuffers, (long) elementCount * elementSizeInBytes);
 
 		arrays = new T[arrayCount][];
 		for (int i = 0; i < arrayCount; ++i) {
@@ -24,6 +26,7 @@ public class StagingStructuredBufferManager<T> : IDisposable where T : struct {
 	
 	public void Dispose() {
 		buffer.Dispose();
+		allocation.Dispose();
 	}
 
 	public void CopyToStagingBuffer(DeviceContext context, Buffer sourceBuffer) {
@@ -1,89 +1,440 @@
 using SharpDX.Direct3D11;
 using System;
+using System.Collections.Concurrent;
 using System.Collections.Generic;
+using System.Threading;
 
 public struct SharedTexture : IDisposable {
-	private TextureCache.Entry cacheEntry;
-	
-	public SharedTexture(TextureCache.Entry cacheEntry) {
-		cacheEntry.AddRef();
+	private readonly TextureCache.Entry cacheEntry;
+	private readonly ShaderResourceView placeholder;
+
+	public SharedTexture(TextureCache.Entry cacheEntry, ShaderResourceView placeholder) {
+		cacheEntry?.AddRef();
 		this.cacheEntry = cacheEntry;
+		this.placeholder = placeholder;
+	}
+
+	/**
+	 * Wraps a view which isn't managed by a cache.
+	 */
+	public static SharedTexture MakeUnshared(ShaderResourceView view) {
+		return new SharedTexture(null, view);
 	}
-	
+
 	public void Dispose() {
-		cacheEntry.Release();
+		cacheEntry?.Release();
 	}
 
-	public static implicit operator ShaderResourceView(SharedTexture sharedTexture) {
-		return sharedTexture.cacheEntry.Resource;
+	/**
+	 * The loaded texture, or the placeholder while the load is pending or if it failed. Because the view changes when
+	 * the load completes, it should be looked up each time the texture is bound rather than stored.
+	 */
+	public ShaderResourceView View => cacheEntry?.Resource ?? placeholder;
+
+	public bool IsLoaded => cacheEntry == null || cacheEntry.Resource != null;
+}
+
+public class TextureCacheStatistics {
+	public int Hits { get; }
+	public int Misses { get; }
+	public int Evictions { get; }
+	public int FailedLoads { get; }
+	public int StreamedLoads { get; }
+	public int PendingLoads { get; }
+	public int ResidentCount { get; }
+	public long ResidentBytes { get; }
+	public long BudgetBytes { get; }
+
+	public TextureCacheStatistics(int hits, int misses, int evictions, int failedLoads, int streamedLoads, int pendingLoads, int residentCount, long residentBytes, long budgetBytes) {
+		Hits = hits;
+		Misses = misses;
+		Evictions = evictions;
+		FailedLoads = failedLoads;
+		StreamedLoads = streamedLoads;
+		PendingLoads = pendingLoads;
+		ResidentCount = residentCount;
+		ResidentBytes = residentBytes;
+		BudgetBytes = budgetBytes;
+	}
+
+	public override string ToString() {
+		return String.Format("{0} hits, {1} misses, {2} evictions, {3} failed, {4} streamed, {5} pending; {6} resident using {7:F1} of {8:F1} MB",
+			Hits, Misses, Evictions, FailedLoads, StreamedLoads, PendingLoads,
+			ResidentCount, ResidentBytes / (1024.0 * 1024.0), BudgetBytes / (1024.0 * 1024.0));
 	}
 }
 
-public class TextureCache {
+/**
+ * Shares textures loaded from archive files.
+ *
+ * Loads are asynchronous: Get returns immediately and the file is decoded and uploaded on a worker thread, with the
+ * caller's placeholder standing in until it completes. Mips are streamed: the first load only reads the mips that fit
+ * within the initial resolution, then a second load brings the texture up to its requested resolution. Replaced views
+ * are retired rather than disposed immediately because a frame being prepared may still be binding them.
+ *
+ * Textures that are no longer referenced stay resident so they can be picked up again cheaply, and are evicted in
+ * least-recently-released order once the resident size exceeds the byte budget. Referenced textures are never evicted;
+ * if they alone exceed the budget, the largest one's requested resolution is halved so that it drops its top mip, one
+ * texture at a time, down to the initial resolution. Once there's room again, reduced textures are raised back a mip
+ * at a time.
+ */
+public class TextureCache : IDisposable {
+	public const long DefaultBudgetBytes = 1024L * 1024 * 1024;
+	public const int DefaultWorkerCount = 2;
+	public const int DefaultInitialResolution = 256;
+
 	public class Entry {
-		private readonly TextureCache loader;
+		private readonly TextureCache cache;
 		private readonly IArchiveFile key;
-		private readonly ShaderResourceView resource;
-		private int referenceCount;
-		
-		public Entry(TextureCache loader, IArchiveFile key, ShaderResourceView resource) {
-			this.loader = loader;
+		internal readonly string memoryOwner; //loads run on worker threads, so the requester's owner is kept here
+
+		//guarded by the cache's lock, except resource which may be read at any time
+		internal volatile ShaderResourceView resource;
+		internal DdsDescription description;
+		internal int residentFirstMip;
+		internal int requestedResolution; //0 for full resolution
+		internal long byteCount;
+		internal bool isLoading;
+		internal int referenceCount;
+		internal LinkedListNode<Entry> unreferencedNode;
+
+		public Entry(TextureCache cache, IArchiveFile key) {
+			this.cache = cache;
 			this.key = key;
-			this.resource = resource;
+			memoryOwner = MemoryAccounting.CurrentOwner;
+			resource = null;
+			description = null;
+			residentFirstMip = -1;
+			requestedResolution = 0;
+			isLoading = false;
 			referenceCount = 0;
 		}
 
+		public IArchiveFile Key => key;
 		public ShaderResourceView Resource => resource;
 
 		public void AddRef() {
-			referenceCount += 1;
+			lock (cache) {
+				referenceCount += 1;
+				if (unreferencedNode != null) {
+					cache.unreferencedEntries.Remove(unreferencedNode);
+					unreferencedNode = null;
+				}
+				cache.ScheduleLoadIfNeeded(this);
+			}
 		}
 
 		public void Release() {
-			lock (loader) {
+			lock (cache) {
 				referenceCount -= 1;
 				if (referenceCount == 0) {
-					resource.Dispose();
-					loader.RemoveEntry(key);
+					cache.OnUnreferenced(this);
 				}
 			}
 		}
+
+		/**
+		 * The max size for the next load (0 for full resolution): small for the first load so that something shows up
+		 * quickly, then whatever has been requested.
+		 */
+		internal int NextLoadSize(int initialResolution) {
+			if (resource != null) {
+				return requestedResolution;
+			}
+			if (requestedResolution == 0) {
+				return initialResolution;
+			}
+			return Math.Min(requestedResolution, initialResolution);
+		}
+
+		internal bool NeedsLoad() {
+			if (resource == null) {
+				return true;
+			}
+			return description.GetFirstMipWithin(requestedResolution) != residentFirstMip;
+		}
 	}
-	
+
 	private readonly Device device;
+	private readonly long budgetBytes;
+	private readonly int initialResolution;
 	private readonly Dictionary<IArchiveFile, Entry> dict = new Dictionary<IArchiveFile, Entry>();
-	
-	public TextureCache(Device device) {
+	private readonly LinkedList<Entry> unreferencedEntries = new LinkedList<Entry>(); //least recently released first
+	private readonly BlockingCollection<Entry> loadQueue = new BlockingCollection<Entry>();
+	private readonly Thread[] workers;
+
+	private List<ShaderResourceView> retiredResources = new List<ShaderResourceView>();
+	private List<ShaderResourceView> retiringResources = new List<ShaderResourceView>();
+
+	private bool disposed = false;
+	private long residentBytes = 0;
+	private int residentCount = 0;
+	private int pendingLoads = 0;
+	private int hits = 0;
+	private int misses = 0;
+	private int evictions = 0;
+	private int failedLoads = 0;
+	private int streamedLoads = 0;
+
+	public TextureCache(Device device, long budgetBytes = DefaultBudgetBytes, int workerCount = DefaultWorkerCount, int initialResolution = DefaultInitialResolution) {
 		this.device = device;
+		this.budgetBytes = budgetBytes;
+		this.initialResolution = initialResolution;
+
+		workers = new Thread[workerCount];
+		for (int i = 0; i < workerCount; ++i) {
+			workers[i] = new Thread(RunWorker) {
+				Name = "TextureCache worker " + i,
+				IsBackground = true
+			};
+			workers[i].Start();
+		}
+	}
+
+	public void Dispose() {
+		lock (this) {
+			disposed = true;
+		}
+
+		loadQueue.CompleteAdding();
+		foreach (var worker in workers) {
+			worker.Join();
+		}
+		loadQueue.Dispose();
+
+		lock (this) {
+			foreach (var entry in dict.Values) {
+				entry.resource?.Dispose();
+				entry.resource = null;
+			}
+			dict.Clear();
+			unreferencedEntries.Clear();
+			DisposeAll(retiringResources);
+			DisposeAll(retiredResources);
+		}
 	}
 
-	public SharedTexture Get(IArchiveFile file) {
+	private static void DisposeAll(List<ShaderResourceView> resources) {
+		foreach (var resource in resources) {
+			resource.Dispose();
+		}
+		resources.Clear();
+	}
+
+	public TextureCacheStatistics Statistics {
+		get {
+			lock (this) {
+				return new TextureCacheStatistics(hits, misses, evictions, failedLoads, streamedLoads, pendingLoads, residentCount, residentBytes, budgetBytes);
+			}
+		}
+	}
+
+	/**
+	 * Disposes views that were replaced before the previous call. Call once per frame from the render thread, so that
+	 * any frame which could have bound a replaced view has been submitted by the time it is disposed.
+	 */
+	public void CollectRetiredResources() {
 		lock (this) {
-			if (!dict.TryGetValue(file, out var cacheEntry)) {
-				cacheEntry = AddEntry(file);
+			DisposeAll(retiringResources);
+			var swap = retiringResources;
+			retiringResources = retiredResources;
+			retiredResources = swap;
+		}
+	}
+
+	public SharedTexture Get(IArchiveFile file, ShaderResourceView placeholder) {
+		lock (this) {
+			if (dict.TryGetValue(file, out var cacheEntry)) {
+				hits += 1;
+			} else {
+				misses += 1;
+				cacheEntry = new Entry(this, file);
+				dict.Add(file, cacheEntry);
+			}
+			return new SharedTexture(cacheEntry, placeholder);
+		}
+	}
+
+	private void ScheduleLoadIfNeeded(Entry entry) {
+		if (disposed || entry.isLoading || entry.referenceCount == 0 || !entry.NeedsLoad()) {
+			return;
+		}
+
+		entry.isLoading = true;
+		pendingLoads += 1;
+		loadQueue.Add(entry);
+	}
+
+	private void RunWorker() {
+		foreach (var entry in loadQueue.GetConsumingEnumerable()) {
+			int maxSize;
+			lock (this) {
+				maxSize = entry.NextLoadSize(initialResolution);
+			}
+
+			ShaderResourceView resource = null;
+			DdsImage image = null;
+			try {
+				resource = Load(entry.Key, maxSize, out image);
+			} catch (Exception e) {
+				Console.WriteLine($"failed to load texture {entry.Key.Name}: {e.Message}");
+			}
+
+			lock (this) {
+				CompleteLoad(entry, resource, image);
 			}
-			return new SharedTexture(cacheEntry);
 		}
 	}
 
-	private ShaderResourceView Load(IArchiveFile file) {
+	private ShaderResourceView Load(IArchiveFile file, int maxSize, out DdsImage image) {
 		using (var dataView = file.OpenDataView()) {
-			DdsLoader.CreateDDSTextureFromMemory(device, dataView.DataPointer, out var texture, out var textureView);
+			//only the mips within maxSize are touched, so with a mapped view the larger ones are never paged in
+			image = DdsLoader.Decode(dataView.DataPointer, maxSize);
+			DdsLoader.CreateTexture(device, image, out var texture, out var textureView);
 			texture.Dispose();
 			return textureView;
 		}
 	}
 
-	private Entry AddEntry(IArchiveFile key) {
-		//Console.WriteLine($"loading {key.Name}");
-		ShaderResourceView resource = Load(key);
-		var entry = new Entry(this, key, resource);
-		dict.Add(key, entry);
-		return entry;
+	private void CompleteLoad(Entry entry, ShaderResourceView resource, DdsImage image) {
+		pendingLoads -= 1;
+		entry.isLoading = false;
+
+		if (disposed) {
+			resource?.Dispose();
+			return;
+		}
+
+		if (resource == null) {
+			failedLoads += 1;
+			if (entry.resource == null && entry.referenceCount == 0) {
+				//forget the failure so the next request retries
+				dict.Remove(entry.Key);
+			}
+			return;
+		}
+
+		if (entry.resource != null) {
+			streamedLoads += 1;
+			retiredResources.Add(entry.resource);
+			residentBytes -= entry.byteCount;
+		} else {
+			residentCount += 1;
+		}
+
+		MemoryAccounting.TrackUntilDisposed(MemoryAccounting.Textures, resource, image.ByteCount, entry.memoryOwner);
+		entry.resource = resource;
+		entry.description = image.Description;
+		entry.residentFirstMip = image.FirstMip;
+		entry.byteCount = image.ByteCount;
+		residentBytes += image.ByteCount;
+
+		if (entry.referenceCount == 0) {
+			entry.unreferencedNode = unreferencedEntries.AddLast(entry);
+		} else {
+			ScheduleLoadIfNeeded(entry);
+		}
+		Trim();
+	}
+
+	private void OnUnreferenced(Entry entry) {
+		if (disposed) {
+			return;
+		}
+
+		if (entry.isLoading) {
+			//CompleteLoad will make it evictable
+			return;
+		}
+
+		if (entry.resource == null) {
+			dict.Remove(entry.Key);
+			return;
+		}
+
+		entry.unreferencedNode = unreferencedEntries.AddLast(entry);
+		Trim();
+	}
+
+	private static int GetMipSize(DdsDescription description, int mipIdx) {
+		return Math.Max(Math.Max(description.GetMipWidth(mipIdx), description.GetMipHeight(mipIdx)), description.GetMipDepth(mipIdx));
+	}
+
+	/**
+	 * Returns the requested resolution that makes a texture drop its top resident mip, or -1 if that would take it
+	 * below the initial resolution or it has no smaller mip.
+	 */
+	public static int GetReducedResolution(DdsDescription description, int residentFirstMip, int initialResolution) {
+		if (residentFirstMip + 1 >= description.MipCount) {
+			return -1;
+		}
+		int reducedResolution = GetMipSize(description, residentFirstMip + 1);
+		return reducedResolution < initialResolution ? -1 : reducedResolution;
+	}
+
+	/**
+	 * Returns the requested resolution that makes a texture load one more mip (0 once that's the full resolution).
+	 */
+	public static int GetRaisedResolution(DdsDescription description, int residentFirstMip) {
+		return residentFirstMip <= 1 ? 0 : GetMipSize(description, residentFirstMip - 1);
+	}
+
+	private void Trim() {
+		while (residentBytes > budgetBytes && unreferencedEntries.First != null) {
+			var entry = unreferencedEntries.First.Value;
+			unreferencedEntries.RemoveFirst();
+			entry.unreferencedNode = null;
+
+			//Console.WriteLine($"evicting {entry.Key.Name}");
+			dict.Remove(entry.Key);
+			entry.resource.Dispose();
+			entry.resource = null;
+			residentBytes -= entry.byteCount;
+			residentCount -= 1;
+			evictions += 1;
+		}
+
+		//only one texture is reloaded at a time; its CompleteLoad trims again
+		if (residentBytes > budgetBytes) {
+			ReduceLargestReferencedEntry();
+		} else {
+			RaiseReducedEntry();
+		}
+	}
+
+	private bool IsIdleAndReferenced(Entry entry) {
+		return entry.referenceCount != 0 && entry.resource != null && !entry.isLoading;
 	}
 
-	private void RemoveEntry(IArchiveFile key) {
-		//Console.WriteLine($"unloading {key.Name}");
-		dict.Remove(key);
+	private void ReduceLargestReferencedEntry() {
+		Entry largestEntry = null;
+		int largestEntryReducedResolution = -1;
+		foreach (var entry in dict.Values) {
+			if (!IsIdleAndReferenced(entry) || (largestEntry != null && entry.byteCount <= largestEntry.byteCount)) {
+				continue;
+			}
+			int reducedResolution = GetReducedResolution(entry.description, entry.residentFirstMip, initialResolution);
+			if (reducedResolution >= 0) {
+				largestEntry = entry;
+				largestEntryReducedResolution = reducedResolution;
+			}
+		}
+
+		if (largestEntry != null) {
+			largestEntry.requestedResolution = largestEntryReducedResolution;
+			ScheduleLoadIfNeeded(largestEntry);
+		}
+	}
+
+	private void RaiseReducedEntry() {
+		foreach (var entry in dict.Values) {
+			//the next mip up is about three times the size of all the smaller ones together
+			if (!IsIdleAndReferenced(entry) || entry.requestedResolution == 0 || residentBytes + 3 * entry.byteCount > budgetBytes) {
+				continue;
+			}
+			entry.requestedResolution = GetRaisedResolution(entry.description, entry.residentFirstMip);
+			ScheduleLoadIfNeeded(entry);
+			return;
+		}
 	}
 }
@@ -30,17 +30,19 @@ public class FigureLoader {
 	}
 
 	public FigureFacade Load(FigureFacade.Recipe recipe, FigureDefinition parentDefinition) {
-		FigureDefinition definition = FigureDefinition.Load(dataDir, recipe.name, parentDefinition);
+		using (MemoryAccounting.AttributeTo("figure:" + recipe.name)) {
+			FigureDefinition definition = FigureDefinition.Load(dataDir, recipe.name, parentDefinition);
 
-		var model = new FigureModel(definition) {
-			IsVisible = recipe.isVisible,
-			ShapeName = recipe.shape
-		};
-		model.SetMaterialSetAndVariantByName(recipe.materialSet, recipe.materialVariants);
+			var model = new FigureModel(definition) {
+				IsVisible = recipe.isVisible,
+				ShapeName = recipe.shape
+			};
+			model.SetMaterialSetAndVariantByName(recipe.materialSet, recipe.materialVariants);
 		
-		var controlVertexProvider = ControlVertexProvider.Load(device, shaderCache, definition);
+			var controlVertexProvider = ControlVertexProvider.Load(device, shaderCache, definition);
 				
-		var facade = new FigureFacade(device, shaderCache, definition, model, controlVertexProvider, shapeNormalsLoader, figureRendererLoader);
-		return facade;
+			var facade = new FigureFacade(device, shaderCache, definition, model, controlVertexProvider, shapeNormalsLoader, figureRendererLoader);
+			return facade;
+		}
 	}
 }
@@ -5,11 +5,14 @@ using System.Text;
 using System.Threading.Tasks;
 
 public class ChannelSystem {
+	private static readonly ProfilerStage EvaluationStage = FrameProfiler.RegisterStage("channel-evaluation");
+
 	private readonly ChannelSystem parent;
 	private readonly List<Channel> channels;
 
 	private readonly Dictionary<string, Channel> channelsByName;
 	private readonly ChannelEvaluator channelEvaluator;
+	private readonly MemoryAllocation allocation;
 
 	public ChannelOutputs defaultOutputs;
 
@@ -20,6 +23,28 @@ public class ChannelSystem {
 		this.channelsByName = channels.ToDictionary(channel => channel.Name, channel => channel);
 		this.channelEvaluator = new ChannelEvaluator(channels);
 		this.defaultOutputs = Evaluate(parent?.defaultOutputs, MakeDefaultChannelInputs());
+		this.allocation = MemoryAccounting.Track(MemoryAccounting.ChannelSystems, EstimateSizeInBytes(channels));
+	}
+
+	/**
+	 * Approximates the managed size of the channels, their lookup table and the default outputs. Formulas and the
+	 * generated evaluator aren't counted.
+	 */
+	private static long EstimateSizeInBytes(List<Channel> channels) {
+		const int ChannelObjectBytes = 160; //object with its fields and two empty formula lists
+		const int StringOverheadBytes = 26;
+		const int LookupEntryBytes = 24;
+		const int OutputBytes = sizeof(double);
+
+		long size = 0;
+		foreach (var channel in channels) {
+			size += ChannelObjectBytes + LookupEntryBytes + OutputBytes;
+			size += StringOverheadBytes + 2 * channel.Name.Length;
+			if (channel.Path != null) {
+				size += StringOverheadBytes + 2 * channel.Path.Length;
+			}
+		}
+		return size;
 	}
 	
 	public ChannelSystem Parent => parent;
@@ -41,6 +66,8 @@ public class ChannelSystem {
 	}
 		
 	public ChannelOutputs Evaluate(ChannelOutputs parentOutputs, ChannelInputs inputs) {
-		return channelEvaluator.Evaluate(parentOutputs, inputs);
+		using (EvaluationStage.Measure()) {
+			return channelEvaluator.Evaluate(parentOutputs, inputs);
+		}
 	}
 }
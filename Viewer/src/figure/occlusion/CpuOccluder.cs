@@ -0,0 +1,143 @@
+using System;
+using System.Collections.Generic;
+using System.Linq;
+using System.Threading.Tasks;
+
+/**
+ * A CPU implementation of DeformableOccluder, for producing occlusion without a device. The unmorphed occlusion, child
+ * figures' contributions and the occlusion deltas of the current channel values are combined as the Occluder compute
+ * shader combines them, into the same packed per-vertex buffer. Vertices are processed in parallel.
+ */
+public class CpuOccluder {
+	private readonly OcclusionInfo[] unmorphedOcclusionInfos;
+	private readonly uint[] packedUnmorphedWithoutChildrenOcclusionInfos;
+	private uint[] packedUnmorphedWithChildrenOcclusionInfos;
+
+	private readonly OccluderParameters parameters;
+	private readonly int[] channelIndices;
+	private readonly float[] channelWeights;
+
+	private readonly ParallelOptions parallelOptions;
+
+	public CpuOccluder(ChannelSystem channelSystem, OcclusionInfo[] unmorphedOcclusionInfos, OccluderParameters parameters, int maxDegreeOfParallelism = -1) {
+		this.unmorphedOcclusionInfos = unmorphedOcclusionInfos;
+		packedUnmorphedWithoutChildrenOcclusionInfos = OcclusionInfo.PackArray(unmorphedOcclusionInfos);
+		packedUnmorphedWithChildrenOcclusionInfos = packedUnmorphedWithoutChildrenOcclusionInfos;
+
+		this.parameters = parameters;
+		if (parameters != null) {
+			if (parameters.BaseOcclusion.Length != unmorphedOcclusionInfos.Length) {
+				throw new ArgumentException("vertex count mismatch");
+			}
+			channelIndices = parameters.ChannelNames
+				.Select(channelName => channelSystem.ChannelsByName[channelName].Index)
+				.ToArray();
+			channelWeights = new float[channelIndices.Length];
+		}
+
+		parallelOptions = new ParallelOptions { MaxDegreeOfParallelism = maxDegreeOfParallelism };
+	}
+
+	public int VertexCount => unmorphedOcclusionInfos.Length;
+
+	public void SetChildOcclusionContributions(List<OcclusionInfo[]> childOcclusionContributions) {
+		OcclusionInfo[] results = OcclusionInfoBlender.BlendChildContributions(unmorphedOcclusionInfos, childOcclusionContributions);
+		packedUnmorphedWithChildrenOcclusionInfos = OcclusionInfo.PackArray(results);
+	}
+
+	/**
+	 * Calculates the packed occlusion of every vertex for the channel outputs, matching the contents of
+	 * DeformableOccluder.OcclusionInfosView.
+	 */
+	public uint[] CalculateOcclusion(ChannelOutputs channelOutputs) {
+		if (parameters == null) {
+			return (uint[]) packedUnmorphedWithChildrenOcclusionInfos.Clone();
+		}
+
+		for (int i = 0; i < channelIndices.Length; ++i) {
+			channelWeights[i] = (float) channelOutputs.Values[channelIndices[i]];
+		}
+
+		var segments = parameters.Deltas.Segments;
+		var elems = parameters.Deltas.Elems;
+
+		var packedOcclusionInfos = new uint[VertexCount];
+		Parallel.For(0, VertexCount, parallelOptions, vertexIdx => {
+			var withoutChildrenOcclusion = OcclusionInfo.Unpack(packedUnmorphedWithoutChildrenOcclusionInfos[vertexIdx]);
+			var withChildrenOcclusion = OcclusionInfo.Unpack(packedUnmorphedWithChildrenOcclusionInfos[vertexIdx]);
+			var baseOcclusion = OcclusionInfo.Unpack(parameters.BaseOcclusion[vertexIdx]);
+			var segment = segments[vertexIdx];
+
+			packedOcclusionInfos[vertexIdx] = OcclusionInfo.Pack(CombineOcclusion(
+				withoutChildrenOcclusion, withChildrenOcclusion, baseOcclusion,
+				elems, segment));
+		});
+		return packedOcclusionInfos;
+	}
+
+	//the compute shader's main: front and back are accumulated together, as the shader does with float2s
+	private OcclusionInfo CombineOcclusion(OcclusionInfo withoutChildrenOcclusion, OcclusionInfo withChildrenOcclusion, OcclusionInfo baseOcclusion,
+		OcclusionDelta[] deltas, ArraySegment segment) {
+		float baseFrontRevealage = 1 - baseOcclusion.Front;
+		float baseBackRevealage = 1 - baseOcclusion.Back;
+
+		float frontOcclusionProduct = withChildrenOcclusion.Front / withoutChildrenOcclusion.Front;
+		float backOcclusionProduct = withChildrenOcclusion.Back / withoutChildrenOcclusion.Back;
+		float frontRevealageProduct = (1 - withChildrenOcclusion.Front) / (1 - withoutChildrenOcclusion.Front);
+		float backRevealageProduct = (1 - withChildrenOcclusion.Back) / (1 - withoutChildrenOcclusion.Back);
+
+		for (int i = segment.Offset; i < segment.Offset + segment.Count; ++i) {
+			OcclusionDelta delta = deltas[i];
+			float weight = channelWeights[delta.ChannelIdx];
+
+			OcclusionInfo morphOcclusion = OcclusionInfo.Unpack(delta.PackedOcclusionInfo);
+			float weightedMorphFrontOcclusion = Lerp(baseOcclusion.Front, morphOcclusion.Front, weight);
+			float weightedMorphBackOcclusion = Lerp(baseOcclusion.Back, morphOcclusion.Back, weight);
+
+			frontOcclusionProduct *= weightedMorphFrontOcclusion / baseOcclusion.Front;
+			backOcclusionProduct *= weightedMorphBackOcclusion / baseOcclusion.Back;
+			frontRevealageProduct *= (1 - weightedMorphFrontOcclusion) / baseFrontRevealage;
+			backRevealageProduct *= (1 - weightedMorphBackOcclusion) / baseBackRevealage;
+		}
+
+		float combinedFrontRevealage = SolveRevealage(baseFrontRevealage, baseOcclusion.Front, frontRevealageProduct, frontOcclusionProduct);
+		float combinedBackRevealage = SolveRevealage(baseBackRevealage, baseOcclusion.Back, backRevealageProduct, backOcclusionProduct);
+		return new OcclusionInfo(1 - combinedFrontRevealage, 1 - combinedBackRevealage);
+	}
+
+	private static float Lerp(float x, float y, float s) {
+		return x + s * (y - x);
+	}
+
+	private static float Log(float x) {
+		return (float) Math.Log(x);
+	}
+
+	private static float Log1p(float x) {
+		return Log(1 + x);
+	}
+
+	private static float Exp(float x) {
+		return (float) Math.Exp(x);
+	}
+
+	private static float NewtonStep(float x, float alpha, float z) {
+		float expx = Exp(x);
+		float numer1 = 1 + expx;
+		float numer2 = z + Lerp(-Log1p(expx), Log1p(1 / expx), alpha);
+		float denom = expx * (1 - alpha) + alpha;
+		return x + numer1 * numer2 / denom;
+	}
+
+	private static float SolveRevealage(float baseRevealage, float baseOcclusion, float revealageProduct, float occlusionProduct) {
+		float alpha = Log(baseOcclusion) / (Log(baseOcclusion) + Log(baseRevealage));
+		float z = Lerp(-Log(occlusionProduct), Log(revealageProduct), alpha);
+
+		float x = 0;
+		x = NewtonStep(x, alpha, z);
+		x = NewtonStep(x, alpha, z);
+		x = NewtonStep(x, alpha, z);
+
+		return 1 / (1 + Exp(-x));
+	}
+}
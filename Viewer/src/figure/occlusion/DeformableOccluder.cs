@@ -57,27 +57,7 @@ public class DeformableOccluder : IOccluder {
 	}
 
 	private void IncorporateChildOcclusionContributions(List<OcclusionInfo[]> childOcclusionContributions) {
-		int count = unmorphedOcclusionInfos.Length;
-		OcclusionInfoBlender[] blenders = new OcclusionInfoBlender[count];
-		for (int i = 0; i < count; ++i) {
-			blenders[i].Init(unmorphedOcclusionInfos[i]);
-		}
-		
-		foreach (OcclusionInfo[] childOcclusionContribution in childOcclusionContributions) {
-			if (childOcclusionContribution.Length != count) {
-				throw new InvalidOperationException("parent-child occlusion info length mismatch");
-			}
-
-			for (int i = 0; i < count; ++i) {
-				blenders[i].Add(childOcclusionContribution[i], unmorphedOcclusionInfos[i]);
-			}
-		}
-		
-		OcclusionInfo[] results = new OcclusionInfo[count];
-		for (int i = 0; i < count; ++i) {
-			results[i] = blenders[i].GetResult();
-		}
-		
+		OcclusionInfo[] results = OcclusionInfoBlender.BlendChildContributions(unmorphedOcclusionInfos, childOcclusionContributions);
 		unmorphedWithChildrenOcclusionInfosToUpload = OcclusionInfo.PackArray(results);
 	}
 
@@ -8,6 +8,8 @@ using System.Linq;
 public class ControlVertexProvider : IDisposable {
 	public static readonly int ControlVertex_SizeInBytes = Vector3.SizeInBytes + OcclusionInfo.PackedSizeInBytes;
 
+	private static readonly ProfilerStage ReadbackStage = FrameProfiler.RegisterStage("control-vertex-readback");
+
 	public static ControlVertexProvider Load(Device device, ShaderCache shaderCache, FigureDefinition definition) {
 		var shaperParameters = Persistance.Load<ShaperParameters>(definition.Directory.File("shaper-parameters.dat"));
 		
@@ -24,6 +26,7 @@ public class ControlVertexProvider : IDisposable {
 	private readonly OccluderLoader occluderLoader;
 	private readonly FigureDefinition definition;
 	private readonly GpuShaper shaper;
+	private readonly BoneTransformCache boneTransformCache;
 	private readonly int vertexCount;
 
 	private IArchiveDirectory occlusionDirectory;
@@ -42,6 +45,7 @@ public class ControlVertexProvider : IDisposable {
 		this.occluderLoader = occluderLoader;
 		this.definition = definition;
 		this.shaper = new GpuShaper(device, shaderCache, definition, shaperParameters);
+		this.boneTransformCache = new BoneTransformCache(definition.BoneSystem);
 		this.vertexCount = shaperParameters.InitialPositions.Length;
 		
 		controlVertexInfosBufferManager = new InOutStructuredBufferManager<ControlVertexInfo>(device, vertexCount);
@@ -99,7 +103,7 @@ public class ControlVertexProvider : IDisposable {
 
 		StagedSkinningTransform[] boneTransforms;
 		if (parentOutputs == null) {
-			boneTransforms = definition.BoneSystem.GetBoneTransforms(channelOutputs);
+			boneTransforms = boneTransformCache.GetBoneTransforms(channelOutputs);
 		} else {
 			boneTransforms = (StagedSkinningTransform[]) parentOutputs.BoneTransforms.Clone();
 			BoneSystem.PrependChildToParentBindPoseTransforms(definition.ChildToParentBindPoseTransforms, boneTransforms);
@@ -134,7 +138,9 @@ public class ControlVertexProvider : IDisposable {
 
 	public void ReadbackPosedControlVertices(DeviceContext context) {
 		if (controlVertexInfoStagingBufferManager != null) {
-			previousFramePosedVertices = controlVertexInfoStagingBufferManager.FillArrayFromStagingBuffer(context);
+			using (ReadbackStage.Measure()) {
+				previousFramePosedVertices = controlVertexInfoStagingBufferManager.FillArrayFromStagingBuffer(context);
+			}
 		}
 	}
 
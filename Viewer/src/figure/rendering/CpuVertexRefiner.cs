@@ -0,0 +1,75 @@
+using SharpDX;
+using System;
+using System.Threading.Tasks;
+
+/**
+ * A CPU implementation of VertexRefiner. Refined vertices are produced in the same layout as the GPU's stream-out
+ * buffer, from the same control vertex infos and scattered illuminations. Vertices are refined in parallel.
+ */
+public class CpuVertexRefiner {
+	private readonly PackedLists<WeightedIndexWithDerivatives> stencils;
+	private readonly int[] texturedToSpatialIdxMap;
+	private readonly ParallelOptions parallelOptions;
+
+	public CpuVertexRefiner(SubdivisionMesh mesh, int[] texturedToSpatialIdxMap, int maxDegreeOfParallelism = -1) {
+		this.stencils = mesh.Stencils;
+		this.texturedToSpatialIdxMap = texturedToSpatialIdxMap;
+		parallelOptions = new ParallelOptions { MaxDegreeOfParallelism = maxDegreeOfParallelism };
+	}
+
+	public int RefinedVertexCount => texturedToSpatialIdxMap.Length;
+
+	public RefinedVertex[] RefineVertices(ControlVertexInfo[] controlVertexInfos, Vector3[] controlScatteredIlluminations) {
+		var refinedVertices = new RefinedVertex[RefinedVertexCount];
+		RefineVertices(controlVertexInfos, controlScatteredIlluminations, refinedVertices);
+		return refinedVertices;
+	}
+
+	/**
+	 * Refines into a caller-owned array so that per-frame refinement doesn't allocate. The scattered illuminations may be
+	 * null, in which case they're taken to be zero.
+	 */
+	public void RefineVertices(ControlVertexInfo[] controlVertexInfos, Vector3[] controlScatteredIlluminations, RefinedVertex[] refinedVertices) {
+		if (refinedVertices.Length != RefinedVertexCount) {
+			throw new ArgumentException("vertex count mismatch");
+		}
+
+		var segments = stencils.Segments;
+		var elems = stencils.Elems;
+
+		Parallel.For(0, RefinedVertexCount, parallelOptions, vertexIdx => {
+			int spatialVertexIdx = texturedToSpatialIdxMap[vertexIdx];
+
+			Vector3 position = Vector3.Zero;
+			Vector3 positionDs = Vector3.Zero;
+			Vector3 positionDt = Vector3.Zero;
+			Vector2 fourthRootOcclusion = Vector2.Zero;
+			Vector3 scatteredIllumination = Vector3.Zero;
+
+			var segment = segments[spatialVertexIdx];
+			for (int i = segment.Offset; i < segment.Offset + segment.Count; ++i) {
+				var stencil = elems[i];
+				ControlVertexInfo controlVertexInfo = controlVertexInfos[stencil.Index];
+
+				position += stencil.Weight * controlVertexInfo.position;
+				positionDs += stencil.DuWeight * controlVertexInfo.position;
+				positionDt += stencil.DvWeight * controlVertexInfo.position;
+				fourthRootOcclusion += stencil.Weight * controlVertexInfo.UnpackFourthRootOcclusion();
+				if (controlScatteredIlluminations != null) {
+					scatteredIllumination += stencil.Weight * controlScatteredIlluminations[stencil.Index];
+				}
+			}
+
+			Vector2 squareRootOcclusion = fourthRootOcclusion * fourthRootOcclusion;
+			Vector2 occlusion = squareRootOcclusion * squareRootOcclusion;
+
+			refinedVertices[vertexIdx] = new RefinedVertex {
+				position = position,
+				positionDs = positionDs,
+				positionDt = positionDt,
+				occlusion = occlusion,
+				scatteredIllumination = scatteredIllumination
+			};
+		});
+	}
+}
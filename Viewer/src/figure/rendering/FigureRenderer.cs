@@ -88,7 +88,7 @@ public class FigureRenderer : IDisposable {
 				RenderingLayer.UnorderedTransparent :
 				(isOneSided ? RenderingLayer.OneSidedBackToFrontTransparent : RenderingLayer.TwoSidedBackToFrontTransparent);
 
-			ShaderResourceView secondaryNormalMap = shapeNormals?.NormalsMapsBySurface[surfaceIdx];
+			ShaderResourceView secondaryNormalMap = shapeNormals?.NormalsMapsBySurface[surfaceIdx].View;
 
 			if (pass.Layer == opaqueLayer) {
 				material.Apply(context, pass.OutputMode, secondaryNormalMap);
@@ -0,0 +1,17 @@
+using SharpDX;
+using System.Runtime.InteropServices;
+
+/**
+ * A vertex as VertexRefiner streams it out; see RefinedVertex.hlsl.
+ */
+[StructLayout(LayoutKind.Sequential)]
+public struct RefinedVertex {
+	public static readonly int SizeInBytes = Marshal.SizeOf<RefinedVertex>();
+
+	public Vector3 position;
+	public Vector3 positionDs;
+	public Vector3 positionDt;
+
+	public Vector2 occlusion;
+	public Vector3 scatteredIllumination;
+}
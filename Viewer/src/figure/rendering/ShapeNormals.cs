@@ -52,9 +52,9 @@ public class ShapeNormalsRecipe {
 public class ShapeNormals : IDisposable {
 	private readonly TextureLoader textureLoader;
 	public TexturedVertexInfo[] TexturedVertexInfos { get; }
-	public ShaderResourceView[] NormalsMapsBySurface { get; }
+	public SharedTexture[] NormalsMapsBySurface { get; }
 
-	public ShapeNormals(TextureLoader textureLoader, TexturedVertexInfo[] texturedVertexInfos, ShaderResourceView[] normalsMapsBySurface) {
+	public ShapeNormals(TextureLoader textureLoader, TexturedVertexInfo[] texturedVertexInfos, SharedTexture[] normalsMapsBySurface) {
 		this.textureLoader = textureLoader;
 		TexturedVertexInfos = texturedVertexInfos;
 		NormalsMapsBySurface = normalsMapsBySurface;
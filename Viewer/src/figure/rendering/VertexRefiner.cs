@@ -22,7 +22,7 @@ public class VertexRefiner : IDisposable {
 		new InputElement("COLOR", 0, Format.R32G32_Float, 9 * 4, 0),
 		new InputElement("COLOR", 1, Format.R32G32B32_Float, 11 * 4, 0),
     };
-	private static readonly int StreamStride = 14 * 4;
+	private static readonly int StreamStride = RefinedVertex.SizeInBytes;
 		
 	private readonly int refinedVertexCount;
 	
@@ -41,8 +41,8 @@ public class VertexRefiner : IDisposable {
 		this.vertexRefinerGeometryShader = new GeometryShader(device, vertexRefinerShaderAndBytecode.Bytecode, StreamOutputElements, new int[] { StreamStride }, GeometryShader.StreamOutputNoRasterizedStream);
 
 		this.shaderResources = new ShaderResourceView[] {
-			BufferUtilities.ToStructuredBufferView(device, mesh.Stencils.Segments),
-			BufferUtilities.ToStructuredBufferView(device, mesh.Stencils.Elems),
+			BufferUtilities.ToStructuredBufferView(device, mesh.Stencils.Segments, MemoryAccounting.Stencils),
+			BufferUtilities.ToStructuredBufferView(device, mesh.Stencils.Elems, MemoryAccounting.Stencils),
 			BufferUtilities.ToStructuredBufferView(device, texturedToSpatialIdxMap)
 		};
 
@@ -34,8 +34,8 @@ public class Scatterer : IDisposable {
 
 	public Scatterer(Device device, ShaderCache shaderCache, SubdivisionMesh mesh, PackedLists<Vector3WeightedIndex> formFactors) {
 		vertexCount = mesh.Stencils.Count;
-		stencilSegments = BufferUtilities.ToStructuredBufferView(device, mesh.Stencils.Segments);
-		stencilElems = BufferUtilities.ToStructuredBufferView(device, mesh.Stencils.Elems);
+		stencilSegments = BufferUtilities.ToStructuredBufferView(device, mesh.Stencils.Segments, MemoryAccounting.Stencils);
+		stencilElems = BufferUtilities.ToStructuredBufferView(device, mesh.Stencils.Elems, MemoryAccounting.Stencils);
 		formFactorSegments = BufferUtilities.ToStructuredBufferView(device, formFactors.Segments);
 		formFactorElements = BufferUtilities.ToStructuredBufferView(device, formFactors.Elems);
 		
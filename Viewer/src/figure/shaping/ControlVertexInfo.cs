@@ -1,8 +1,33 @@
 using SharpDX;
+using System;
 using System.Runtime.InteropServices;
 
 [StructLayout(LayoutKind.Sequential)]
 public struct ControlVertexInfo {
 	public Vector3 position;
 	public int packedOcclusionInfo;
+
+	private static float FourthRoot(float f) {
+		float squareRoot = (float) Math.Sqrt(f);
+		return (float) Math.Sqrt(squareRoot);
+	}
+
+	/**
+	 * Makes a control vertex as the shaper does for a vertex without an occlusion surrogate: the occluder's packed
+	 * occlusion is stored as the fourth roots of the front and back occlusion, as a pair of half floats.
+	 */
+	public static ControlVertexInfo Make(Vector3 position, uint packedOcclusion) {
+		OcclusionInfo occlusion = OcclusionInfo.Unpack(packedOcclusion);
+		return new ControlVertexInfo {
+			position = position,
+			packedOcclusionInfo = (int) IntegerUtils.Pack(
+				IntegerUtils.ToHalf(FourthRoot(occlusion.Front)),
+				IntegerUtils.ToHalf(FourthRoot(occlusion.Back)))
+		};
+	}
+
+	public Vector2 UnpackFourthRootOcclusion() {
+		IntegerUtils.Unpack((uint) packedOcclusionInfo, out ushort front, out ushort back);
+		return new Vector2(IntegerUtils.FromHalf(front), IntegerUtils.FromHalf(back));
+	}
 }
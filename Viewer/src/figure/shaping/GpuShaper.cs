@@ -7,6 +7,8 @@ using System.Linq;
 public class GpuShaper : IDisposable {
 	private const int ShaderNumThreads = 64;
 
+	private static readonly ProfilerStage UploadStage = FrameProfiler.RegisterStage("shaper-upload");
+
 	private readonly Device device;
 	private readonly ComputeShader withDeltasShader;
 	private readonly ComputeShader withoutDeltasShader;
@@ -79,23 +81,25 @@ public class GpuShaper : IDisposable {
 	}
 
 	public void SetValues(DeviceContext context, ChannelOutputs channelOutputs, StagedSkinningTransform[] allBoneTransforms) {
-		float[] morphWeights = morphChannelIndices
-			.Select(idx => (float) channelOutputs.Values[idx])
-			.ToArray();
-
-		StagedSkinningTransform[] boneTransforms = boneIndices
-			.Select(idx => allBoneTransforms[idx])
-			.ToArray();
-
-		OcclusionSurrogate.Info[] occlusionSurrogateInfos = occlusionSurrogates
-			.Select(surrogate => surrogate.GetInfo(channelOutputs))
-			.ToArray();
+		using (UploadStage.Measure()) {
+			float[] morphWeights = morphChannelIndices
+				.Select(idx => (float) channelOutputs.Values[idx])
+				.ToArray();
+
+			StagedSkinningTransform[] boneTransforms = boneIndices
+				.Select(idx => allBoneTransforms[idx])
+				.ToArray();
+
+			OcclusionSurrogate.Info[] occlusionSurrogateInfos = occlusionSurrogates
+				.Select(surrogate => surrogate.GetInfo(channelOutputs))
+				.ToArray();
 		
-		context.WithEvent("GpuShader::SetValues", () => {
-			morphWeightsBufferManager.Update(context, morphWeights);
-			boneTransformsBufferManager.Update(context, boneTransforms);
-			occlusionSurrogateInfosBufferManager.Update(context, occlusionSurrogateInfos);
-		});
+			context.WithEvent("GpuShader::SetValues", () => {
+				morphWeightsBufferManager.Update(context, morphWeights);
+				boneTransformsBufferManager.Update(context, boneTransforms);
+				occlusionSurrogateInfosBufferManager.Update(context, occlusionSurrogateInfos);
+			});
+		}
 	}
 	
 	private void CalculatePositionsCommon(
@@ -0,0 +1,110 @@
+using System;
+
+/**
+ * Computes a bone system's transforms incrementally. The channel outputs that each bone's transform reads are
+ * remembered from the previous call, and only bones whose outputs changed are recomputed, along with their descendants.
+ * Every other bone reuses its previous transform, so moving a hand or the face only costs those subtrees.
+ *
+ * A cache follows one stream of outputs, such as a single figure's frames; it isn't safe to share between threads.
+ */
+public class BoneTransformCache {
+	//center point, orientation, rotation, translation and scale triplets, then general scale
+	private const int ChannelsPerBone = 16;
+
+	private readonly BoneSystem boneSystem;
+	private readonly int[] channelIndices;
+	private readonly double[] previousValues;
+	private readonly bool[] areDirty;
+	private readonly StagedSkinningTransform[] transforms;
+	private bool isPopulated;
+
+	public BoneTransformCache(BoneSystem boneSystem) {
+		this.boneSystem = boneSystem;
+
+		int boneCount = boneSystem.Bones.Count;
+		channelIndices = new int[boneCount * ChannelsPerBone];
+		for (int boneIdx = 0; boneIdx < boneCount; ++boneIdx) {
+			var bone = boneSystem.Bones[boneIdx];
+			var channels = new [] {
+				bone.CenterPoint.X, bone.CenterPoint.Y, bone.CenterPoint.Z,
+				bone.Orientation.X, bone.Orientation.Y, bone.Orientation.Z,
+				bone.Rotation.X, bone.Rotation.Y, bone.Rotation.Z,
+				bone.Translation.X, bone.Translation.Y, bone.Translation.Z,
+				bone.Scale.X, bone.Scale.Y, bone.Scale.Z,
+				bone.GeneralScale
+			};
+			for (int i = 0; i < ChannelsPerBone; ++i) {
+				channelIndices[boneIdx * ChannelsPerBone + i] = channels[i].Index;
+			}
+		}
+
+		previousValues = new double[channelIndices.Length];
+		areDirty = new bool[boneCount];
+		transforms = new StagedSkinningTransform[boneCount];
+	}
+
+	//number of bones recomputed by the last call to Update
+	public int RecomputedBoneCount { get; private set; }
+
+	/**
+	 * Brings the cached transforms up to date with the outputs. The result is identical to
+	 * BoneSystem.GetBoneTransforms.
+	 */
+	public void Update(ChannelOutputs outputs) {
+		while (outputs.Parent != null) {
+			outputs = outputs.Parent;
+		}
+
+		double[] values = outputs.Values;
+		var bones = boneSystem.Bones;
+		int recomputedBoneCount = 0;
+
+		for (int boneIdx = 0; boneIdx < transforms.Length; ++boneIdx) {
+			Bone bone = bones[boneIdx];
+			Bone parent = bone.Parent;
+
+			//a bone without inherited scale also reads its parent's scale, which dirties the parent anyway
+			bool isDirty = !isPopulated || (parent != null && areDirty[parent.Index]);
+
+			int offset = boneIdx * ChannelsPerBone;
+			for (int i = offset; i < offset + ChannelsPerBone; ++i) {
+				double value = values[channelIndices[i]];
+				if (value != previousValues[i]) {
+					previousValues[i] = value;
+					isDirty = true;
+				}
+			}
+
+			areDirty[boneIdx] = isDirty;
+			if (isDirty) {
+				StagedSkinningTransform parentTransform = parent != null ? transforms[parent.Index] : StagedSkinningTransform.Identity;
+				transforms[boneIdx] = bone.GetChainedTransform(outputs, parentTransform);
+				recomputedBoneCount += 1;
+			}
+		}
+
+		isPopulated = true;
+		RecomputedBoneCount = recomputedBoneCount;
+	}
+
+	/**
+	 * Writes the transforms for the outputs into boneTransforms.
+	 */
+	public void GetBoneTransforms(ChannelOutputs outputs, StagedSkinningTransform[] boneTransforms) {
+		if (boneTransforms.Length < transforms.Length) {
+			throw new ArgumentException("array is smaller than the bone count", nameof(boneTransforms));
+		}
+
+		Update(outputs);
+		Array.Copy(transforms, boneTransforms, transforms.Length);
+	}
+
+	/**
+	 * Returns the transforms for the outputs in a new array, which the caller may keep.
+	 */
+	public StagedSkinningTransform[] GetBoneTransforms(ChannelOutputs outputs) {
+		var boneTransforms = new StagedSkinningTransform[transforms.Length];
+		GetBoneTransforms(outputs, boneTransforms);
+		return boneTransforms;
+	}
+}
@@ -1,7 +1,11 @@
 using SharpDX;
 
+/**
+ * A root translation and a rotation per bone. A pose can serve as a reusable output buffer for PoseBlender, which
+ * overwrites both in place.
+ */
 public class Pose {
-	public Vector3 RootTranslation { get; }
+	public Vector3 RootTranslation { get; internal set; }
 	public Quaternion[] BoneRotations { get; }
 
 	public Pose(Vector3 rootTranslation, Quaternion[] boneRotations) {
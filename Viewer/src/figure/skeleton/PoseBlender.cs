@@ -1,39 +1,97 @@
 using SharpDX;
 using System;
 
+/**
+ * Accumulates a weighted sum of poses. Rotations are accumulated in structure-of-arrays form so that a blender can be
+ * reset and reused every frame without allocating; with a caller-owned result pose, a whole Reset, Add, GetResult
+ * cycle doesn't allocate.
+ */
 public class PoseBlender {
-	private int boneCount;
+	private readonly int boneCount;
 	private Vector3 rootTranslationAccumulator;
-	private Quaternion[] boneRotationAccumulator = null;
-	
+	private readonly float[] accumulatorX;
+	private readonly float[] accumulatorY;
+	private readonly float[] accumulatorZ;
+	private readonly float[] accumulatorW;
+
 	public PoseBlender(int boneCount) {
 		this.boneCount = boneCount;
 		this.rootTranslationAccumulator = Vector3.Zero;
-		this.boneRotationAccumulator = new Quaternion[boneCount];
+		this.accumulatorX = new float[boneCount];
+		this.accumulatorY = new float[boneCount];
+		this.accumulatorZ = new float[boneCount];
+		this.accumulatorW = new float[boneCount];
+	}
+
+	public int BoneCount => boneCount;
+
+	public void Reset() {
+		rootTranslationAccumulator = Vector3.Zero;
+		Array.Clear(accumulatorX, 0, boneCount);
+		Array.Clear(accumulatorY, 0, boneCount);
+		Array.Clear(accumulatorZ, 0, boneCount);
+		Array.Clear(accumulatorW, 0, boneCount);
+	}
+
+	public void AddRootTranslation(float weight, Vector3 rootTranslation) {
+		rootTranslationAccumulator += weight * rootTranslation;
+	}
+
+	public void AddRotation(int boneIdx, float weight, float x, float y, float z, float w) {
+		float dot = accumulatorX[boneIdx] * x + accumulatorY[boneIdx] * y + accumulatorZ[boneIdx] * z + accumulatorW[boneIdx] * w;
+		if (dot < 0) {
+			weight = -weight;
+		}
+
+		accumulatorX[boneIdx] += weight * x;
+		accumulatorY[boneIdx] += weight * y;
+		accumulatorZ[boneIdx] += weight * z;
+		accumulatorW[boneIdx] += weight * w;
 	}
 
 	public void Add(float weight, Pose pose) {
-		if (boneRotationAccumulator.Length != boneCount) {
+		if (pose.BoneRotations.Length != boneCount) {
 			throw new ArgumentException("bone cout mismatch");
 		}
 
-		rootTranslationAccumulator += weight * pose.RootTranslation;
+		AddRootTranslation(weight, pose.RootTranslation);
 
+		var boneRotations = pose.BoneRotations;
 		for (int i = 0; i < boneCount; ++i) {
-			float boneWeight = weight;
-			if (Quaternion.Dot(boneRotationAccumulator[i], pose.BoneRotations[i]) < 0) {
-				boneWeight *= -1;
-			}
-
-			boneRotationAccumulator[i] += boneWeight * pose.BoneRotations[i];
+			AddRotation(i, weight, boneRotations[i].X, boneRotations[i].Y, boneRotations[i].Z, boneRotations[i].W);
 		}
 	}
 
-	public Pose GetResult() {
+	/**
+	 * Writes the normalized blend into an existing pose.
+	 */
+	public void GetResult(Pose result) {
+		var boneRotations = result.BoneRotations;
+		if (boneRotations.Length != boneCount) {
+			throw new ArgumentException("bone count mismatch");
+		}
+
 		for (int i = 0; i < boneCount; ++i) {
-			boneRotationAccumulator[i].Normalize();
+			float x = accumulatorX[i];
+			float y = accumulatorY[i];
+			float z = accumulatorZ[i];
+			float w = accumulatorW[i];
+			float length = (float) Math.Sqrt(x * x + y * y + z * z + w * w);
+			if (!MathUtil.IsZero(length)) {
+				float inverseLength = 1 / length;
+				boneRotations[i] = new Quaternion(x * inverseLength, y * inverseLength, z * inverseLength, w * inverseLength);
+			} else {
+				//nothing was accumulated, as with Quaternion.Normalize
+				boneRotations[i] = new Quaternion(x, y, z, w);
+			}
 		}
 
-		return new Pose(rootTranslationAccumulator, boneRotationAccumulator);
+		result.RootTranslation = rootTranslationAccumulator;
+	}
+
+	public Pose GetResult() {
+		var result = new Pose(Vector3.Zero, new Quaternion[boneCount]);
+		GetResult(result);
+		return result;
 	}
 }
@@ -1,4 +1,5 @@
 using SharpDX;
+using System;
 using System.Collections.Generic;
 using System.Linq;
 
@@ -7,6 +8,15 @@ public class RigidBoneSystem {
 	private readonly RigidBone[] bones;
 	private readonly Dictionary<string, RigidBone> bonesByName;
 
+	//Structure-of-arrays copies of what GetBoneTransforms reads from each bone, so that it's a single pass over
+	//contiguous arrays. Bones are ordered with parents before children, so the pass can chain in index order.
+	private readonly int[] parentIndices;
+	private readonly CartesianAxis[] twistAxes;
+	private readonly TwistSwingConstraint[] constraints;
+	private readonly Vector3[] centerPoints;
+	private readonly Quaternion[] orientations;
+	private readonly Quaternion[] inverseOrientations;
+
 	public RigidBoneSystem(BoneSystem source) {
 		this.source = source;
 
@@ -17,6 +27,23 @@ public class RigidBoneSystem {
 		}
 				
 		bonesByName = bones.ToDictionary(bone => bone.Source.Name, bone => bone);
+
+		parentIndices = new int[bones.Length];
+		twistAxes = new CartesianAxis[bones.Length];
+		constraints = new TwistSwingConstraint[bones.Length];
+		for (int boneIdx = 0; boneIdx < bones.Length; ++boneIdx) {
+			var bone = bones[boneIdx];
+			parentIndices[boneIdx] = bone.Parent != null ? bone.Parent.Index : -1;
+			if (parentIndices[boneIdx] >= boneIdx) {
+				throw new ArgumentException("bones must be ordered with parents before children");
+			}
+			twistAxes[boneIdx] = bone.RotationOrder.TwistAxis;
+			constraints[boneIdx] = bone.Constraint;
+		}
+
+		centerPoints = new Vector3[bones.Length];
+		orientations = new Quaternion[bones.Length];
+		inverseOrientations = new Quaternion[bones.Length];
 	}
 	
 	public RigidBone[] Bones => bones;
@@ -31,22 +58,39 @@ public class RigidBoneSystem {
 		for (int boneIdx = 0; boneIdx < bones.Length; ++boneIdx) {
 			RigidBone bone = bones[boneIdx];
 			bone.Synchronize(outputs);
+
+			centerPoints[boneIdx] = bone.CenterPoint;
+			orientations[boneIdx] = bone.OrientationSpace.Orientation;
+			inverseOrientations[boneIdx] = bone.OrientationSpace.OrientationInverse;
 		}
 	}
 
 	public RigidTransform[] GetBoneTransforms(RigidBoneSystemInputs inputs) {
 		RigidTransform[] boneTransforms = new RigidTransform[bones.Length];
+		GetBoneTransforms(inputs, boneTransforms);
+		return boneTransforms;
+	}
+
+	/**
+	 * Writes the total transform of each bone into boneTransforms without allocating. Equivalent to calling
+	 * GetChainedTransform on each bone.
+	 */
+	public void GetBoneTransforms(RigidBoneSystemInputs inputs, RigidTransform[] boneTransforms) {
+		if (boneTransforms.Length < bones.Length) {
+			throw new ArgumentException("array is smaller than the bone count", nameof(boneTransforms));
+		}
 
+		TwistSwing[] rotations = inputs.Rotations;
 		RigidTransform rootTransform = RigidTransform.FromTranslation(inputs.RootTranslation);
 
 		for (int boneIdx = 0; boneIdx < bones.Length; ++boneIdx) {
-			RigidBone bone = bones[boneIdx];
-			RigidBone parent = bone.Parent;
-			RigidTransform parentTransform = parent != null ? boneTransforms[parent.Source.Index] : rootTransform;
-			boneTransforms[boneIdx] = bone.GetChainedTransform(inputs, parentTransform);
-		}
+			int parentIdx = parentIndices[boneIdx];
+			RigidTransform parentTransform = parentIdx >= 0 ? boneTransforms[parentIdx] : rootTransform;
 
-		return boneTransforms;
+			Quaternion orientedSpaceRotation = constraints[boneIdx].Clamp(rotations[boneIdx]).AsQuaternion(twistAxes[boneIdx]);
+			Quaternion objectSpaceRotation = inverseOrientations[boneIdx].Chain(orientedSpaceRotation).Chain(orientations[boneIdx]);
+			boneTransforms[boneIdx] = RigidTransform.FromRotation(objectSpaceRotation, centerPoints[boneIdx]).Chain(parentTransform);
+		}
 	}
 	
 	public RigidBoneSystemInputs MakeZeroInputs() {
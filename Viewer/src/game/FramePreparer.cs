@@ -4,6 +4,9 @@ using System;
 using Valve.VR;
 
 public class FramePreparer : IDisposable {
+	private static readonly ProfilerStage UpdateStage = FrameProfiler.RegisterStage("update-recording");
+	private static readonly ProfilerStage DrawStage = FrameProfiler.RegisterStage("draw-recording");
+
 	private readonly StandardSamplers standardSamplers;
 
 	private readonly DeviceContext deferredContext;
@@ -37,24 +40,28 @@ public class FramePreparer : IDisposable {
 	}
 
 	private CommandList UpdateAndRecordUpdateCommandList(FrameUpdateParameters updateParameters) {
-		DeviceContext context = deferredContext;
+		using (UpdateStage.Measure()) {
+			DeviceContext context = deferredContext;
 
-		controllerManager.Update();
-		scene.Update(deferredContext, updateParameters);
-		passController.PrepareFrame(deferredContext, scene.ToneMappingSettings);
+			controllerManager.Update();
+			scene.Update(deferredContext, updateParameters);
+			passController.PrepareFrame(deferredContext, scene.ToneMappingSettings);
 
-		return context.FinishCommandList(false);
+			return context.FinishCommandList(false);
+		}
 	}
 
 	private CommandList RecordDrawCommandList() {
-		DeviceContext context = deferredContext;
+		using (DrawStage.Measure()) {
+			DeviceContext context = deferredContext;
 
-		standardSamplers.Apply(context.PixelShader);
-		context.VertexShader.SetConstantBuffer(0, viewProjectionTransformBufferManager.Buffer);
+			standardSamplers.Apply(context.PixelShader);
+			context.VertexShader.SetConstantBuffer(0, viewProjectionTransformBufferManager.Buffer);
 
-		passController.RenderAllPases(context, pass => scene.RenderPass(context, pass));
+			passController.RenderAllPases(context, pass => scene.RenderPass(context, pass));
 
-		return context.FinishCommandList(false);
+			return context.FinishCommandList(false);
+		}
 	}
 	
 	private void PrepareView(DeviceContext context, HiddenAreaMesh hiddenAreaMesh, Matrix viewTransform, Matrix projectionTransform) {
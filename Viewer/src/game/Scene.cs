@@ -4,6 +4,7 @@ using SharpDX.Direct3D11;
 using System;
 
 class Scene : IDisposable {
+	private readonly TextureCache textureCache;
 	private readonly ToneMappingSettings toneMappingSettings;
 	private readonly ImageBasedLightingEnvironment iblEnvironment;
 	private readonly Backdrop backdrop;
@@ -14,7 +15,7 @@ class Scene : IDisposable {
 	private readonly Menu menu;
 
 	public Scene(IArchiveDirectory dataDir, Device device, ShaderCache shaderCache, StandardSamplers standardSamplers, TrackedDeviceBufferManager trackedDeviceBufferManager, ControllerManager controllerManager) {
-		var textureCache = new TextureCache(device);
+		textureCache = new TextureCache(device);
 
 		toneMappingSettings = new ToneMappingSettings();
 		iblEnvironment = new ImageBasedLightingEnvironment(device, standardSamplers, dataDir, InitialSettings.Environment, InitialSettings.EnvironmentRotation);
@@ -53,6 +54,7 @@ class Scene : IDisposable {
 		primitiveRenderer.Dispose();
 		actor.Dispose();
 		menu.Dispose();
+		textureCache.Dispose();
 	}
 
 	public ToneMappingSettings ToneMappingSettings => toneMappingSettings;
@@ -81,6 +83,7 @@ class Scene : IDisposable {
 	}
 		
 	public void DoPrework(DeviceContext context) {
+		textureCache.CollectRetiredResources();
 		menu.DoPrework(context);
 	}
 
@@ -25,4 +25,31 @@ public struct OcclusionInfoBlender {
 	public OcclusionInfo GetResult() {
 		return new OcclusionInfo(1 - frontRevealage, 1 - backRevealage);
 	}
+
+	/**
+	 * Blends child figures' occlusion contributions into a parent's occlusion.
+	 */
+	public static OcclusionInfo[] BlendChildContributions(OcclusionInfo[] baseOcclusionInfos, List<OcclusionInfo[]> childOcclusionContributions) {
+		int count = baseOcclusionInfos.Length;
+		OcclusionInfoBlender[] blenders = new OcclusionInfoBlender[count];
+		for (int i = 0; i < count; ++i) {
+			blenders[i].Init(baseOcclusionInfos[i]);
+		}
+		
+		foreach (OcclusionInfo[] childOcclusionContribution in childOcclusionContributions) {
+			if (childOcclusionContribution.Length != count) {
+				throw new InvalidOperationException("parent-child occlusion info length mismatch");
+			}
+
+			for (int i = 0; i < count; ++i) {
+				blenders[i].Add(childOcclusionContribution[i], baseOcclusionInfos[i]);
+			}
+		}
+		
+		OcclusionInfo[] results = new OcclusionInfo[count];
+		for (int i = 0; i < count; ++i) {
+			results[i] = blenders[i].GetResult();
+		}
+		return results;
+	}
 }
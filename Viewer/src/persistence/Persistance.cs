@@ -1,9 +1,15 @@
+using ProtoBuf;
 using ProtoBuf.Meta;
 using SharpDX;
 using System;
 using System.IO;
 
 public static class Persistance {
+	//Files whose arrays are stored as raw blocks after the message start with this header: the magic number, a reserved
+	//int and the message length. A protobuf message can't start with a zero byte, so older files are told apart by it.
+	private const uint BlockFileMagic = 0x57415200; //"\0RAW"
+	private const int BlockFileHeaderSize = sizeof(uint) + sizeof(int) + sizeof(long);
+
 	private static RuntimeTypeModel typeModel;
 
 	static Persistance() {
@@ -18,10 +24,37 @@ public static class Persistance {
 		typeModel.Serialize(stream, t);
 	}
 
+	/**
+	 * Writes the message, followed by raw blocks holding its arrays if it has any.
+	 */
+	public static void WriteWithBlocks<T>(Stream stream, T t) {
+		var blocks = RawArrayBlocks.MakeForWriting();
+		var messageStream = new MemoryStream();
+		typeModel.Serialize(messageStream, t, new SerializationContext { Context = blocks });
+
+		if (blocks.Size == 0) {
+			messageStream.WriteTo(stream);
+			return;
+		}
+
+		long messageLength = messageStream.Length;
+		long blocksOffset = IntegerUtils.NextLargerMultiple(BlockFileHeaderSize + messageLength, RawArrayBlocks.Alignment);
+
+		var writer = new BinaryWriter(stream);
+		writer.Write(BlockFileMagic);
+		writer.Write(0);
+		writer.Write(messageLength);
+		writer.Flush();
+		messageStream.WriteTo(stream);
+		int padding = (int) (blocksOffset - BlockFileHeaderSize - messageLength);
+		stream.Write(new byte[padding], 0, padding);
+		blocks.WriteTo(stream);
+	}
+
 	public static void Save<T>(FileInfo file, T t) {
 		try {
 			using (var stream = file.Create()) {
-				Write(stream, t);
+				WriteWithBlocks(stream, t);
 			}
 		} catch (Exception) {
 			file.Delete();
@@ -33,15 +66,44 @@ public static class Persistance {
 		return (T) typeModel.Deserialize(stream, null, typeof(T));
 	}
 
+	/**
+	 * Reads a message from memory, such as a mapped file. Arrays stored as raw blocks are copied straight out of it.
+	 */
+	public static T Read<T>(DataPointer data) {
+		if (data.Size == 0) {
+			return Read<T>(Stream.Null);
+		}
+
+		unsafe {
+			byte* ptr = (byte*) data.Pointer;
+			if (data.Size < BlockFileHeaderSize || *(uint*) ptr != BlockFileMagic) {
+				return Read<T>(new UnmanagedMemoryStream(ptr, data.Size));
+			}
+
+			long messageLength = *(long*) (ptr + sizeof(uint) + sizeof(int));
+			long blocksOffset = IntegerUtils.NextLargerMultiple(BlockFileHeaderSize + messageLength, RawArrayBlocks.Alignment);
+			if (blocksOffset > data.Size) {
+				throw new InvalidOperationException("raw array blocks are out of range");
+			}
+
+			var blocks = RawArrayBlocks.MakeForReading(data.Pointer + (int) blocksOffset, data.Size - blocksOffset);
+			var messageStream = new UnmanagedMemoryStream(ptr + BlockFileHeaderSize, messageLength);
+			return (T) typeModel.Deserialize(messageStream, null, typeof(T), new SerializationContext { Context = blocks });
+		}
+	}
+
 	public static T Load<T>(IArchiveFile file) {
-		using (var stream = file.OpenRead()) {
-			return Read<T>(stream);
+		using (var view = file.OpenDataView()) {
+			return Read<T>(view.DataPointer);
 		}
 	}
 
 	public static T Load<T>(FileInfo file) {
-		using (var stream = file.OpenRead()) {
-			return Read<T>(stream);
+		if (file.Length == 0) {
+			return Read<T>(Stream.Null);
+		}
+		using (var view = new UnpackedArchiveFileDataView(file)) {
+			return Read<T>(view.DataPointer);
 		}
 	}
 }
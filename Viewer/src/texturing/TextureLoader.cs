@@ -38,22 +38,24 @@ public class TextureLoader : IDisposable {
 		}
 	}
 	
-	public ShaderResourceView Load(string name, DefaultMode defaultMode) {
+	/**
+	 * Returns the named texture, or the default for the mode if name is null. Named textures load asynchronously and
+	 * show the default until they are ready.
+	 */
+	public SharedTexture Load(string name, DefaultMode defaultMode) {
+		var defaultTexture = defaultMode == DefaultMode.Bump ? defaultBumpTexture : defaultStandardTexture;
+
 		if (name == null) {
-			if (defaultMode == DefaultMode.Bump) {
-				return defaultBumpTexture;
-			} else {
-				return defaultStandardTexture;
-			}
+			return SharedTexture.MakeUnshared(defaultTexture);
 		}
 
-		if (!cache.TryGetValue(name, out var textureView)) {
+		if (!cache.TryGetValue(name, out var texture)) {
 			var path = (name + ".dds").Split('/');
 			var imageFile = texturesDirectory.File(path);
-			textureView = textureCache.Get(imageFile);
-			cache.Add(name, textureView);
+			texture = textureCache.Get(imageFile, defaultTexture);
+			cache.Add(name, texture);
 		}
 
-		return textureView;
+		return texture;
 	}
 }
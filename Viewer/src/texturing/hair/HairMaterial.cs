@@ -10,8 +10,8 @@ class HairMaterial : IMaterial {
 	}
 
 	public struct Textures {
-		public ShaderResourceView diffuseAlbedo;
-		public ShaderResourceView opacity;
+		public SharedTexture diffuseAlbedo;
+		public SharedTexture opacity;
 	}
 
 	public static HairMaterial Load(Device device, ShaderCache shaderCache, TextureLoader textureLoader, HairMaterialSettings settings) {
@@ -24,26 +24,28 @@ class HairMaterial : IMaterial {
 		constants.opacity = settings.opacity.value;
 		textures.opacity = textureLoader.Load(settings.opacity.image, TextureLoader.DefaultMode.Standard);
 		
-		ShaderResourceView[] texturesViews = new [] {
+		SharedTexture[] textureArray = new [] {
 			textures.diffuseAlbedo,
 			textures.opacity
 		};
 
 		var constantBuffer = Buffer.Create(device, BindFlags.ConstantBuffer, ref constants, usage: ResourceUsage.Immutable);
 
-		return new HairMaterial(device, shaderCache, settings, constantBuffer, texturesViews);
+		return new HairMaterial(device, shaderCache, settings, constantBuffer, textureArray);
 	}
 
 	private readonly PixelShader standardShader;
 	private readonly PixelShader unorderedTransparencyShader;
 	private readonly HairMaterialSettings settings;
 	private readonly Buffer constantBuffer;
+	private readonly SharedTexture[] textures;
 	private readonly ShaderResourceView[] textureViews;
 
-	public HairMaterial(Device device, ShaderCache shaderCache, HairMaterialSettings settings, Buffer constantBuffer, ShaderResourceView[] textureViews) {
+	public HairMaterial(Device device, ShaderCache shaderCache, HairMaterialSettings settings, Buffer constantBuffer, SharedTexture[] textures) {
 		this.settings = settings;
 		this.constantBuffer = constantBuffer;
-		this.textureViews = textureViews;
+		this.textures = textures;
+		this.textureViews = new ShaderResourceView[textures.Length];
 
 		standardShader = shaderCache.GetPixelShader<UberMaterial>("texturing/hair/HairShader-Standard");
 		unorderedTransparencyShader = shaderCache.GetPixelShader<UberMaterial>("texturing/hair/HairShader-UnorderedTransparency");
@@ -69,6 +71,9 @@ class HairMaterial : IMaterial {
 	
 	public void Apply(DeviceContext context, OutputMode outputMode, ShaderResourceView secondaryNormalMap) {
 		context.PixelShader.Set(PickShader(outputMode));
+		for (int i = 0; i < textures.Length; ++i) {
+			textureViews[i] = textures[i].View;
+		}
 		context.PixelShader.SetShaderResources(ShaderSlots.MaterialTextureStart, textureViews);
 		context.PixelShader.SetConstantBuffer(ShaderSlots.MaterialConstantBufferStart, constantBuffer);
 	}
@@ -62,47 +62,47 @@ public struct UberConstants {
 
 public struct UberTextures {
 	//Base / Diffuse / Reflection
-	public ShaderResourceView metallicWeight;
-	public ShaderResourceView diffuseWeight;
-	public ShaderResourceView baseColor;
+	public SharedTexture metallicWeight;
+	public SharedTexture diffuseWeight;
+	public SharedTexture baseColor;
 
 	//Base / Diffuse Translucency
-	public ShaderResourceView translucencyWeight;
-	public ShaderResourceView translucencyColor;
+	public SharedTexture translucencyWeight;
+	public SharedTexture translucencyColor;
 
 	//Base / Glossy / Reflection
-	public ShaderResourceView glossyWeight;
-	public ShaderResourceView glossyLayeredWeight;
-	public ShaderResourceView glossyColor;
-	public ShaderResourceView glossySpecular;
-	public ShaderResourceView glossiness;
-	public ShaderResourceView glossyReflectivity;
-	public ShaderResourceView glossyRoughness;
+	public SharedTexture glossyWeight;
+	public SharedTexture glossyLayeredWeight;
+	public SharedTexture glossyColor;
+	public SharedTexture glossySpecular;
+	public SharedTexture glossiness;
+	public SharedTexture glossyReflectivity;
+	public SharedTexture glossyRoughness;
 
 	//Base / Glossy / Refraction
-	public ShaderResourceView refractionWeight;
+	public SharedTexture refractionWeight;
 
 	//Base / Bump
-	public ShaderResourceView bumpStrength;
-	public ShaderResourceView normalMap;
+	public SharedTexture bumpStrength;
+	public SharedTexture normalMap;
 
 	// Top Coat
-	public ShaderResourceView topCoatWeight;
-	public ShaderResourceView topCoatColor;
-	public ShaderResourceView topCoatRoughness;
-	public ShaderResourceView topCoatReflectivity;
-	public ShaderResourceView topCoatIOR;
-	public ShaderResourceView topCoatCurveNormal;
-	public ShaderResourceView topCoatCurveGrazing;
+	public SharedTexture topCoatWeight;
+	public SharedTexture topCoatColor;
+	public SharedTexture topCoatRoughness;
+	public SharedTexture topCoatReflectivity;
+	public SharedTexture topCoatIOR;
+	public SharedTexture topCoatCurveNormal;
+	public SharedTexture topCoatCurveGrazing;
 
 	//Top Coat Bump
-	public ShaderResourceView topCoatBump;
+	public SharedTexture topCoatBump;
 
 	//Geometry/Cutout
-	public ShaderResourceView cutoutOpacity;
+	public SharedTexture cutoutOpacity;
 
-	public ShaderResourceView[] ToArray() {
-		return new ShaderResourceView[] {
+	public SharedTexture[] ToArray() {
+		return new SharedTexture[] {
 			metallicWeight, diffuseWeight, baseColor,
 			translucencyWeight, translucencyColor,
 			glossyWeight, glossyLayeredWeight, glossyColor, glossySpecular,
@@ -125,20 +125,21 @@ public class UberMaterial : IMaterial {
 	private readonly PixelShader unorderedTransparencyShader;
 	private readonly UberMaterialSettings settings;
 	private readonly Buffer constantBuffer;
+	private readonly SharedTexture[] textures;
 	private readonly ShaderResourceView[] textureViews;
 	private readonly ShaderResourceView defaultBumpTexture;
 	
-	private static void SetColorTexture(TextureLoader textureLoader, ColorTexture colorTexture, out Vector3 value, out ShaderResourceView textureView) {
+	private static void SetColorTexture(TextureLoader textureLoader, ColorTexture colorTexture, out Vector3 value, out SharedTexture textureView) {
 		value = colorTexture.value;
 		textureView = textureLoader.Load(colorTexture.image, TextureLoader.DefaultMode.Standard);
 	}
 
-	private static void SetFloatTexture(TextureLoader textureLoader, FloatTexture colorTexture, out float value, out ShaderResourceView textureView) {
+	private static void SetFloatTexture(TextureLoader textureLoader, FloatTexture colorTexture, out float value, out SharedTexture textureView) {
 		value = colorTexture.value;
 		textureView = textureLoader.Load(colorTexture.image, TextureLoader.DefaultMode.Standard);
 	}
 
-	private static void SetBumpTexture(TextureLoader textureLoader, FloatTexture colorTexture, out float value, out ShaderResourceView textureView) {
+	private static void SetBumpTexture(TextureLoader textureLoader, FloatTexture colorTexture, out float value, out SharedTexture textureView) {
 		value = colorTexture.value;
 		textureView = textureLoader.Load(colorTexture.image, TextureLoader.DefaultMode.Bump);
 	}
@@ -212,17 +213,18 @@ public class UberMaterial : IMaterial {
 		
 		var constantBuffer = Buffer.Create(device, BindFlags.ConstantBuffer, ref constants, usage: ResourceUsage.Immutable);
 		
-		var defaultBumpTexture = textureLoader.Load(null, TextureLoader.DefaultMode.Bump);
+		var defaultBumpTexture = textureLoader.Load(null, TextureLoader.DefaultMode.Bump).View;
 
 		return new UberMaterial(device, shaderCache, settings, constantBuffer, textures.ToArray(), defaultBumpTexture);
 	}
 	
-	public UberMaterial(Device device, ShaderCache shaderCache, UberMaterialSettings settings, Buffer constantBuffer, ShaderResourceView[] textureViews, ShaderResourceView defaultBumpTexture) {
+	public UberMaterial(Device device, ShaderCache shaderCache, UberMaterialSettings settings, Buffer constantBuffer, SharedTexture[] textures, ShaderResourceView defaultBumpTexture) {
 		this.standardShader = shaderCache.GetPixelShader<UberMaterial>(StandardShaderName);
 		this.unorderedTransparencyShader = shaderCache.GetPixelShader<UberMaterial>(UnorderedTransparencyShaderName);
 		this.settings = settings;
 		this.constantBuffer = constantBuffer;
-		this.textureViews = textureViews;
+		this.textures = textures;
+		this.textureViews = new ShaderResourceView[textures.Length];
 		this.defaultBumpTexture = defaultBumpTexture;
 	}
 
@@ -248,6 +250,10 @@ public class UberMaterial : IMaterial {
 	
 	public void Apply(DeviceContext context, OutputMode outputMode, ShaderResourceView secondaryNormalMap) {
 		context.PixelShader.Set(PickShader(outputMode));
+		for (int i = 0; i < textures.Length; ++i) {
+			//textures may still be loading, so pick up their current views
+			textureViews[i] = textures[i].View;
+		}
 		context.PixelShader.SetShaderResources(ShaderSlots.MaterialTextureStart, textureViews);
 		context.PixelShader.SetShaderResource(ShaderSlots.MaterialTextureStart + textureViews.Length, secondaryNormalMap ?? defaultBumpTexture);
 		context.PixelShader.SetConstantBuffer(ShaderSlots.MaterialConstantBufferStart, constantBuffer);
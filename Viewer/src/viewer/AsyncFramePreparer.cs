@@ -1,36 +1,183 @@
+using System;
+using System.Diagnostics;
+using System.Runtime.ExceptionServices;
 using System.Threading;
 
-class AsyncFramePreparer {
-	private readonly FramePreparer framePreparer;
+public struct AsyncFrameTiming {
+	//from StartPreparingFrame until the preparer thread picked the frame up
+	public TimeSpan QueueLatency { get; }
 
-	public AsyncFramePreparer(FramePreparer framePreparer) {
-		this.framePreparer = framePreparer;
+	//time spent in PrepareFrame
+	public TimeSpan PrepareTime { get; }
 
-		var thread = new Thread(ThreadProc);
+	//from the frame being prepared until FinishPreparingFrame handed it over
+	public TimeSpan HandoffLatency { get; }
+
+	//how long FinishPreparingFrame blocked waiting for the frame
+	public TimeSpan FinishWaitTime { get; }
+
+	public AsyncFrameTiming(TimeSpan queueLatency, TimeSpan prepareTime, TimeSpan handoffLatency, TimeSpan finishWaitTime) {
+		QueueLatency = queueLatency;
+		PrepareTime = prepareTime;
+		HandoffLatency = handoffLatency;
+		FinishWaitTime = finishWaitTime;
+	}
+
+	public override string ToString() {
+		return String.Format("queue {0:F2}ms, prepare {1:F2}ms, handoff {2:F2}ms, finish wait {3:F2}ms",
+			QueueLatency.TotalMilliseconds, PrepareTime.TotalMilliseconds, HandoffLatency.TotalMilliseconds, FinishWaitTime.TotalMilliseconds);
+	}
+}
+
+/**
+ * Prepares frames on a background thread while the render thread renders earlier ones.
+ *
+ * Frames pass through a ring of slots: StartPreparingFrame queues a frame's parameters in the next free slot and
+ * FinishPreparingFrame returns frames in the order they were started. Up to depth frames can be started but not yet
+ * finished; beyond that StartPreparingFrame blocks until a slot frees up. Both sides block on semaphores rather than
+ * spinning, so an idle side doesn't take a core from the simulation.
+ *
+ * StartPreparingFrame and FinishPreparingFrame must be called from a single thread.
+ */
+public class AsyncFramePreparer : IDisposable {
+	private class Slot {
+		public readonly SemaphoreSlim PreparedSemaphore = new SemaphoreSlim(0, 1);
+		public FrameUpdateParameters UpdateParameters;
+		public IPreparedFrame PreparedFrame;
+		public ExceptionDispatchInfo Failure;
+		public long StartTimestamp;
+		public long PrepareBeginTimestamp;
+		public long PrepareEndTimestamp;
+	}
+
+	private readonly Func<FrameUpdateParameters, IPreparedFrame> prepareFrame;
+	private readonly Slot[] slots;
+	private readonly SemaphoreSlim freeSlotsSemaphore;
+	private readonly SemaphoreSlim queuedSlotsSemaphore = new SemaphoreSlim(0);
+	private readonly Thread thread;
+	private volatile bool disposed;
+
+	//each index is only touched by one thread: start and finish by the caller, prepare by the preparer thread
+	private int startIndex;
+	private int prepareIndex;
+	private int finishIndex;
+	private int inFlightCount;
+
+	public AsyncFrameTiming LastFrameTiming { get; private set; }
+
+	public AsyncFramePreparer(FramePreparer framePreparer, int depth = 1) : this(framePreparer.PrepareFrame, depth) {
+	}
+
+	public AsyncFramePreparer(Func<FrameUpdateParameters, IPreparedFrame> prepareFrame, int depth = 1) {
+		if (depth < 1) {
+			throw new ArgumentOutOfRangeException(nameof(depth), "depth must be at least 1");
+		}
+
+		this.prepareFrame = prepareFrame;
+
+		slots = new Slot[depth];
+		for (int i = 0; i < depth; ++i) {
+			slots[i] = new Slot();
+		}
+		freeSlotsSemaphore = new SemaphoreSlim(depth, depth);
+
+		thread = new Thread(ThreadProc);
 		thread.SetApartmentState(ApartmentState.STA);
 		thread.IsBackground = true;
 		thread.Start();
 	}
 
-	private readonly SemaphoreSlim updateParametersReadySemaphore = new SemaphoreSlim(0, 1);
-	private FrameUpdateParameters updateParameters;
-	private volatile IPreparedFrame preparedFrame;
+	public int Depth => slots.Length;
+
+	/**
+	 * Waits for frames that were started but never finished, disposes them, and stops the preparer thread.
+	 */
+	public void Dispose() {
+		while (inFlightCount > 0) {
+			var slot = slots[finishIndex];
+			finishIndex = (finishIndex + 1) % slots.Length;
+			inFlightCount -= 1;
+
+			slot.PreparedSemaphore.Wait();
+			slot.PreparedFrame?.Dispose();
+			slot.PreparedFrame = null;
+			slot.Failure = null;
+		}
+
+		disposed = true;
+		queuedSlotsSemaphore.Release();
+		thread.Join();
+	}
 
 	public void StartPreparingFrame(FrameUpdateParameters updateParameters) {
-		this.updateParameters = updateParameters;
-		this.preparedFrame = null;
-		updateParametersReadySemaphore.Release();
+		freeSlotsSemaphore.Wait();
+
+		var slot = slots[startIndex];
+		startIndex = (startIndex + 1) % slots.Length;
+		inFlightCount += 1;
+
+		slot.UpdateParameters = updateParameters;
+		slot.StartTimestamp = Stopwatch.GetTimestamp();
+		queuedSlotsSemaphore.Release();
 	}
 
 	private void ThreadProc() {
 		while (true) {
-			updateParametersReadySemaphore.Wait();
-			preparedFrame = framePreparer.PrepareFrame(updateParameters);
+			queuedSlotsSemaphore.Wait();
+			if (disposed) {
+				return;
+			}
+
+			var slot = slots[prepareIndex];
+			prepareIndex = (prepareIndex + 1) % slots.Length;
+
+			slot.PrepareBeginTimestamp = Stopwatch.GetTimestamp();
+			try {
+				slot.PreparedFrame = prepareFrame(slot.UpdateParameters);
+			} catch (Exception e) {
+				slot.Failure = ExceptionDispatchInfo.Capture(e);
+			}
+			slot.PrepareEndTimestamp = Stopwatch.GetTimestamp();
+			slot.UpdateParameters = null;
+
+			slot.PreparedSemaphore.Release();
 		}
 	}
-	
+
+	/**
+	 * Returns the oldest started frame, blocking until it has been prepared. If preparing it threw, the exception is
+	 * rethrown here.
+	 */
 	public IPreparedFrame FinishPreparingFrame() {
-		SpinWait.SpinUntil(() => preparedFrame != null);
+		if (inFlightCount == 0) {
+			throw new InvalidOperationException("no frame is being prepared");
+		}
+
+		var slot = slots[finishIndex];
+		finishIndex = (finishIndex + 1) % slots.Length;
+		inFlightCount -= 1;
+
+		long waitBeginTimestamp = Stopwatch.GetTimestamp();
+		slot.PreparedSemaphore.Wait();
+		long finishTimestamp = Stopwatch.GetTimestamp();
+
+		LastFrameTiming = new AsyncFrameTiming(
+			ToTimeSpan(slot.PrepareBeginTimestamp - slot.StartTimestamp),
+			ToTimeSpan(slot.PrepareEndTimestamp - slot.PrepareBeginTimestamp),
+			ToTimeSpan(finishTimestamp - slot.PrepareEndTimestamp),
+			ToTimeSpan(finishTimestamp - waitBeginTimestamp));
+
+		var preparedFrame = slot.PreparedFrame;
+		var failure = slot.Failure;
+		slot.PreparedFrame = null;
+		slot.Failure = null;
+		freeSlotsSemaphore.Release();
+
+		failure?.Throw();
 		return preparedFrame;
 	}
+
+	private static TimeSpan ToTimeSpan(long stopwatchTicks) {
+		return TimeSpan.FromSeconds((double) stopwatchTicks / Stopwatch.Frequency);
+	}
 }
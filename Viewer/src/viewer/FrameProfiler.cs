@@ -0,0 +1,227 @@
+using Newtonsoft.Json;
+using System;
+using System.Collections.Generic;
+using System.Diagnostics;
+using System.Globalization;
+using System.IO;
+using System.Linq;
+using System.Text;
+using System.Threading;
+
+/**
+ * A named span of CPU work whose time is summed over each frame.
+ */
+public class ProfilerStage {
+	public string Name { get; }
+
+	private long pendingTicks;
+	internal readonly long[] samples = new long[FrameProfiler.Capacity];
+
+	internal ProfilerStage(string name) {
+		Name = name;
+	}
+
+	/**
+	 * Times the work until the returned scope is disposed. Does nothing while profiling is disabled.
+	 */
+	public ProfilerScope Measure() {
+		return FrameProfiler.IsEnabled ? new ProfilerScope(this, Stopwatch.GetTimestamp()) : default(ProfilerScope);
+	}
+
+	/**
+	 * Adds a duration measured elsewhere, in Stopwatch ticks, to the current frame.
+	 */
+	public void Add(long stopwatchTicks) {
+		if (FrameProfiler.IsEnabled) {
+			Interlocked.Add(ref pendingTicks, stopwatchTicks);
+		}
+	}
+
+	public void Add(TimeSpan duration) {
+		Add((long) (duration.TotalSeconds * Stopwatch.Frequency));
+	}
+
+	internal void EndFrame(int sampleIdx) {
+		samples[sampleIdx] = Interlocked.Exchange(ref pendingTicks, 0);
+	}
+}
+
+public struct ProfilerScope : IDisposable {
+	private readonly ProfilerStage stage;
+	private readonly long startTimestamp;
+
+	internal ProfilerScope(ProfilerStage stage, long startTimestamp) {
+		this.stage = stage;
+		this.startTimestamp = startTimestamp;
+	}
+
+	public void Dispose() {
+		stage?.Add(Stopwatch.GetTimestamp() - startTimestamp);
+	}
+}
+
+public class ProfilerStageSummary {
+	[JsonProperty("stage")]
+	public string Name;
+
+	[JsonProperty("frames")]
+	public int FrameCount;
+
+	[JsonProperty("mean-ms")]
+	public double Mean;
+
+	[JsonProperty("p50-ms")]
+	public double P50;
+
+	[JsonProperty("p95-ms")]
+	public double P95;
+
+	[JsonProperty("p99-ms")]
+	public double P99;
+
+	[JsonProperty("max-ms")]
+	public double Max;
+
+	public override string ToString() {
+		return String.Format(CultureInfo.InvariantCulture, "{0}: mean {1:F2}ms, p50 {2:F2}ms, p95 {3:F2}ms, p99 {4:F2}ms, max {5:F2}ms",
+			Name, Mean, P50, P95, P99, Max);
+	}
+}
+
+/**
+ * Collects per-frame CPU time for named stages, such as channel evaluation or command list recording, into ring buffers
+ * holding the most recent frames, and summarizes them as percentiles.
+ *
+ * Stages can be timed from any thread without locking: scopes add to a per-stage counter that EndFrame moves into the
+ * ring buffer. While disabled, Measure doesn't read the clock and scopes do nothing.
+ */
+public static class FrameProfiler {
+	public const int Capacity = 4096;
+
+	public static bool IsEnabled { get; set; }
+
+	private static readonly object registrationLock = new object();
+
+	//copy-on-write so that EndFrame can iterate without locking
+	private static ProfilerStage[] stages = new ProfilerStage[0];
+	private static int frameCount;
+
+	public static ProfilerStage RegisterStage(string name) {
+		lock (registrationLock) {
+			var stage = stages.FirstOrDefault(existing => existing.Name == name);
+			if (stage == null) {
+				stage = new ProfilerStage(name);
+				stages = stages.Concat(new [] { stage }).ToArray();
+			}
+			return stage;
+		}
+	}
+
+	/**
+	 * Records the time accumulated by each stage since the last call as one frame. Called once per frame by the render
+	 * loop.
+	 */
+	public static void EndFrame() {
+		if (!IsEnabled) {
+			return;
+		}
+
+		int sampleIdx = frameCount % Capacity;
+		foreach (var stage in stages) {
+			stage.EndFrame(sampleIdx);
+		}
+		frameCount += 1;
+	}
+
+	public static int RecordedFrameCount => Math.Min(frameCount, Capacity);
+
+	/**
+	 * Discards all recorded frames and any time accumulated for the current one.
+	 */
+	public static void Reset() {
+		foreach (var stage in stages) {
+			stage.EndFrame(0);
+		}
+		frameCount = 0;
+	}
+
+	private static double ToMilliseconds(long stopwatchTicks) {
+		return stopwatchTicks * 1000.0 / Stopwatch.Frequency;
+	}
+
+	//samples in frame order, oldest first
+	private static long[] GetSamples(ProfilerStage stage) {
+		int count = RecordedFrameCount;
+		int firstIdx = frameCount - count;
+		var samples = new long[count];
+		for (int i = 0; i < count; ++i) {
+			samples[i] = stage.samples[(firstIdx + i) % Capacity];
+		}
+		return samples;
+	}
+
+	private static double Percentile(long[] sorted, double percentile) {
+		//nearest rank
+		int rank = (int) Math.Ceiling(percentile / 100 * sorted.Length);
+		return ToMilliseconds(sorted[Math.Max(rank, 1) - 1]);
+	}
+
+	public static List<ProfilerStageSummary> Summarize() {
+		if (RecordedFrameCount == 0) {
+			return new List<ProfilerStageSummary>();
+		}
+
+		return stages
+			.Select(stage => {
+				var sorted = GetSamples(stage);
+				Array.Sort(sorted);
+				return new ProfilerStageSummary {
+					Name = stage.Name,
+					FrameCount = sorted.Length,
+					Mean = ToMilliseconds(sorted.Sum()) / sorted.Length,
+					P50 = Percentile(sorted, 50),
+					P95 = Percentile(sorted, 95),
+					P99 = Percentile(sorted, 99),
+					Max = ToMilliseconds(sorted[sorted.Length - 1])
+				};
+			})
+			.ToList();
+	}
+
+	/**
+	 * Writes one row per recorded frame with each stage's time in milliseconds.
+	 */
+	public static void ExportCsv(FileInfo file) {
+		var allSamples = stages.Select(GetSamples).ToList();
+
+		var builder = new StringBuilder();
+		builder.Append("frame");
+		foreach (var stage in stages) {
+			builder.Append(',').Append(stage.Name);
+		}
+		builder.AppendLine();
+
+		int firstFrameIdx = frameCount - RecordedFrameCount;
+		for (int i = 0; i < RecordedFrameCount; ++i) {
+			builder.Append(firstFrameIdx + i);
+			foreach (var samples in allSamples) {
+				builder.Append(',').Append(ToMilliseconds(samples[i]).ToString("F4", CultureInfo.InvariantCulture));
+			}
+			builder.AppendLine();
+		}
+
+		file.WriteAllText(builder.ToString());
+	}
+
+	/**
+	 * Writes the percentile summary of each stage, along with the live and high-water memory of each subsystem and
+	 * owner.
+	 */
+	public static void ExportJson(FileInfo file) {
+		var profile = new {
+			stages = Summarize(),
+			memory = MemoryAccounting.Summarize()
+		};
+		file.WriteAllText(JsonConvert.SerializeObject(profile, Formatting.Indented));
+	}
+}
@@ -0,0 +1,285 @@
+using Newtonsoft.Json;
+using SharpDX;
+using System;
+using System.Collections.Concurrent;
+using System.Collections.Generic;
+using System.Globalization;
+using System.Linq;
+using System.Runtime.Remoting.Messaging;
+using System.Threading;
+
+/**
+ * Live and high-water byte counts for one subsystem or owner.
+ */
+public class MemoryCounter {
+	public string Name { get; }
+
+	private long liveBytes;
+	private long highWaterBytes;
+	private int allocationCount;
+
+	internal MemoryCounter(string name) {
+		Name = name;
+	}
+
+	public long LiveBytes => Interlocked.Read(ref liveBytes);
+	public long HighWaterBytes => Interlocked.Read(ref highWaterBytes);
+
+	//number of allocations not yet released
+	public int AllocationCount => allocationCount;
+
+	/**
+	 * Returns the live byte count after the addition.
+	 */
+	internal long Add(long bytes) {
+		Interlocked.Increment(ref allocationCount);
+		long live = Interlocked.Add(ref liveBytes, bytes);
+
+		long highWater = Interlocked.Read(ref highWaterBytes);
+		while (live > highWater) {
+			long previous = Interlocked.CompareExchange(ref highWaterBytes, live, highWater);
+			if (previous == highWater) {
+				break;
+			}
+			highWater = previous;
+		}
+
+		return live;
+	}
+
+	internal void Remove(long bytes) {
+		Interlocked.Decrement(ref allocationCount);
+		Interlocked.Add(ref liveBytes, -bytes);
+	}
+
+	internal void ResetHighWater() {
+		Interlocked.Exchange(ref highWaterBytes, LiveBytes);
+	}
+
+	public MemoryCounterSummary Summarize() {
+		return new MemoryCounterSummary {
+			Name = Name,
+			LiveBytes = LiveBytes,
+			HighWaterBytes = HighWaterBytes,
+			AllocationCount = AllocationCount
+		};
+	}
+}
+
+public class MemoryCounterSummary {
+	[JsonProperty("name")]
+	public string Name;
+
+	[JsonProperty("live-bytes")]
+	public long LiveBytes;
+
+	[JsonProperty("high-water-bytes")]
+	public long HighWaterBytes;
+
+	[JsonProperty("allocations")]
+	public int AllocationCount;
+
+	public override string ToString() {
+		return String.Format(CultureInfo.InvariantCulture, "{0}: live {1:F1}MB, high-water {2:F1}MB, {3} allocations",
+			Name, LiveBytes / (1024.0 * 1024.0), HighWaterBytes / (1024.0 * 1024.0), AllocationCount);
+	}
+}
+
+public class MemoryAccountingSummary {
+	[JsonProperty("total")]
+	public MemoryCounterSummary Total;
+
+	[JsonProperty("budget-bytes")]
+	public long BudgetBytes;
+
+	[JsonProperty("over-budget-owner")]
+	public string OverBudgetOwner;
+
+	[JsonProperty("categories")]
+	public List<MemoryCounterSummary> Categories;
+
+	[JsonProperty("owners")]
+	public List<MemoryCounterSummary> Owners;
+}
+
+/**
+ * A tracked block of memory, counted against its category and owner until disposed.
+ *
+ * An allocation tied to a managed object that is never disposed, such as a channel system, is released when it is
+ * finalized, so the object should hold the only reference to it.
+ */
+public sealed class MemoryAllocation : IDisposable {
+	private readonly MemoryCounter category;
+	private readonly MemoryCounter owner;
+	private int released;
+
+	public long Bytes { get; }
+
+	internal MemoryAllocation(MemoryCounter category, MemoryCounter owner, long bytes) {
+		this.category = category;
+		this.owner = owner;
+		Bytes = bytes;
+	}
+
+	~MemoryAllocation() {
+		Release();
+	}
+
+	public void Dispose() {
+		Release();
+		GC.SuppressFinalize(this);
+	}
+
+	private void Release() {
+		if (Interlocked.Exchange(ref released, 1) != 0) {
+			return;
+		}
+
+		category.Remove(Bytes);
+		owner?.Remove(Bytes);
+		MemoryAccounting.Total.Remove(Bytes);
+	}
+}
+
+public struct MemoryOwnerScope : IDisposable {
+	private readonly string previousOwner;
+
+	internal MemoryOwnerScope(string previousOwner) {
+		this.previousOwner = previousOwner;
+	}
+
+	public void Dispose() {
+		CallContext.LogicalSetData(MemoryAccounting.OwnerSlotName, previousOwner);
+	}
+}
+
+/**
+ * Counts the bytes held by each subsystem (GPU buffers, textures, archive views, stencils, channel systems) and by
+ * each owner, such as a figure or clothing item, with live totals and high-water marks that can be queried at
+ * runtime.
+ *
+ * Allocations are attributed to the owner set by the innermost AttributeTo scope on the allocating thread. The owner
+ * flows into tasks and thread pool work started within the scope, but work queued elsewhere, like texture loads, has
+ * to pass its owner explicitly.
+ */
+public static class MemoryAccounting {
+	internal const string OwnerSlotName = "MemoryAccounting.Owner";
+
+	private static readonly object registrationLock = new object();
+	private static MemoryCounter[] categories = new MemoryCounter[0];
+	private static readonly ConcurrentDictionary<string, MemoryCounter> owners = new ConcurrentDictionary<string, MemoryCounter>();
+
+	public static readonly MemoryCounter Total = new MemoryCounter("total");
+
+	public static readonly MemoryCounter GpuBuffers = RegisterCategory("gpu-buffers");
+	public static readonly MemoryCounter Textures = RegisterCategory("textures");
+	public static readonly MemoryCounter ArchiveViews = RegisterCategory("archive-views");
+	public static readonly MemoryCounter Stencils = RegisterCategory("stencils");
+	public static readonly MemoryCounter ChannelSystems = RegisterCategory("channel-systems");
+
+	/**
+	 * The total that a session is expected to stay within, or 0 for no budget. The owner whose allocation first takes
+	 * the total over the budget is recorded as OverBudgetOwner.
+	 */
+	public static long BudgetBytes { get; set; }
+
+	private static string overBudgetOwner;
+	public static string OverBudgetOwner => overBudgetOwner;
+
+	public static MemoryCounter RegisterCategory(string name) {
+		lock (registrationLock) {
+			var category = categories.FirstOrDefault(existing => existing.Name == name);
+			if (category == null) {
+				category = new MemoryCounter(name);
+				categories = categories.Concat(new [] { category }).ToArray();
+			}
+			return category;
+		}
+	}
+
+	public static IReadOnlyList<MemoryCounter> Categories => categories;
+
+	public static IEnumerable<MemoryCounter> Owners => owners.Values.OrderBy(owner => owner.Name);
+
+	public static string CurrentOwner => CallContext.LogicalGetData(OwnerSlotName) as string;
+
+	/**
+	 * Attributes allocations made until the returned scope is disposed to the named owner.
+	 */
+	public static MemoryOwnerScope AttributeTo(string owner) {
+		var scope = new MemoryOwnerScope(CurrentOwner);
+		CallContext.LogicalSetData(OwnerSlotName, owner);
+		return scope;
+	}
+
+	public static MemoryAllocation Track(MemoryCounter category, long bytes) {
+		return Track(category, bytes, CurrentOwner);
+	}
+
+	public static MemoryAllocation Track(MemoryCounter category, long bytes, string owner) {
+		if (category == null) {
+			throw new ArgumentNullException(nameof(category));
+		}
+		if (bytes < 0) {
+			throw new ArgumentException("bytes must not be negative", nameof(bytes));
+		}
+
+		var ownerCounter = owner != null ? owners.GetOrAdd(owner, name => new MemoryCounter(name)) : null;
+
+		category.Add(bytes);
+		ownerCounter?.Add(bytes);
+		long total = Total.Add(bytes);
+
+		long budget = BudgetBytes;
+		if (budget > 0 && total > budget && total - bytes <= budget) {
+			string culprit = owner ?? category.Name;
+			if (Interlocked.CompareExchange(ref overBudgetOwner, culprit, null) == null) {
+				Console.WriteLine(String.Format(CultureInfo.InvariantCulture, "memory budget of {0:F1}MB exceeded while allocating {1:F1}MB of {2} for {3}",
+					budget / (1024.0 * 1024.0), bytes / (1024.0 * 1024.0), category.Name, culprit));
+			}
+		}
+
+		return new MemoryAllocation(category, ownerCounter, bytes);
+	}
+
+	/**
+	 * Counts a GPU resource or view until it is disposed.
+	 */
+	public static void TrackUntilDisposed(MemoryCounter category, DisposeBase resource, long bytes) {
+		TrackUntilDisposed(category, resource, bytes, CurrentOwner);
+	}
+
+	public static void TrackUntilDisposed(MemoryCounter category, DisposeBase resource, long bytes, string owner) {
+		if (resource == null) {
+			return;
+		}
+
+		var allocation = Track(category, bytes, owner);
+		resource.Disposed += (sender, args) => allocation.Dispose();
+	}
+
+	/**
+	 * Lowers every high-water mark to the current live count and forgets the over-budget owner, so that peaks can be
+	 * measured from a known point such as the end of loading.
+	 */
+	public static void ResetHighWaterMarks() {
+		Total.ResetHighWater();
+		foreach (var category in categories) {
+			category.ResetHighWater();
+		}
+		foreach (var owner in owners.Values) {
+			owner.ResetHighWater();
+		}
+		overBudgetOwner = null;
+	}
+
+	public static MemoryAccountingSummary Summarize() {
+		return new MemoryAccountingSummary {
+			Total = Total.Summarize(),
+			BudgetBytes = BudgetBytes,
+			OverBudgetOwner = OverBudgetOwner,
+			Categories = categories.Select(category => category.Summarize()).ToList(),
+			Owners = Owners.Select(owner => owner.Summarize()).ToList()
+		};
+	}
+}
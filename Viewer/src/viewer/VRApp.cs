@@ -28,8 +28,15 @@ public class VRApp : IDisposable {
 
 		var commandLineParser = new CommandLineApplication(false);
 		var archiveOption = commandLineParser.Option("--content", "content directory", CommandOptionType.SingleValue);
+		var profileOption = commandLineParser.Option("--profile", "write per-stage CPU frame timings to <path>.csv and <path>.json on exit", CommandOptionType.SingleValue);
+		var memoryBudgetOption = commandLineParser.Option("--memory-budget", "report the figure that first takes tracked memory over this many MB", CommandOptionType.SingleValue);
 		commandLineParser.Execute(args);
 
+		FrameProfiler.IsEnabled = profileOption.HasValue();
+		if (memoryBudgetOption.HasValue()) {
+			MemoryAccounting.BudgetBytes = long.Parse(memoryBudgetOption.Value()) * 1024 * 1024;
+		}
+
 		string contentPath;
 		if (archiveOption.HasValue()) {
 			contentPath = archiveOption.Value();
@@ -59,6 +66,21 @@ public class VRApp : IDisposable {
 			using (VRApp app = new VRApp(unionedArchiveDir, title)) {
 				app.Run();
 			}
+
+			if (FrameProfiler.IsEnabled) {
+				string profilePath = profileOption.Value();
+				FrameProfiler.ExportCsv(new FileInfo(profilePath + ".csv"));
+				FrameProfiler.ExportJson(new FileInfo(profilePath + ".json"));
+				foreach (var summary in FrameProfiler.Summarize()) {
+					Console.WriteLine(summary);
+				}
+				foreach (var category in MemoryAccounting.Categories) {
+					Console.WriteLine(category.Summarize());
+				}
+				foreach (var owner in MemoryAccounting.Owners) {
+					Console.WriteLine(owner.Summarize());
+				}
+			}
 		} catch (VRInitException e) {
 			string text =String.Join("\n\n",
 				String.Format("OpenVR initialization failed: {0}", e.Message),
@@ -89,6 +111,9 @@ public class VRApp : IDisposable {
 
 	private IPreparedFrame preparedFrame;
 
+	private static readonly ProfilerStage FrameQueueStage = FrameProfiler.RegisterStage("frame-queue-latency");
+	private static readonly ProfilerStage FrameWaitStage = FrameProfiler.RegisterStage("frame-wait");
+
 	private static Device CreateDevice() {
 		SharpDX.DXGI.Adapter chosenAdapter = null;
 
@@ -143,6 +168,7 @@ public class VRApp : IDisposable {
 	public void Dispose() {
 		preparedFrame?.Dispose();
 
+		asyncFramePreparer.Dispose();
 		framePreparer.Dispose();
 
 		standardSamplers.Dispose();
@@ -264,6 +290,10 @@ public class VRApp : IDisposable {
 
 		preparedFrame.Dispose();
 		preparedFrame = asyncFramePreparer.FinishPreparingFrame();
+
+		FrameQueueStage.Add(asyncFramePreparer.LastFrameTiming.QueueLatency);
+		FrameWaitStage.Add(asyncFramePreparer.LastFrameTiming.FinishWaitTime);
+		FrameProfiler.EndFrame();
 	}
 	
 	private Matrix GetViewMatrix(EVREye eye) {